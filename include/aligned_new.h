@@ -0,0 +1,31 @@
+#ifndef ALIGNED_NEW_H
+#define ALIGNED_NEW_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Base for heap-allocated types with over-aligned members. Before C++17 a
+// new-expression only guarantees alignof(std::max_align_t), so T allocates
+// through posix_memalign at alignof(T) instead. Use as
+// class Ring : public AlignedNew<Ring>.
+template<typename T>
+struct AlignedNew {
+    static void* operator new(size_t size) {
+        void* p = allocate(size);
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+    static void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+    static void operator delete(void* p) noexcept { std::free(p); }
+    static void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+private:
+    static void* allocate(size_t size) noexcept {
+        constexpr size_t ALIGNMENT = alignof(T) < sizeof(void*) ? sizeof(void*) : alignof(T);
+        void* p = nullptr;
+        return ::posix_memalign(&p, ALIGNMENT, size) == 0 ? p : nullptr;
+    }
+};
+
+#endif // ALIGNED_NEW_H
@@ -0,0 +1,211 @@
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "aligned_new.h"
+#include "spsc_ring.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Binary asynchronous logger. The calling thread copies a format ID and raw
+// arguments into its own SPSC ring; a background thread formats and writes.
+// Levels below VWAP_LOG_LEVEL compile to nothing.
+
+#define VWAP_LOG_LEVEL_DEBUG 0
+#define VWAP_LOG_LEVEL_INFO  1
+#define VWAP_LOG_LEVEL_WARN  2
+#define VWAP_LOG_LEVEL_ERROR 3
+#define VWAP_LOG_LEVEL_NONE  4
+
+#ifndef VWAP_LOG_LEVEL
+#define VWAP_LOG_LEVEL VWAP_LOG_LEVEL_INFO
+#endif
+
+enum class LogLevel : uint8_t { DEBUG = 0, INFO = 1, WARN = 2, ERROR = 3 };
+
+// Format specs use typed placeholders:
+//   {u} unsigned  {i} signed  {f} double  {$} double cents as dollars
+//   {c} char      {S} side char as BUY/SELL  {s} 8-byte symbol
+//   {z} pointer to a string with static storage duration
+enum class LogFmt : uint16_t {
+    DECISION_ORDER,
+    CLIENT_ORDER_SENT,
+    MANAGER_ORDER_SENT,
+    MANAGER_VWAP_UPDATE,
+    MAIN_ORDER_SENT,
+    MAIN_VWAP_UPDATE,
+    COUNT
+};
+
+struct LogRecord {
+    static constexpr size_t MAX_ARGS = 6;
+    uint64_t ticks;
+    uint16_t fmt;
+    uint8_t level;
+    uint8_t argc;
+    uint32_t _reserved;
+    uint64_t args[MAX_ARGS];
+};
+
+static_assert(sizeof(LogRecord) == 64, "LogRecord must be one cache line");
+
+struct LogSymbol {
+    const char* chars;
+    explicit LogSymbol(const char* s) noexcept : chars(s) {}
+};
+
+namespace LogArg {
+    inline uint64_t encode(uint64_t v) noexcept { return v; }
+    inline uint64_t encode(uint32_t v) noexcept { return v; }
+    inline uint64_t encode(int64_t v) noexcept { return static_cast<uint64_t>(v); }
+    inline uint64_t encode(int32_t v) noexcept { return static_cast<uint64_t>(static_cast<int64_t>(v)); }
+    inline uint64_t encode(char v) noexcept { return static_cast<uint8_t>(v); }
+    inline uint64_t encode(double v) noexcept { uint64_t u; std::memcpy(&u, &v, sizeof(u)); return u; }
+    inline uint64_t encode(const char* v) noexcept { return reinterpret_cast<uintptr_t>(v); }
+    inline uint64_t encode(LogSymbol v) noexcept { uint64_t u = 0; std::memcpy(&u, v.chars, sizeof(u)); return u; }
+}
+
+class AsyncLogger final {
+private:
+    static constexpr size_t RING_CAPACITY = 4096;
+
+    struct ThreadRing : AlignedNew<ThreadRing> {
+        SpscRing<LogRecord, RING_CAPACITY> ring;
+        std::atomic<uint64_t> dropped{0};
+        std::thread::id owner;
+    };
+
+    // The calling thread's ring in the logger it last logged to. Loggers are
+    // told apart by instance number rather than address, so one constructed
+    // where a destroyed logger stood never sees that logger's freed rings.
+    static thread_local ThreadRing* tlsRing;
+    static thread_local uint64_t tlsOwner;
+    static std::atomic<uint64_t> nextInstance;
+
+    const uint64_t instance{nextInstance.fetch_add(1, std::memory_order_relaxed) + 1};
+
+    std::atomic<bool> active{false};
+    std::atomic<bool> stopRequested{false};
+    std::mutex registryMutex;
+    std::vector<ThreadRing*> rings;
+    // Rings only ever join the registry, so the drain side keeps its own copy
+    // and refreshes it when ringCount moves past it.
+    std::atomic<size_t> ringCount{0};
+    std::vector<ThreadRing*> drainRings;
+    std::thread writer;
+    FILE* out{nullptr};
+    bool ownsFile{false};
+    bool timestamps{false};
+    std::atomic<uint64_t> written{0};
+    uint64_t startTicks{0};
+    uint64_t startNanos{0};
+
+    ThreadRing* registerThread() noexcept;
+    void run() noexcept;
+    size_t drainOnce() noexcept;
+    void writeRecord(FILE* f, const LogRecord& rec, bool withTimestamp) noexcept;
+
+public:
+    AsyncLogger() = default;
+    ~AsyncLogger();
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    bool start(FILE* sink, bool withTimestamps = false);
+    bool startFile(const char* path);
+    void stop() noexcept;
+    bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+    // The writer thread, for placement; valid while active.
+    std::thread::native_handle_type writerThread() noexcept { return writer.native_handle(); }
+
+    uint64_t droppedRecords() noexcept;
+    uint64_t writtenRecords() const noexcept { return written.load(std::memory_order_relaxed); }
+
+    static const char* formatSpec(LogFmt fmt) noexcept;
+    static size_t format(const LogRecord& rec, char* buf, size_t cap) noexcept;
+
+    static inline uint64_t nowNanos() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Raw timestamp for the hot path; converted to nanoseconds by the writer.
+    static inline uint64_t nowTicks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return nowNanos();
+#endif
+    }
+    uint64_t ticksToNanos(uint64_t ticks) const noexcept;
+
+    template<typename... Args>
+    inline void log(LogLevel level, LogFmt fmt, Args... args) noexcept {
+        static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "Too many log arguments");
+        const uint64_t packed[sizeof...(Args) + 1] = { LogArg::encode(args)..., 0 };
+        if (!active.load(std::memory_order_acquire)) {
+            LogRecord rec;
+            fill(rec, level, fmt, packed, sizeof...(Args), 0);
+            writeRecord(stdout, rec, false);
+            return;
+        }
+        ThreadRing* r = tlsOwner == instance ? tlsRing : registerThread();
+        if (!r) return;
+        // Filled in place; the clock is read only when the writer prints it.
+        LogRecord* rec = r->ring.claim();
+        if (!rec) {
+            r->dropped.store(r->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+        fill(*rec, level, fmt, packed, sizeof...(Args), timestamps ? nowTicks() : 0);
+        r->ring.commit();
+    }
+
+private:
+    static inline void fill(LogRecord& rec, LogLevel level, LogFmt fmt, const uint64_t* args, size_t argc,
+                            uint64_t ticks) noexcept {
+        rec.ticks = ticks;
+        rec.fmt = static_cast<uint16_t>(fmt);
+        rec.level = static_cast<uint8_t>(level);
+        rec.argc = static_cast<uint8_t>(argc);
+        rec._reserved = 0;
+        std::memcpy(rec.args, args, argc * sizeof(uint64_t));
+    }
+};
+
+extern AsyncLogger g_asyncLogger;
+
+#if VWAP_LOG_LEVEL <= VWAP_LOG_LEVEL_DEBUG
+#define VWAP_LOG_DEBUG(...) g_asyncLogger.log(LogLevel::DEBUG, __VA_ARGS__)
+#else
+#define VWAP_LOG_DEBUG(...) ((void)0)
+#endif
+
+#if VWAP_LOG_LEVEL <= VWAP_LOG_LEVEL_INFO
+#define VWAP_LOG_INFO(...) g_asyncLogger.log(LogLevel::INFO, __VA_ARGS__)
+#else
+#define VWAP_LOG_INFO(...) ((void)0)
+#endif
+
+#if VWAP_LOG_LEVEL <= VWAP_LOG_LEVEL_WARN
+#define VWAP_LOG_WARN(...) g_asyncLogger.log(LogLevel::WARN, __VA_ARGS__)
+#else
+#define VWAP_LOG_WARN(...) ((void)0)
+#endif
+
+#if VWAP_LOG_LEVEL <= VWAP_LOG_LEVEL_ERROR
+#define VWAP_LOG_ERROR(...) g_asyncLogger.log(LogLevel::ERROR, __VA_ARGS__)
+#else
+#define VWAP_LOG_ERROR(...) ((void)0)
+#endif
+
+#endif // ASYNC_LOGGER_H
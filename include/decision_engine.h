@@ -30,7 +30,8 @@ public:
         double vwap;
         uint32_t quoteSize;
         uint32_t orderSize;
-        std::string reason;
+        // Static storage: the async logger keeps only the pointer.
+        const char* reason;
     };
 
 private:
@@ -64,8 +65,10 @@ private:
 
 public:
     DecisionEngine(const std::string& symbol, char side, uint32_t maxOrderSize, uint64_t cooldownNanos = 100'000'000ULL);
-    void onVwapWindowComplete();
+    void onVwapWindowComplete(bool announce = true);
     Optional<OrderMessage> evaluateQuote(const QuoteMessage& quote, double vwap);
+    // The traded side of a quote only: the ask for a buyer, the bid for a seller.
+    Optional<OrderMessage> evaluateQuote(uint64_t timestamp, int32_t price, uint32_t quantity, double vwap);
     bool isReady() const noexcept { return currentState != TradingState::WAITING_FOR_FIRST_WINDOW; }
     void printStatistics() const;
     uint64_t getRejWaitingWindow() const noexcept { return rejWaitingWindow; }
@@ -74,12 +77,12 @@ public:
     uint64_t getRejDuplicate() const noexcept { return rejDuplicate; }
 
 private:
-    bool shouldTriggerOrder(const QuoteMessage& quote, double vwap) const noexcept;
+    bool shouldTriggerOrder(int32_t price, double vwap) const noexcept;
     uint32_t calculateOrderSize(uint32_t quoteSize) const noexcept;
-    bool isDuplicateQuote(const QuoteMessage& quote) const noexcept;
+    bool isDuplicateQuote(const QuoteIdentifier& current) const noexcept;
     bool isInCooldown(uint64_t currentTime) const noexcept;
     void recordDecision(const Decision& decision);
-    OrderMessage buildOrder(const QuoteMessage& quote, uint32_t orderSize) const;
+    OrderMessage buildOrder(uint64_t timestamp, int32_t price, uint32_t orderSize) const;
 };
 
 #endif
@@ -0,0 +1,17 @@
+#ifndef EVENT_SOURCE_H
+#define EVENT_SOURCE_H
+
+#include <sys/select.h>
+
+// Descriptors serviced by the network manager's event loop after market
+// data and orders, for low-priority work such as the metrics endpoint.
+class EventSource {
+public:
+    virtual ~EventSource() = default;
+    // Adds the descriptors to wait on and raises maxFd to cover them.
+    virtual void watch(fd_set& readSet, fd_set& writeSet, int& maxFd) = 0;
+    // Called after every wait with the ready sets.
+    virtual void service(const fd_set& readSet, const fd_set& writeSet) = 0;
+};
+
+#endif // EVENT_SOURCE_H
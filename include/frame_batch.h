@@ -0,0 +1,105 @@
+#ifndef FRAME_BATCH_H
+#define FRAME_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "message.h"
+#include "message_view.h"
+
+// Column-per-field decode of the frames delivered by one drain. Row i is the
+// i-th delivered frame in wire order. Trades fill price/quantity; quotes put
+// the ask side in price/quantity and the bid side in bidPrice/bidQuantity.
+// Symbols are interned per batch, so symbolId indexes symbols[].
+struct FrameBatch final {
+    static constexpr size_t CAPACITY = 256;
+    static_assert(CAPACITY <= 256, "symbolId is a uint8_t");
+
+    size_t count = 0;
+    size_t symbolCount = 0;
+    // Kernel receive timestamp (CLOCK_REALTIME ns) of the read these frames
+    // came from, or 0 when receive timestamps are off or unavailable.
+    uint64_t rxKernelNanos = 0;
+    uint8_t type[CAPACITY];
+    uint8_t symbolId[CAPACITY];
+    uint64_t timestamp[CAPACITY];
+    int32_t price[CAPACITY];
+    uint32_t quantity[CAPACITY];
+    uint32_t bidPrice[CAPACITY];
+    uint32_t bidQuantity[CAPACITY];
+    uint64_t symbols[CAPACITY];
+
+    void clear() noexcept { count = 0; symbolCount = 0; }
+    bool empty() const noexcept { return count == 0; }
+    bool full() const noexcept { return count == CAPACITY; }
+    bool isTrade(size_t i) const noexcept { return type[i] == MessageHeader::TRADE_TYPE; }
+
+    inline uint8_t intern(uint64_t word) noexcept {
+        for (size_t i = symbolCount; i-- > 0;) {
+            if (symbols[i] == word) return static_cast<uint8_t>(i);
+        }
+        symbols[symbolCount] = word;
+        return static_cast<uint8_t>(symbolCount++);
+    }
+
+    inline void append(const QuoteView& q) noexcept {
+        size_t i = count++;
+        type[i] = MessageHeader::QUOTE_TYPE;
+        symbolId[i] = intern(q.symbolWord());
+        timestamp[i] = q.timestamp();
+        price[i] = q.askPrice();
+        quantity[i] = q.askQuantity();
+        bidPrice[i] = q.bidPrice();
+        bidQuantity[i] = q.bidQuantity();
+    }
+
+    inline void append(const TradeView& t) noexcept {
+        size_t i = count++;
+        type[i] = MessageHeader::TRADE_TYPE;
+        symbolId[i] = intern(t.symbolWord());
+        timestamp[i] = t.timestamp();
+        price[i] = t.price();
+        quantity[i] = t.quantity();
+        bidPrice[i] = 0;
+        bidQuantity[i] = 0;
+    }
+
+    QuoteMessage quoteAt(size_t i) const noexcept {
+        QuoteMessage q;
+        std::memcpy(q.symbol, &symbols[symbolId[i]], sizeof(q.symbol));
+        q.timestamp = timestamp[i];
+        q.bidQuantity = bidQuantity[i];
+        q.bidPrice = bidPrice[i];
+        q.askQuantity = quantity[i];
+        q.askPrice = price[i];
+        return q;
+    }
+
+    TradeMessage tradeAt(size_t i) const noexcept {
+        TradeMessage t;
+        std::memcpy(t.symbol, &symbols[symbolId[i]], sizeof(t.symbol));
+        t.timestamp = timestamp[i];
+        t.quantity = quantity[i];
+        t.price = price[i];
+        return t;
+    }
+
+    // Walks the rows in order. Each maximal run of consecutive trades on one
+    // symbol goes to onTrades(first, n); every quote goes to onQuote(i).
+    template<typename TradeRunFn, typename QuoteFn>
+    void forEachRun(TradeRunFn&& onTrades, QuoteFn&& onQuote) const {
+        size_t i = 0;
+        while (i < count) {
+            if (!isTrade(i)) {
+                onQuote(i);
+                ++i;
+                continue;
+            }
+            size_t first = i;
+            while (++i < count && isTrade(i) && symbolId[i] == symbolId[first]) {}
+            onTrades(first, i - first);
+        }
+    }
+};
+
+#endif // FRAME_BATCH_H
@@ -0,0 +1,59 @@
+#ifndef LINE_ARBITER_H
+#define LINE_ARBITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// First-copy-wins arbitration across redundant market data lines carrying
+// the same stream. Each message is identified by a fingerprint of its type
+// and whole body (symbol, timestamp and payload); the first line to deliver
+// a fingerprint wins and later copies inside the window are suppressed.
+class LineArbiter final {
+public:
+    static constexpr size_t MAX_LINES = 8;
+    // Number of most recent distinct messages remembered for deduplication.
+    static constexpr size_t WINDOW = 4096;
+
+    struct LineStats {
+        uint64_t wins = 0;
+        uint64_t duplicates = 0;
+        uint64_t lagTotalNanos = 0;
+        uint64_t lagMaxNanos = 0;
+    };
+
+private:
+    static constexpr size_t WAYS = 8;
+    static constexpr size_t BUCKETS = 2 * WINDOW / WAYS;
+    static_assert((BUCKETS & (BUCKETS - 1)) == 0, "BUCKETS must be a power of two");
+
+    struct Entry {
+        uint64_t fingerprint;
+        uint64_t firstSeenNanos;
+        uint64_t sequence;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<LineStats> lines;
+    uint64_t nextSequence;
+
+    bool live(const Entry& e) const noexcept {
+        return e.fingerprint != 0 && nextSequence - e.sequence <= WINDOW;
+    }
+
+public:
+    explicit LineArbiter(size_t lineCount);
+
+    static uint64_t fingerprint(uint8_t type, const uint8_t* body, size_t length) noexcept;
+
+    // Returns true when this is the first copy and should be forwarded.
+    bool admit(size_t line, uint8_t type, const uint8_t* body, size_t length, uint64_t nowNanos) noexcept;
+
+    size_t lineCount() const noexcept { return lines.size(); }
+    const LineStats& stats(size_t line) const noexcept { return lines[line]; }
+    uint64_t uniqueMessages() const noexcept { return nextSequence; }
+
+    void printStatistics() const;
+};
+
+#endif // LINE_ARBITER_H
@@ -4,18 +4,374 @@
 #include "tcp_client.h"
 #include "message_buffer.h"
 #include "message.h"
+#include "metrics.h"
+#include "wire_format.h"
+#include "message_view.h"
+#include "symbol_filter.h"
+#include "frame_batch.h"
+#include "quote_conflator.h"
+#include "trace.h"
 #include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
-class MarketDataClient : public TcpClient {
-private:
+class ShmRingReader;
+
+// Receive-side state shared by every handler instantiation.
+class MarketDataClientBase : public TcpClient {
+public:
+    enum class Transport { TCP, UDP, SHM };
+
+protected:
+    struct DatagramReceiver;
+
+    Transport transport;
+    std::unique_ptr<DatagramReceiver> datagrams;
+    std::unique_ptr<ShmRingReader> ring;
+    std::string ringName;
     MessageBuffer receiveBuffer;
-    std::function<void(const MessageHeader&, const void*)> messageCallback;
+    SymbolFilter subscriptions;
+    QuoteConflator conflator;
+    bool conflateQuotes;
+    // Earliest kernel receive timestamp of the last fillReceiveBuffer().
+    uint64_t fillRxKernelNanos;
+
+    struct DrainCounts {
+        uint64_t messages = 0;
+        uint64_t quotes = 0;
+        uint64_t trades = 0;
+        uint64_t filtered = 0;
+        uint64_t batches = 0;
+        uint64_t conflated = 0;
+    };
+
+    MarketDataClientBase(const std::string& host, uint16_t port);
+    ~MarketDataClientBase();
+
+    // Pulls available socket bytes into receiveBuffer. Returns false when the
+    // connection was closed or failed.
+    bool fillReceiveBuffer(uint64_t& bytesRead) noexcept;
+    // Same contract for the shared memory ring.
+    bool fillFromRing(uint64_t& bytesRead) noexcept;
+    // Returns a pointer to the whole body, stitching a wrapped body into scratch.
+    const uint8_t* contiguousBody(const MessageHeader& header, const uint8_t* body, size_t contiguous,
+                                  uint8_t* scratch) const noexcept;
+    // Returns true when framing was recovered and draining can continue.
+    bool handleFramingError(MessageBuffer::ExtractResult result) noexcept;
+    void publishCounts(uint64_t bytes, const DrainCounts& counts) noexcept;
+
+    bool openUdp() noexcept;
+    // Reads a batch of datagrams with one syscall. Returns how many, or -1
+    // when the socket failed.
+    int receiveDatagrams() noexcept;
+    // Sequence-checks datagram i and returns its frames, or false when it is
+    // truncated, stale or a duplicate. Gaps are counted and then accepted.
+    bool datagramPayload(int index, const uint8_t*& payload, size_t& length, uint64_t& bytes) noexcept;
+    void datagramMalformed() noexcept;
+    bool openRing() noexcept;
+
+public:
+    // UDP binds host:port (joining the group when it is multicast) and
+    // reads datagrams of WireFormat frames. Set before connect(). A host of
+    // shm://name always selects SHM, which reads the simulator's ring in
+    // /dev/shm/name and ignores the port. SHM has no socket to wait on, so
+    // getSocketFd() is -1 and the owner polls processIncomingData().
+    void setTransport(Transport t);
+    Transport getTransport() const noexcept { return transport; }
+    bool connect() noexcept;
+    bool reconnect() noexcept;
+    void disconnect() noexcept;
+
+    // Frames whose symbol is not subscribed are consumed without parsing.
+    // With no subscriptions every symbol is delivered.
+    bool subscribe(const std::string& symbol) noexcept { return subscriptions.add(symbol.data(), symbol.size()); }
+    void setSubscriptions(const SymbolFilter& filter) noexcept { subscriptions = filter; }
+    const SymbolFilter& getSubscriptions() const noexcept { return subscriptions; }
+
+    // Conflation holds quotes until the end of each drain and delivers only
+    // the newest per symbol, after every trade of that drain has been
+    // delivered in order. Decisions therefore see the freshest book and VWAP.
+    void setConflation(bool enabled) noexcept { conflateQuotes = enabled; }
+    void prefault() noexcept { receiveBuffer.prefault(); }
+    bool isConflating() const noexcept { return conflateQuotes; }
+
+protected:
+    inline void prefetchNextFrame() const noexcept {
+#if defined(__GNUC__)
+        if (receiveBuffer.availableBytes() >= WireFormat::HEADER_SIZE) {
+            size_t hi = receiveBuffer.headIndex();
+            size_t prefetchOffset = (hi + WireFormat::HEADER_SIZE) & (65536 - 1);
+            __builtin_prefetch(receiveBuffer.dataPtr() + prefetchOffset, 0, 1);
+        }
+#endif
+    }
+};
+
+// Handlers may take QuoteView/TradeView to read fields in place; otherwise a
+// QuoteMessage/TradeMessage is materialized for them.
+namespace HandlerDispatch {
+    template<typename...> struct VoidT { using type = void; };
+
+    template<typename H, typename = void> struct TakesQuoteView : std::false_type {};
+    template<typename H>
+    struct TakesQuoteView<H, typename VoidT<decltype(std::declval<H&>().onQuote(std::declval<const QuoteView&>()))>::type>
+        : std::true_type {};
+
+    template<typename H, typename = void> struct TakesTradeView : std::false_type {};
+    template<typename H>
+    struct TakesTradeView<H, typename VoidT<decltype(std::declval<H&>().onTrade(std::declval<const TradeView&>()))>::type>
+        : std::true_type {};
+
+    template<typename H, typename = void> struct TakesBatch : std::false_type {};
+    template<typename H>
+    struct TakesBatch<H, typename VoidT<decltype(std::declval<H&>().onBatch(std::declval<const FrameBatch&>()))>::type>
+        : std::true_type {};
+
+    template<typename H> inline void quote(H& h, const QuoteView& v, std::true_type) { h.onQuote(v); }
+    template<typename H> inline void quote(H& h, const QuoteView& v, std::false_type) { h.onQuote(v.toMessage()); }
+    template<typename H> inline void trade(H& h, const TradeView& v, std::true_type) { h.onTrade(v); }
+    template<typename H> inline void trade(H& h, const TradeView& v, std::false_type) { h.onTrade(v.toMessage()); }
+}
+
+// Frames, parses and delivers messages straight to Handler::onQuote /
+// Handler::onTrade. The handler type is static, so the whole path from frame
+// to strategy is visible to the compiler and can be inlined.
+//
+// In batch mode every drained frame is first decoded into a FrameBatch and
+// the handler gets one onBatch call per batch, so decode and strategy code
+// each run as a tight loop. Rows keep wire order. Only handlers with an
+// onBatch member can enable it.
+template<typename Handler>
+class BasicMarketDataClient : public MarketDataClientBase {
+private:
+    Handler* handler;
+    bool batchMode;
+    FrameBatch batch;
+
+public:
+    BasicMarketDataClient(const std::string& host, uint16_t port, Handler* h = nullptr)
+        : MarketDataClientBase(host, port), handler(h), batchMode(false) {}
+
+    void setHandler(Handler* h) noexcept { handler = h; }
+    Handler* getHandler() const noexcept { return handler; }
+
+    // Returns false when batch mode was requested but Handler has no onBatch.
+    bool setBatchMode(bool enabled) noexcept {
+        batchMode = enabled && HandlerDispatch::TakesBatch<Handler>::value;
+        return batchMode == enabled;
+    }
+    bool isBatchMode() const noexcept { return batchMode; }
+
+    bool processIncomingData();
+
+private:
+    bool processDatagrams();
+    void drain(DrainCounts& counts);
+    void drainFrames(DrainCounts& counts);
+    void drainBatched(DrainCounts& counts, std::true_type);
+    void drainBatched(DrainCounts&, std::false_type) {}
+    void dispatchBatch(DrainCounts& counts);
+    template<typename Batched> void holdQuote(const uint8_t* body, DrainCounts& counts, Batched batched);
+    void releaseHeldQuotes(DrainCounts& counts, std::true_type);
+    void releaseHeldQuotes(DrainCounts& counts, std::false_type);
+};
+
+template<typename Handler>
+bool BasicMarketDataClient<Handler>::processIncomingData() {
+    if (transport == Transport::UDP) return processDatagrams();
+
+    uint64_t localBytes = 0;
+    if (!(transport == Transport::SHM ? fillFromRing(localBytes) : fillReceiveBuffer(localBytes))) return false;
+    VWAP_TRACE(RECV, 0, localBytes);
+
+    DrainCounts counts;
+    g_rxKernelNanos = fillRxKernelNanos;
+    drain(counts);
+    g_rxKernelNanos = 0;
+    publishCounts(localBytes, counts);
+    return true;
+}
+
+// Each datagram is drained on its own so a lost datagram never splices
+// frames from its neighbours.
+template<typename Handler>
+bool BasicMarketDataClient<Handler>::processDatagrams() {
+    int received = receiveDatagrams();
+    if (received < 0) return false;
+
+    uint64_t localBytes = 0;
+    DrainCounts counts;
+    for (int i = 0; i < received; ++i) {
+        const uint8_t* payload; size_t length;
+        if (!datagramPayload(i, payload, length, localBytes)) continue;
+        VWAP_TRACE(RECV, 0, length);
+        receiveBuffer.clear();
+        receiveBuffer.append(payload, length);
+        drain(counts);
+        if (receiveBuffer.availableBytes() != 0) datagramMalformed();
+    }
+    receiveBuffer.clear();
+    publishCounts(localBytes, counts);
+    return true;
+}
+
+template<typename Handler>
+inline void BasicMarketDataClient<Handler>::drain(DrainCounts& counts) {
+    if (batchMode) {
+        drainBatched(counts, HandlerDispatch::TakesBatch<Handler>{});
+    } else {
+        drainFrames(counts);
+    }
+}
+
+template<typename Handler>
+void BasicMarketDataClient<Handler>::drainFrames(DrainCounts& counts) {
+    while (true) {
+        MessageHeader header; const uint8_t* bodyPtr; size_t contiguous;
+        auto pr = receiveBuffer.peekMessage(header, bodyPtr, contiguous);
+        if (pr != MessageBuffer::ExtractResult::SUCCESS) {
+            if (handleFramingError(pr)) continue;
+            break;
+        }
+        VWAP_TRACE(FRAME, 0, header.type);
+
+        messagesReceived++;
+        ++counts.messages;
+        uint8_t scratch[WireFormat::QUOTE_SIZE];
+        const uint8_t* body = contiguousBody(header, bodyPtr, contiguous, scratch);
+        if (!subscriptions.accepts(SymbolFilter::load(body))) {
+            ++counts.filtered;
+        } else if (header.type == MessageHeader::QUOTE_TYPE) {
+            QuoteView quote(body);
+            if (quote.valid()) {
+                VWAP_TRACE(PARSE, quote.timestamp(), header.type);
+                ++counts.quotes;
+                if (conflateQuotes) {
+                    holdQuote(body, counts, std::false_type{});
+                } else if (handler) {
+                    HandlerDispatch::quote(*handler, quote, HandlerDispatch::TakesQuoteView<Handler>{});
+                }
+            } else {
+                g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        } else if (header.type == MessageHeader::TRADE_TYPE) {
+            TradeView trade(body);
+            if (trade.valid()) {
+                VWAP_TRACE(PARSE, trade.timestamp(), header.type);
+                ++counts.trades;
+                if (handler) HandlerDispatch::trade(*handler, trade, HandlerDispatch::TakesTradeView<Handler>{});
+            } else {
+                g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        } else {
+            g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        receiveBuffer.consume(header);
+        prefetchNextFrame();
+    }
+    if (!conflator.empty()) releaseHeldQuotes(counts, std::false_type{});
+}
+
+template<typename Handler>
+void BasicMarketDataClient<Handler>::drainBatched(DrainCounts& counts, std::true_type) {
+    batch.clear();
+    batch.rxKernelNanos = g_rxKernelNanos;
+    while (true) {
+        MessageHeader header; const uint8_t* bodyPtr; size_t contiguous;
+        auto pr = receiveBuffer.peekMessage(header, bodyPtr, contiguous);
+        if (pr != MessageBuffer::ExtractResult::SUCCESS) {
+            if (handleFramingError(pr)) continue;
+            break;
+        }
+        VWAP_TRACE(FRAME, 0, header.type);
+
+        messagesReceived++;
+        ++counts.messages;
+        uint8_t scratch[WireFormat::QUOTE_SIZE];
+        const uint8_t* body = contiguousBody(header, bodyPtr, contiguous, scratch);
+        if (!subscriptions.accepts(SymbolFilter::load(body))) {
+            ++counts.filtered;
+        } else if (header.type == MessageHeader::QUOTE_TYPE && QuoteView(body).valid()) {
+            VWAP_TRACE(PARSE, QuoteView(body).timestamp(), header.type);
+            ++counts.quotes;
+            if (conflateQuotes) {
+                holdQuote(body, counts, std::true_type{});
+            } else {
+                batch.append(QuoteView(body));
+            }
+        } else if (header.type == MessageHeader::TRADE_TYPE && TradeView(body).valid()) {
+            VWAP_TRACE(PARSE, TradeView(body).timestamp(), header.type);
+            ++counts.trades;
+            batch.append(TradeView(body));
+        } else {
+            g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        receiveBuffer.consume(header);
+        prefetchNextFrame();
+        if (batch.full()) dispatchBatch(counts);
+    }
+    if (!conflator.empty()) releaseHeldQuotes(counts, std::true_type{});
+    if (!batch.empty()) dispatchBatch(counts);
+}
+
+template<typename Handler>
+void BasicMarketDataClient<Handler>::dispatchBatch(DrainCounts& counts) {
+    ++counts.batches;
+    if (handler) handler->onBatch(batch);
+    batch.clear();
+}
+
+template<typename Handler>
+template<typename Batched>
+void BasicMarketDataClient<Handler>::holdQuote(const uint8_t* body, DrainCounts& counts, Batched batched) {
+    auto held = conflator.hold(body);
+    if (held == QuoteConflator::HoldResult::FULL) {
+        releaseHeldQuotes(counts, batched);
+        held = conflator.hold(body);
+    }
+    if (held == QuoteConflator::HoldResult::REPLACED) ++counts.conflated;
+}
+
+template<typename Handler>
+void BasicMarketDataClient<Handler>::releaseHeldQuotes(DrainCounts& counts, std::true_type) {
+    conflator.release([&](const QuoteView& quote) {
+        if (batch.full()) dispatchBatch(counts);
+        batch.append(quote);
+    });
+}
+
+template<typename Handler>
+void BasicMarketDataClient<Handler>::releaseHeldQuotes(DrainCounts&, std::false_type) {
+    conflator.release([&](const QuoteView& quote) {
+        if (handler) HandlerDispatch::quote(*handler, quote, HandlerDispatch::TakesQuoteView<Handler>{});
+    });
+}
+
+// Adapter that keeps the original type-erased callback API available.
+struct MessageCallbackAdapter {
+    std::function<void(const MessageHeader&, const void*)> callback;
+
+    void onQuote(const QuoteMessage& quote) {
+        if (!callback) return;
+        MessageHeader header{static_cast<uint8_t>(WireFormat::QUOTE_SIZE), MessageHeader::QUOTE_TYPE};
+        callback(header, &quote);
+    }
+    void onTrade(const TradeMessage& trade) {
+        if (!callback) return;
+        MessageHeader header{static_cast<uint8_t>(WireFormat::TRADE_SIZE), MessageHeader::TRADE_TYPE};
+        callback(header, &trade);
+    }
+};
+
+class MarketDataClient : public BasicMarketDataClient<MessageCallbackAdapter> {
+private:
+    MessageCallbackAdapter adapter;
 
 public:
     MarketDataClient(const std::string& host, uint16_t port);
 
     void setMessageCallback(std::function<void(const MessageHeader&, const void*)> cb);
-    bool processIncomingData();
 };
 
 #endif
@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <cstdint>
 #include "message.h"
+#include "realtime.h"
 
 class MessageBuffer final {
 public:
@@ -23,6 +24,9 @@ private:
     size_t tail;
     size_t used;
 
+    size_t scanForHeader(size_t from) const noexcept;
+    bool confirmHeader(size_t offset) const noexcept;
+
 public:
     MessageBuffer() noexcept;
     bool append(const uint8_t* data, size_t len) noexcept;
@@ -33,6 +37,9 @@ public:
     size_t availableBytes() const noexcept;
     size_t availableSpace() const noexcept;
     void clear() noexcept;
+    void prefault() noexcept { Realtime::prefault(buffer, sizeof(buffer)); }
+    // Discards bytes up to the next header whose following frame header is
+    // also valid (or not yet received). Returns the number of bytes dropped.
     size_t resync() noexcept;
     const uint8_t* dataPtr() const noexcept { return buffer; }
     size_t headIndex() const noexcept { return head; }
@@ -0,0 +1,63 @@
+#ifndef MESSAGE_SCHEMA_H
+#define MESSAGE_SCHEMA_H
+
+#include "message.h"
+#include "wire_format.h"
+#include "wire_schema.h"
+
+// Wire schemas for every message body. Field order is wire order.
+
+namespace QuoteFields {
+    using Symbol      = WireField<QuoteMessage, char[8],  &QuoteMessage::symbol>;
+    using Timestamp   = WireField<QuoteMessage, uint64_t, &QuoteMessage::timestamp>;
+    using BidQuantity = WireField<QuoteMessage, uint32_t, &QuoteMessage::bidQuantity, WireCheck::NonZero>;
+    using BidPrice    = WireField<QuoteMessage, uint32_t, &QuoteMessage::bidPrice,    WireCheck::NonNegative>;
+    using AskQuantity = WireField<QuoteMessage, uint32_t, &QuoteMessage::askQuantity, WireCheck::NonZero>;
+    using AskPrice    = WireField<QuoteMessage, int32_t,  &QuoteMessage::askPrice,    WireCheck::NonNegative>;
+}
+
+using QuoteSchema = WireSchema<QuoteMessage,
+    WireFields<QuoteFields::Symbol, QuoteFields::Timestamp, QuoteFields::BidQuantity,
+               QuoteFields::BidPrice, QuoteFields::AskQuantity, QuoteFields::AskPrice>,
+    WireRules<WireRule::NotGreater<QuoteFields::BidPrice, QuoteFields::AskPrice>>>;
+
+namespace TradeFields {
+    using Symbol    = WireField<TradeMessage, char[8],  &TradeMessage::symbol>;
+    using Timestamp = WireField<TradeMessage, uint64_t, &TradeMessage::timestamp>;
+    using Quantity  = WireField<TradeMessage, uint32_t, &TradeMessage::quantity, WireCheck::NonZero>;
+    using Price     = WireField<TradeMessage, int32_t,  &TradeMessage::price,    WireCheck::NonNegative>;
+}
+
+using TradeSchema = WireSchema<TradeMessage,
+    WireFields<TradeFields::Symbol, TradeFields::Timestamp, TradeFields::Quantity, TradeFields::Price>>;
+
+namespace OrderFields {
+    using Symbol    = WireField<OrderMessage, char[8],  &OrderMessage::symbol>;
+    using Timestamp = WireField<OrderMessage, uint64_t, &OrderMessage::timestamp>;
+    using Side      = WireField<OrderMessage, char,     &OrderMessage::side, WireCheck::OneOf<'B', 'S'>>;
+    using Quantity  = WireField<OrderMessage, uint32_t, &OrderMessage::quantity>;
+    using Price     = WireField<OrderMessage, int32_t,  &OrderMessage::price>;
+}
+
+using OrderSchema = WireSchema<OrderMessage,
+    WireFields<OrderFields::Symbol, OrderFields::Timestamp, OrderFields::Side,
+               OrderFields::Quantity, OrderFields::Price>>;
+
+// The published protocol constants must agree with the schemas.
+static_assert(QuoteSchema::size == WireFormat::QUOTE_SIZE, "Quote schema size");
+static_assert(QuoteSchema::offset<QuoteFields::Timestamp>() == WireFormat::QUOTE_TIMESTAMP_OFFSET, "Quote timestamp offset");
+static_assert(QuoteSchema::offset<QuoteFields::BidQuantity>() == WireFormat::QUOTE_BID_QTY_OFFSET, "Quote bid qty offset");
+static_assert(QuoteSchema::offset<QuoteFields::BidPrice>() == WireFormat::QUOTE_BID_PRICE_OFFSET, "Quote bid price offset");
+static_assert(QuoteSchema::offset<QuoteFields::AskQuantity>() == WireFormat::QUOTE_ASK_QTY_OFFSET, "Quote ask qty offset");
+static_assert(QuoteSchema::offset<QuoteFields::AskPrice>() == WireFormat::QUOTE_ASK_PRICE_OFFSET, "Quote ask price offset");
+static_assert(TradeSchema::size == WireFormat::TRADE_SIZE, "Trade schema size");
+static_assert(TradeSchema::offset<TradeFields::Timestamp>() == WireFormat::TRADE_TIMESTAMP_OFFSET, "Trade timestamp offset");
+static_assert(TradeSchema::offset<TradeFields::Quantity>() == WireFormat::TRADE_QUANTITY_OFFSET, "Trade quantity offset");
+static_assert(TradeSchema::offset<TradeFields::Price>() == WireFormat::TRADE_PRICE_OFFSET, "Trade price offset");
+static_assert(OrderSchema::size == WireFormat::ORDER_SIZE, "Order schema size");
+static_assert(OrderSchema::offset<OrderFields::Timestamp>() == WireFormat::ORDER_TIMESTAMP_OFFSET, "Order timestamp offset");
+static_assert(OrderSchema::offset<OrderFields::Side>() == WireFormat::ORDER_SIDE_OFFSET, "Order side offset");
+static_assert(OrderSchema::offset<OrderFields::Quantity>() == WireFormat::ORDER_QUANTITY_OFFSET, "Order quantity offset");
+static_assert(OrderSchema::offset<OrderFields::Price>() == WireFormat::ORDER_PRICE_OFFSET, "Order price offset");
+
+#endif // MESSAGE_SCHEMA_H
@@ -0,0 +1,69 @@
+#ifndef MESSAGE_VIEW_H
+#define MESSAGE_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "message.h"
+#include "wire_format.h"
+#include "message_schema.h"
+
+// Zero-copy accessors over a wire body, generated from the message schemas.
+// Fields are read on demand with unaligned-safe loads; the viewed bytes must
+// outlive the view.
+class QuoteView final {
+private:
+    const uint8_t* body;
+
+public:
+    explicit QuoteView(const uint8_t* wireBody) noexcept : body(wireBody) {}
+
+    const char* symbol() const noexcept { return QuoteSchema::get<QuoteFields::Symbol>(body); }
+    uint64_t symbolWord() const noexcept { uint64_t w; std::memcpy(&w, symbol(), sizeof(w)); return w; }
+    uint64_t timestamp() const noexcept { return QuoteSchema::get<QuoteFields::Timestamp>(body); }
+    uint32_t bidQuantity() const noexcept { return QuoteSchema::get<QuoteFields::BidQuantity>(body); }
+    uint32_t bidPrice() const noexcept { return QuoteSchema::get<QuoteFields::BidPrice>(body); }
+    uint32_t askQuantity() const noexcept { return QuoteSchema::get<QuoteFields::AskQuantity>(body); }
+    int32_t askPrice() const noexcept { return QuoteSchema::get<QuoteFields::AskPrice>(body); }
+    const uint8_t* data() const noexcept { return body; }
+
+    bool valid() const noexcept { return QuoteSchema::valid(body); }
+
+    void materialize(QuoteMessage& out) const noexcept { std::memcpy(&out, body, sizeof(out)); }
+    QuoteMessage toMessage() const noexcept { QuoteMessage q; materialize(q); return q; }
+};
+
+class TradeView final {
+private:
+    const uint8_t* body;
+
+public:
+    explicit TradeView(const uint8_t* wireBody) noexcept : body(wireBody) {}
+
+    const char* symbol() const noexcept { return TradeSchema::get<TradeFields::Symbol>(body); }
+    uint64_t symbolWord() const noexcept { uint64_t w; std::memcpy(&w, symbol(), sizeof(w)); return w; }
+    uint64_t timestamp() const noexcept { return TradeSchema::get<TradeFields::Timestamp>(body); }
+    uint32_t quantity() const noexcept { return TradeSchema::get<TradeFields::Quantity>(body); }
+    int32_t price() const noexcept { return TradeSchema::get<TradeFields::Price>(body); }
+    const uint8_t* data() const noexcept { return body; }
+
+    bool valid() const noexcept { return TradeSchema::valid(body); }
+
+    void materialize(TradeMessage& out) const noexcept { std::memcpy(&out, body, sizeof(out)); }
+    TradeMessage toMessage() const noexcept { TradeMessage t; materialize(t); return t; }
+};
+
+// materialize() is a straight copy because the native layout is the wire layout.
+static_assert(IS_LITTLE_ENDIAN, "Views materialize by byte copy");
+static_assert(sizeof(QuoteMessage) == WireFormat::QUOTE_SIZE, "Quote layout must match wire");
+static_assert(offsetof(QuoteMessage, timestamp) == WireFormat::QUOTE_TIMESTAMP_OFFSET, "Quote timestamp offset");
+static_assert(offsetof(QuoteMessage, bidQuantity) == WireFormat::QUOTE_BID_QTY_OFFSET, "Quote bid qty offset");
+static_assert(offsetof(QuoteMessage, bidPrice) == WireFormat::QUOTE_BID_PRICE_OFFSET, "Quote bid price offset");
+static_assert(offsetof(QuoteMessage, askQuantity) == WireFormat::QUOTE_ASK_QTY_OFFSET, "Quote ask qty offset");
+static_assert(offsetof(QuoteMessage, askPrice) == WireFormat::QUOTE_ASK_PRICE_OFFSET, "Quote ask price offset");
+static_assert(sizeof(TradeMessage) == WireFormat::TRADE_SIZE, "Trade layout must match wire");
+static_assert(offsetof(TradeMessage, timestamp) == WireFormat::TRADE_TIMESTAMP_OFFSET, "Trade timestamp offset");
+static_assert(offsetof(TradeMessage, quantity) == WireFormat::TRADE_QUANTITY_OFFSET, "Trade quantity offset");
+static_assert(offsetof(TradeMessage, price) == WireFormat::TRADE_PRICE_OFFSET, "Trade price offset");
+
+#endif // MESSAGE_VIEW_H
@@ -5,41 +5,135 @@
 #include <atomic>
 #include <cstring>
 #include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <vector>
 
 constexpr size_t CACHE_LINE_SIZE = 64;
 
-struct alignas(CACHE_LINE_SIZE) HotMetrics {
-    std::atomic<uint64_t> messagesSent;
-    std::atomic<uint64_t> messagesReceived;
-    std::atomic<uint64_t> bytesReceived;
-    std::atomic<uint64_t> bytesSent;
-    
-    std::atomic<uint64_t> ordersPlaced;
-    std::atomic<uint64_t> tradesProcessed;
-    std::atomic<uint64_t> quotesProcessed;
-    
-    static constexpr size_t PAD_BYTES_HOT = (CACHE_LINE_SIZE - 7 * sizeof(std::atomic<uint64_t>));
-    unsigned char _padding[PAD_BYTES_HOT ? PAD_BYTES_HOT : 1];
-    
-    HotMetrics() noexcept {
-        messagesSent = 0;
-        messagesReceived = 0;
-        bytesReceived = 0;
-        bytesSent = 0;
-        ordersPlaced = 0;
-        tradesProcessed = 0;
-        quotesProcessed = 0;
-        std::memset(_padding, 0, sizeof(_padding));
+// A counter with exactly one writing thread. The increment is a relaxed
+// load and store rather than a locked read-modify-write; other threads may
+// read it at any time.
+struct ShardCounter {
+    std::atomic<uint64_t> value;
+
+    ShardCounter() noexcept : value(0) {}
+    inline void add(uint64_t n) noexcept {
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
     }
-    
+    inline uint64_t load() const noexcept { return value.load(std::memory_order_relaxed); }
+    inline void reset() noexcept { value.store(0, std::memory_order_relaxed); }
+};
+
+// One thread's share of the per-message counters, on its own cache line.
+// Each counter has a single owner so nothing is counted twice:
+//   messagesSent, bytesSent          TcpClient::send / sendv
+//   messagesReceived, bytesReceived  market data client, every transport
+//   quotesProcessed, tradesProcessed market data client, frames delivered
+//   ordersPlaced                     OrderClient, once the order is written
+struct alignas(CACHE_LINE_SIZE) HotCounters {
+    ShardCounter messagesSent;
+    ShardCounter messagesReceived;
+    ShardCounter bytesReceived;
+    ShardCounter bytesSent;
+
+    ShardCounter ordersPlaced;
+    ShardCounter tradesProcessed;
+    ShardCounter quotesProcessed;
+
+    struct Totals {
+        uint64_t messagesSent;
+        uint64_t messagesReceived;
+        uint64_t bytesReceived;
+        uint64_t bytesSent;
+        uint64_t ordersPlaced;
+        uint64_t tradesProcessed;
+        uint64_t quotesProcessed;
+    };
+
+    void addTo(Totals& t) const noexcept {
+        t.messagesSent     += messagesSent.load();
+        t.messagesReceived += messagesReceived.load();
+        t.bytesReceived    += bytesReceived.load();
+        t.bytesSent        += bytesSent.load();
+        t.ordersPlaced     += ordersPlaced.load();
+        t.tradesProcessed  += tradesProcessed.load();
+        t.quotesProcessed  += quotesProcessed.load();
+    }
+
     void reset() noexcept {
-        messagesSent = 0;
-        messagesReceived = 0;
-        bytesReceived = 0;
-        bytesSent = 0;
-        ordersPlaced = 0;
-        tradesProcessed = 0;
-        quotesProcessed = 0;
+        messagesSent.reset();
+        messagesReceived.reset();
+        bytesReceived.reset();
+        bytesSent.reset();
+        ordersPlaced.reset();
+        tradesProcessed.reset();
+        quotesProcessed.reset();
+    }
+
+    void accumulate(const HotCounters& other) noexcept {
+        messagesSent.add(other.messagesSent.load());
+        messagesReceived.add(other.messagesReceived.load());
+        bytesReceived.add(other.bytesReceived.load());
+        bytesSent.add(other.bytesSent.load());
+        ordersPlaced.add(other.ordersPlaced.load());
+        tradesProcessed.add(other.tradesProcessed.load());
+        quotesProcessed.add(other.quotesProcessed.load());
+    }
+};
+
+// Registry of every thread's HotCounters. Threads attach on their first
+// increment and fold their counts into retired when they exit, so totals
+// survive the thread.
+class HotMetrics {
+private:
+    mutable std::mutex lock;
+    std::vector<HotCounters*> shards;
+    HotCounters retired;
+
+public:
+    HotMetrics() = default;
+    HotMetrics(const HotMetrics&) = delete;
+    HotMetrics& operator=(const HotMetrics&) = delete;
+
+    void attach(HotCounters* shard) {
+        std::lock_guard<std::mutex> guard(lock);
+        shards.push_back(shard);
+    }
+
+    void detach(HotCounters* shard) noexcept {
+        std::lock_guard<std::mutex> guard(lock);
+        for (size_t i = 0; i < shards.size(); ++i) {
+            if (shards[i] != shard) continue;
+            retired.accumulate(*shard);
+            shards[i] = shards.back();
+            shards.pop_back();
+            break;
+        }
+    }
+
+    // Sums every live shard and the retired counts. Individual counters are
+    // exact; counters from different shards may be from slightly different
+    // moments.
+    HotCounters::Totals total() const noexcept {
+        HotCounters::Totals t{};
+        std::lock_guard<std::mutex> guard(lock);
+        retired.addTo(t);
+        for (const HotCounters* shard : shards) shard->addTo(t);
+        return t;
+    }
+
+    size_t threads() const noexcept {
+        std::lock_guard<std::mutex> guard(lock);
+        return shards.size();
+    }
+
+    // Only while no thread is counting: a concurrent increment can write
+    // back a pre-reset value.
+    void reset() noexcept {
+        std::lock_guard<std::mutex> guard(lock);
+        for (HotCounters* shard : shards) shard->reset();
+        retired.reset();
     }
 };
 
@@ -123,31 +217,155 @@ struct alignas(CACHE_LINE_SIZE) PerformanceMetrics {
     }
 };
 
-struct SystemMetrics {
-    HotMetrics hot;
-    ColdMetrics cold;
-    PerformanceMetrics perf;
-    
+struct alignas(CACHE_LINE_SIZE) BatchMetrics {
+    std::atomic<uint64_t> flushSyscalls;
+    std::atomic<uint64_t> ordersFlushed;
+    std::atomic<uint64_t> batchesFlushed;
+    std::atomic<uint64_t> batchDelayTotalNanos;
+    std::atomic<uint64_t> batchDelayMaxNanos;
+    std::atomic<uint64_t> budgetFlushes;
+
+    static constexpr size_t PAD_BYTES_BATCH = (CACHE_LINE_SIZE - 6 * sizeof(std::atomic<uint64_t>));
+    unsigned char _padding[PAD_BYTES_BATCH];
+
+    BatchMetrics() noexcept {
+        reset();
+        std::memset(_padding, 0, sizeof(_padding));
+    }
+
     void reset() noexcept {
-        hot.reset();
-        cold.reset();
-        perf.reset();
+        flushSyscalls = 0;
+        ordersFlushed = 0;
+        batchesFlushed = 0;
+        batchDelayTotalNanos = 0;
+        batchDelayMaxNanos = 0;
+        budgetFlushes = 0;
+    }
+};
+
+struct alignas(CACHE_LINE_SIZE) FeedMetrics {
+    std::atomic<uint64_t> messagesFiltered;
+    std::atomic<uint64_t> resyncBytesDiscarded;
+    std::atomic<uint64_t> batchesDispatched;
+    std::atomic<uint64_t> quotesConflated;
+    std::atomic<uint64_t> lineDuplicates;
+    std::atomic<uint64_t> ringOverruns;
+
+    static constexpr size_t PAD_BYTES_FEED = (CACHE_LINE_SIZE - 6 * sizeof(std::atomic<uint64_t>));
+    unsigned char _padding[PAD_BYTES_FEED];
+
+    FeedMetrics() noexcept {
+        reset();
+        std::memset(_padding, 0, sizeof(_padding));
+    }
+
+    void reset() noexcept {
+        messagesFiltered = 0;
+        resyncBytesDiscarded = 0;
+        batchesDispatched = 0;
+        quotesConflated = 0;
+        lineDuplicates = 0;
+        ringOverruns = 0;
     }
 };
 
+struct alignas(CACHE_LINE_SIZE) UdpMetrics {
+    std::atomic<uint64_t> datagramsReceived;
+    std::atomic<uint64_t> receiveCalls;
+    std::atomic<uint64_t> datagramsLost;
+    std::atomic<uint64_t> datagramsDropped;
+
+    static constexpr size_t PAD_BYTES_UDP = (CACHE_LINE_SIZE - 4 * sizeof(std::atomic<uint64_t>));
+    unsigned char _padding[PAD_BYTES_UDP];
+
+    UdpMetrics() noexcept {
+        reset();
+        std::memset(_padding, 0, sizeof(_padding));
+    }
+
+    void reset() noexcept {
+        datagramsReceived = 0;
+        receiveCalls = 0;
+        datagramsLost = 0;
+        datagramsDropped = 0;
+    }
+};
+
+// Power-of-two buckets: bucket b counts values below 2^b that fell in no
+// lower bucket; the last bucket takes everything larger.
 struct LatencyHistogram {
-    static constexpr size_t BUCKETS = 22;
+    static constexpr size_t BUCKETS = 32;
     std::atomic<uint64_t> buckets[BUCKETS];
-    LatencyHistogram() noexcept { for (size_t i=0;i<BUCKETS;++i) buckets[i]=0; }
+    std::atomic<uint64_t> totalNanos;
+    LatencyHistogram() noexcept : totalNanos(0) { for (size_t i=0;i<BUCKETS;++i) buckets[i]=0; }
     void record(uint64_t nanos) noexcept {
         uint64_t v = nanos;
-        size_t idx = 21;
-        for (size_t b=0;b<21;++b) {
+        size_t idx = BUCKETS - 1;
+        for (size_t b=0;b<BUCKETS-1;++b) {
             if (v < (1ull<<b)) { idx = b; break; }
         }
         buckets[idx].fetch_add(1, std::memory_order_relaxed);
+        totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+    }
+    void reset() noexcept { for (size_t i=0;i<BUCKETS;++i) buckets[i]=0; totalNanos = 0; }
+
+    uint64_t count() const noexcept {
+        uint64_t n = 0;
+        for (size_t i=0;i<BUCKETS;++i) n += buckets[i].load(std::memory_order_relaxed);
+        return n;
+    }
+    // Upper bound of the bucket holding the q-th quantile, or 0 when empty.
+    uint64_t percentile(double q) const noexcept {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(n - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i=0;i<BUCKETS;++i) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank) return 1ull << i;
+        }
+        return 1ull << (BUCKETS - 1);
+    }
+};
+
+// Latency measured from the kernel's software receive timestamp of the
+// market data that triggered the work (CLOCK_REALTIME).
+struct alignas(CACHE_LINE_SIZE) WireLatencyMetrics {
+    LatencyHistogram kernelToUser;
+    LatencyHistogram kernelToOrder;
+    std::atomic<uint64_t> unstampedReads;
+
+    void reset() noexcept {
+        kernelToUser.reset();
+        kernelToOrder.reset();
+        unstampedReads = 0;
+    }
+};
+
+inline uint64_t realtimeNanos() noexcept {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+struct SystemMetrics {
+    HotMetrics hot;
+    ColdMetrics cold;
+    PerformanceMetrics perf;
+    BatchMetrics batch;
+    FeedMetrics feed;
+    UdpMetrics udp;
+    WireLatencyMetrics wire;
+    
+    void reset() noexcept {
+        hot.reset();
+        cold.reset();
+        perf.reset();
+        batch.reset();
+        feed.reset();
+        udp.reset();
+        wire.reset();
     }
-    void reset() noexcept { for (size_t i=0;i<BUCKETS;++i) buckets[i]=0; }
 };
 
 struct MetricsSnapshot {
@@ -172,16 +390,44 @@ struct MetricsSnapshot {
     uint64_t latencyCount;
     uint64_t resyncEvents;
     uint64_t peakMessagesPerSecond;
+    uint64_t flushSyscalls;
+    uint64_t ordersFlushed;
+    uint64_t batchesFlushed;
+    uint64_t batchDelayTotalNanos;
+    uint64_t batchDelayMaxNanos;
+    uint64_t budgetFlushes;
+    uint64_t messagesFiltered;
+    uint64_t resyncBytesDiscarded;
+    uint64_t batchesDispatched;
+    uint64_t quotesConflated;
+    uint64_t lineDuplicates;
+    uint64_t ringOverruns;
+    uint64_t datagramsReceived;
+    uint64_t datagramReceiveCalls;
+    uint64_t datagramsLost;
+    uint64_t datagramsDropped;
+    uint64_t kernelToUserCount;
+    uint64_t kernelToUserP50;
+    uint64_t kernelToUserP99;
+    uint64_t kernelToOrderCount;
+    uint64_t kernelToOrderP50;
+    uint64_t kernelToOrderP99;
+    uint64_t unstampedReads;
+
+    double ordersPerSyscall() const noexcept {
+        return flushSyscalls ? static_cast<double>(ordersFlushed) / static_cast<double>(flushSyscalls) : 0.0;
+    }
 
     static MetricsSnapshot capture(const SystemMetrics& m) noexcept {
         MetricsSnapshot s{};
-        s.messagesSent     = m.hot.messagesSent.load(std::memory_order_relaxed);
-        s.messagesReceived = m.hot.messagesReceived.load(std::memory_order_relaxed);
-        s.bytesReceived    = m.hot.bytesReceived.load(std::memory_order_relaxed);
-        s.bytesSent        = m.hot.bytesSent.load(std::memory_order_relaxed);
-        s.ordersPlaced     = m.hot.ordersPlaced.load(std::memory_order_relaxed);
-        s.tradesProcessed  = m.hot.tradesProcessed.load(std::memory_order_relaxed);
-        s.quotesProcessed  = m.hot.quotesProcessed.load(std::memory_order_relaxed);
+        const HotCounters::Totals hot = m.hot.total();
+        s.messagesSent     = hot.messagesSent;
+        s.messagesReceived = hot.messagesReceived;
+        s.bytesReceived    = hot.bytesReceived;
+        s.bytesSent        = hot.bytesSent;
+        s.ordersPlaced     = hot.ordersPlaced;
+        s.tradesProcessed  = hot.tradesProcessed;
+        s.quotesProcessed  = hot.quotesProcessed;
         s.connectionsAccepted = m.cold.connectionsAccepted.load(std::memory_order_relaxed);
         s.connectionsClosed   = m.cold.connectionsClosed.load(std::memory_order_relaxed);
         s.connectionErrors    = m.cold.connectionErrors.load(std::memory_order_relaxed);
@@ -196,6 +442,29 @@ struct MetricsSnapshot {
         s.latencyCount        = m.perf.latencyCount.load(std::memory_order_relaxed);
         s.resyncEvents        = m.perf.resyncEvents.load(std::memory_order_relaxed);
         s.peakMessagesPerSecond = m.perf.peakMessagesPerSecond.load(std::memory_order_relaxed);
+        s.flushSyscalls        = m.batch.flushSyscalls.load(std::memory_order_relaxed);
+        s.ordersFlushed        = m.batch.ordersFlushed.load(std::memory_order_relaxed);
+        s.batchesFlushed       = m.batch.batchesFlushed.load(std::memory_order_relaxed);
+        s.batchDelayTotalNanos = m.batch.batchDelayTotalNanos.load(std::memory_order_relaxed);
+        s.batchDelayMaxNanos   = m.batch.batchDelayMaxNanos.load(std::memory_order_relaxed);
+        s.budgetFlushes        = m.batch.budgetFlushes.load(std::memory_order_relaxed);
+        s.messagesFiltered     = m.feed.messagesFiltered.load(std::memory_order_relaxed);
+        s.resyncBytesDiscarded = m.feed.resyncBytesDiscarded.load(std::memory_order_relaxed);
+        s.batchesDispatched    = m.feed.batchesDispatched.load(std::memory_order_relaxed);
+        s.quotesConflated      = m.feed.quotesConflated.load(std::memory_order_relaxed);
+        s.lineDuplicates       = m.feed.lineDuplicates.load(std::memory_order_relaxed);
+        s.ringOverruns         = m.feed.ringOverruns.load(std::memory_order_relaxed);
+        s.datagramsReceived    = m.udp.datagramsReceived.load(std::memory_order_relaxed);
+        s.datagramReceiveCalls = m.udp.receiveCalls.load(std::memory_order_relaxed);
+        s.datagramsLost        = m.udp.datagramsLost.load(std::memory_order_relaxed);
+        s.datagramsDropped     = m.udp.datagramsDropped.load(std::memory_order_relaxed);
+        s.kernelToUserCount    = m.wire.kernelToUser.count();
+        s.kernelToUserP50      = m.wire.kernelToUser.percentile(0.50);
+        s.kernelToUserP99      = m.wire.kernelToUser.percentile(0.99);
+        s.kernelToOrderCount   = m.wire.kernelToOrder.count();
+        s.kernelToOrderP50     = m.wire.kernelToOrder.percentile(0.50);
+        s.kernelToOrderP99     = m.wire.kernelToOrder.percentile(0.99);
+        s.unstampedReads       = m.wire.unstampedReads.load(std::memory_order_relaxed);
         return s;
     }
 
@@ -204,37 +473,104 @@ struct MetricsSnapshot {
             (unsigned long long)messagesReceived, (unsigned long long)messagesSent,
             (unsigned long long)bytesReceived, (unsigned long long)bytesSent,
             (unsigned long long)ordersPlaced, (unsigned long long)tradesProcessed, (unsigned long long)quotesProcessed);
+        if (peakMessagesPerSecond) std::printf("Peak messages/s: %llu\n", (unsigned long long)peakMessagesPerSecond);
         if (latencyCount) {
             double avg = (double)totalLatency / (double)latencyCount;
             std::printf("Latency ns min/avg/max: %llu/%.0f/%llu  samples=%llu\n",
                 (unsigned long long)minLatency, avg, (unsigned long long)maxLatency, (unsigned long long)latencyCount);
         }
-        std::printf("Drops=%llu Resync=%llu ConnErr=%llu QHighWater=%llu\n",
+        std::printf("Drops=%llu Resync=%llu ResyncBytes=%llu ConnErr=%llu QHighWater=%llu\n",
             (unsigned long long)messagesDropped, (unsigned long long)resyncEvents,
+            (unsigned long long)resyncBytesDiscarded,
             (unsigned long long)connectionErrors, (unsigned long long)queueHighWater);
+        if (flushSyscalls) {
+            double avgDelay = batchesFlushed ? (double)batchDelayTotalNanos / (double)batchesFlushed : 0.0;
+            std::printf("Order flush: orders/syscall=%.2f syscalls=%llu batch delay ns avg/max: %.0f/%llu budget flushes=%llu\n",
+                ordersPerSyscall(), (unsigned long long)flushSyscalls, avgDelay,
+                (unsigned long long)batchDelayMaxNanos, (unsigned long long)budgetFlushes);
+        }
+        if (messagesFiltered || quotesConflated || lineDuplicates || ringOverruns) {
+            std::printf("Feed: filtered=%llu conflated quotes=%llu line duplicates=%llu ring overruns=%llu\n",
+                (unsigned long long)messagesFiltered, (unsigned long long)quotesConflated,
+                (unsigned long long)lineDuplicates, (unsigned long long)ringOverruns);
+        }
+        if (datagramsReceived) {
+            std::printf("UDP: datagrams=%llu per syscall=%.1f lost=%llu dropped=%llu\n",
+                (unsigned long long)datagramsReceived,
+                datagramReceiveCalls ? (double)datagramsReceived / (double)datagramReceiveCalls : 0.0,
+                (unsigned long long)datagramsLost, (unsigned long long)datagramsDropped);
+        }
+        if (kernelToUserCount || unstampedReads) {
+            std::printf("Kernel->user ns p50/p99 <=: %llu/%llu (%llu reads, %llu unstamped)\n",
+                (unsigned long long)kernelToUserP50, (unsigned long long)kernelToUserP99,
+                (unsigned long long)kernelToUserCount, (unsigned long long)unstampedReads);
+        }
+        if (kernelToOrderCount) {
+            std::printf("Kernel->order ns p50/p99 <=: %llu/%llu (%llu orders)\n",
+                (unsigned long long)kernelToOrderP50, (unsigned long long)kernelToOrderP99,
+                (unsigned long long)kernelToOrderCount);
+        }
+        if (batchesDispatched) {
+            std::printf("Feed batches: %llu  frames/batch=%.1f\n", (unsigned long long)batchesDispatched,
+                (double)(quotesProcessed + tradesProcessed) / (double)batchesDispatched);
+        }
     }
 };
 
-static_assert(sizeof(HotMetrics) == CACHE_LINE_SIZE, 
-              "HotMetrics must be exactly one cache line");
+static_assert(sizeof(HotCounters) == CACHE_LINE_SIZE, 
+              "HotCounters must be exactly one cache line");
 static_assert(sizeof(ColdMetrics) == CACHE_LINE_SIZE, "ColdMetrics must be exactly one cache line");
-static_assert(alignof(HotMetrics) == CACHE_LINE_SIZE, 
-              "HotMetrics must be cache-line aligned");
+static_assert(alignof(HotCounters) == CACHE_LINE_SIZE, 
+              "HotCounters must be cache-line aligned");
 static_assert(alignof(ColdMetrics) == CACHE_LINE_SIZE, 
               "ColdMetrics must be cache-line aligned");
 static_assert(alignof(PerformanceMetrics) == CACHE_LINE_SIZE, "PerformanceMetrics must be cache-line aligned");
+static_assert(sizeof(BatchMetrics) == CACHE_LINE_SIZE, "BatchMetrics must be exactly one cache line");
+static_assert(sizeof(FeedMetrics) == CACHE_LINE_SIZE, "FeedMetrics must be exactly one cache line");
+static_assert(sizeof(UdpMetrics) == CACHE_LINE_SIZE, "UdpMetrics must be exactly one cache line");
+
+// The calling thread's HotCounters in g_systemMetrics.hot, attached on
+// first use and detached when the thread exits.
+extern thread_local HotCounters* t_hotCounters;
+HotCounters& attachHotCounters() noexcept;
+
+inline HotCounters& localHotCounters() noexcept {
+    HotCounters* counters = t_hotCounters;
+    return counters ? *counters : attachHotCounters();
+}
 
 struct MetricsView {
     SystemMetrics* sys;
     explicit MetricsView(SystemMetrics* s) : sys(s) {}
-    inline void incMessagesReceived() noexcept { sys->hot.messagesReceived.fetch_add(1, std::memory_order_relaxed); }
-    inline void incMessagesSent() noexcept { sys->hot.messagesSent.fetch_add(1, std::memory_order_relaxed); }
-    inline void addBytesReceived(uint64_t n) noexcept { sys->hot.bytesReceived.fetch_add(n, std::memory_order_relaxed); }
-    inline void addBytesSent(uint64_t n) noexcept { sys->hot.bytesSent.fetch_add(n, std::memory_order_relaxed); }
-    inline void incOrdersPlaced() noexcept { sys->hot.ordersPlaced.fetch_add(1, std::memory_order_relaxed); }
-    inline void incTradesProcessed() noexcept { sys->hot.tradesProcessed.fetch_add(1, std::memory_order_relaxed); }
-    inline void incQuotesProcessed() noexcept { sys->hot.quotesProcessed.fetch_add(1, std::memory_order_relaxed); }
+    inline void incMessagesReceived() noexcept { localHotCounters().messagesReceived.add(1); }
+    inline void incMessagesSent() noexcept { localHotCounters().messagesSent.add(1); }
+    inline void addBytesReceived(uint64_t n) noexcept { localHotCounters().bytesReceived.add(n); }
+    inline void addBytesSent(uint64_t n) noexcept { localHotCounters().bytesSent.add(n); }
+    inline void incOrdersPlaced() noexcept { localHotCounters().ordersPlaced.add(1); }
+    inline void incTradesProcessed() noexcept { localHotCounters().tradesProcessed.add(1); }
+    inline void incQuotesProcessed() noexcept { localHotCounters().quotesProcessed.add(1); }
     inline void incResyncEvents() noexcept { sys->perf.resyncEvents.fetch_add(1, std::memory_order_relaxed); }
+    inline void recordOrderFlush(uint64_t orders) noexcept {
+        sys->batch.flushSyscalls.fetch_add(1, std::memory_order_relaxed);
+        sys->batch.ordersFlushed.fetch_add(orders, std::memory_order_relaxed);
+    }
+    inline void recordBatchDelay(uint64_t nanos) noexcept {
+        auto& b = sys->batch;
+        b.batchesFlushed.fetch_add(1, std::memory_order_relaxed);
+        b.batchDelayTotalNanos.fetch_add(nanos, std::memory_order_relaxed);
+        uint64_t curMax = b.batchDelayMaxNanos.load(std::memory_order_relaxed);
+        while (nanos > curMax && !b.batchDelayMaxNanos.compare_exchange_weak(curMax, nanos, std::memory_order_relaxed)) {}
+    }
+    // kernelNanos is a CLOCK_REALTIME receive timestamp; 0 means unknown.
+    inline void recordKernelToUser(uint64_t kernelNanos, uint64_t nowNanos) noexcept {
+        if (kernelNanos == 0) { sys->wire.unstampedReads.fetch_add(1, std::memory_order_relaxed); return; }
+        sys->wire.kernelToUser.record(nowNanos > kernelNanos ? nowNanos - kernelNanos : 0);
+    }
+    inline void recordKernelToOrder(uint64_t kernelNanos) noexcept {
+        if (kernelNanos == 0) return;
+        uint64_t now = realtimeNanos();
+        sys->wire.kernelToOrder.record(now > kernelNanos ? now - kernelNanos : 0);
+    }
     inline void updateLatency(uint64_t nanos) noexcept {
         auto& perf = sys->perf;
         uint64_t curMin = perf.minLatency.load(std::memory_order_relaxed);
@@ -249,4 +585,8 @@ struct MetricsView {
 extern SystemMetrics g_systemMetrics;
 extern MetricsView g_metricsView;
 
+// Kernel receive timestamp of the market data being dispatched on this
+// thread, or 0 when unknown; set by the market data client around a drain.
+extern thread_local uint64_t g_rxKernelNanos;
+
 #endif // METRICS_H
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef METRICS_HTTP_H
+#define METRICS_HTTP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "event_source.h"
+#include "metrics.h"
+#include "rate_meter.h"
+
+// Minimal HTTP/1.x listener serving GET /metrics in the Prometheus text
+// exposition format. It runs on the event loop as an EventSource: every
+// socket is non-blocking, each connection carries one request and is then
+// closed, and nothing is rendered until a scrape arrives.
+class MetricsHttpServer final : public EventSource {
+public:
+    static constexpr size_t MAX_CLIENTS = 8;
+    static constexpr size_t MAX_REQUEST_BYTES = 4096;
+    static constexpr uint64_t CLIENT_TIMEOUT_NANOS = 2'000'000'000ULL;
+
+    // meter may be null; its rates are exported when given.
+    explicit MetricsHttpServer(const RateMeter* meter = nullptr) noexcept;
+    ~MetricsHttpServer() override;
+
+    MetricsHttpServer(const MetricsHttpServer&) = delete;
+    MetricsHttpServer& operator=(const MetricsHttpServer&) = delete;
+
+    // Port 0 picks a free port; see port().
+    bool listen(uint16_t port, const char* address = "127.0.0.1");
+    void close() noexcept;
+    bool isListening() const noexcept { return listenFd >= 0; }
+    uint16_t port() const noexcept { return boundPort; }
+
+    void watch(fd_set& readSet, fd_set& writeSet, int& maxFd) override;
+    void service(const fd_set& readSet, const fd_set& writeSet) override;
+
+    // The exposition body for the given metrics and optional rates.
+    static std::string render(const SystemMetrics& metrics, const RateMeter::Report* rates);
+
+private:
+    struct Client {
+        int fd;
+        uint64_t openedNanos;
+        std::string request;
+        std::string response;
+        size_t sent;
+    };
+
+    int listenFd;
+    uint16_t boundPort;
+    const RateMeter* meter;
+    std::vector<Client> clients;
+
+    void acceptClients();
+    // False once the client is finished with or failed.
+    bool readRequest(Client& client);
+    bool writeResponse(Client& client);
+    std::string respond(const std::string& request) const;
+};
+
+#endif // METRICS_HTTP_H
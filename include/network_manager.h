@@ -5,53 +5,207 @@
 #include <algorithm>
 #include <memory>
 #include <chrono>
+#include <vector>
 #include <sys/select.h>
 #include <errno.h>
 #include <cstring>
+#include <iostream>
 #include "config.h"
 #include "message.h"
+#include "market_data_client.h"
+#include "line_arbiter.h"
+#include "runtime_config.h"
+#include "event_source.h"
 
-class MarketDataClient;
 class OrderClient;
+class OrderTemplate;
+
+// Connection management, reconnects and order flushing; independent of the
+// market data handler type.
+class NetworkManagerBase {
+protected:
+    struct MarketLine {
+        MarketDataClientBase* client;
+        uint64_t reconnectDelay;
+        std::chrono::steady_clock::time_point lastReconnect;
+    };
 
-class NetworkManager final {
-private:
-    std::unique_ptr<MarketDataClient> marketClient;
     std::unique_ptr<OrderClient> orderClient;
+    std::vector<MarketLine> marketLines;
+    std::unique_ptr<LineArbiter> arbiter;
+    std::vector<EventSource*> eventSources;
+    SymbolFilter subscriptions;
     bool running;
 
-    uint64_t marketReconnectDelay;
     uint64_t orderReconnectDelay;
-    std::chrono::steady_clock::time_point lastMarketReconnect;
     std::chrono::steady_clock::time_point lastOrderReconnect;
 
+    NetworkManagerBase();
+    ~NetworkManagerBase();
+
+    // Succeeds when the order client and at least one market data line
+    // connect; lines that are down keep retrying in the background.
+    bool connectClients(const std::vector<MarketDataClientBase*>& markets, const Config& config);
+    // Primary endpoint from the command line followed by VWAP_MD_LINES.
+    static std::vector<FeedEndpoint> marketEndpoints(const Config& config);
+
+    // Runs reconnects and select(). Returns false when there is nothing to
+    // dispatch this cycle.
+    bool waitForEvents(fd_set& readSet, fd_set& writeSet);
+    bool marketReadable(const fd_set& readSet, size_t line) const noexcept;
+    void serviceOrders(const fd_set& readSet, const fd_set& writeSet);
+    void serviceEventSources(const fd_set& readSet, const fd_set& writeSet);
+    void handlePeriodicTasks();
+    // Reconnects never block the loop: an in-progress connect is waited on
+    // for writability by select() and finished by completePendingConnects().
+    void tryReconnectMarket(size_t line);
+    void tryReconnectOrder();
+    void completePendingConnects(const fd_set& writeSet);
+    void marketReconnected(size_t line);
+    void marketReconnectFailed(size_t line);
+    void orderReconnected();
+    void orderReconnectFailed();
+
+public:
+    NetworkManagerBase(const NetworkManagerBase&) = delete;
+    NetworkManagerBase& operator=(const NetworkManagerBase&) = delete;
+    NetworkManagerBase(NetworkManagerBase&&) = default;
+    NetworkManagerBase& operator=(NetworkManagerBase&&) = default;
+
+    void stop();
+
+    // Serviced on every cycle after market data and orders; not owned.
+    void addEventSource(EventSource* source) { eventSources.push_back(source); }
+
+    // Restricts market data delivery to the given symbols; see SymbolFilter.
+    bool subscribe(const std::string& symbol);
+
+    bool sendOrder(const OrderMessage& order);
+    bool sendOrder(OrderTemplate& tmpl, uint64_t timestamp, uint32_t quantity, int32_t price);
+
+    TcpClient::ConnectionState marketLineState(size_t line) const noexcept { return marketLines[line].client->getState(); }
+
+    // Null unless more than one market data line is configured.
+    const LineArbiter* getArbiter() const noexcept { return arbiter.get(); }
+    // Maps every receive buffer and the order send queue.
+    void prefault() noexcept;
+};
+
+// Handler for one of several redundant market data lines. Only the first
+// copy of each message across all lines reaches the real handler.
+template<typename Handler>
+struct ArbitratedLine {
+    LineArbiter* arbiter;
+    Handler* handler;
+    size_t line;
+
+    static inline uint64_t steadyNanos() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void onQuote(const QuoteView& quote) {
+        if (arbiter->admit(line, MessageHeader::QUOTE_TYPE, quote.data(), WireFormat::QUOTE_SIZE, steadyNanos()) &&
+            handler) {
+            HandlerDispatch::quote(*handler, quote, HandlerDispatch::TakesQuoteView<Handler>{});
+        }
+    }
+    void onTrade(const TradeView& trade) {
+        if (arbiter->admit(line, MessageHeader::TRADE_TYPE, trade.data(), WireFormat::TRADE_SIZE, steadyNanos()) &&
+            handler) {
+            HandlerDispatch::trade(*handler, trade, HandlerDispatch::TakesTradeView<Handler>{});
+        }
+    }
+};
+
+// Event loop statically bound to a handler with onQuote/onTrade members.
+template<typename Handler>
+class BasicNetworkManager : public NetworkManagerBase {
+private:
+    using LineClient = BasicMarketDataClient<ArbitratedLine<Handler>>;
+
+    std::unique_ptr<BasicMarketDataClient<Handler>> marketClient;
+    std::vector<std::unique_ptr<ArbitratedLine<Handler>>> taps;
+    std::vector<std::unique_ptr<LineClient>> lines;
+    Handler* handler;
+
+public:
+    explicit BasicNetworkManager(Handler* h = nullptr) : handler(h) {}
+    ~BasicNetworkManager() { stop(); }
+
+    BasicNetworkManager(BasicNetworkManager&&) = default;
+    BasicNetworkManager& operator=(BasicNetworkManager&&) = default;
+
+    void setHandler(Handler* h) noexcept {
+        handler = h;
+        if (marketClient) marketClient->setHandler(h);
+        for (auto& tap : taps) tap->handler = h;
+    }
+
+    bool initialize(const Config& config) {
+        std::vector<FeedEndpoint> endpoints = marketEndpoints(config);
+        std::vector<MarketDataClientBase*> markets;
+        if (endpoints.size() == 1) {
+            marketClient = std::make_unique<BasicMarketDataClient<Handler>>(
+                endpoints[0].host, endpoints[0].port, handler);
+            if (!marketClient->setBatchMode(runtimeConfig().batchDispatch)) {
+                std::cerr << "Batch dispatch unavailable for this handler, using per-frame dispatch" << std::endl;
+            }
+            markets.push_back(marketClient.get());
+        } else {
+            if (runtimeConfig().batchDispatch) {
+                std::cerr << "Batch dispatch is not used with redundant feed lines" << std::endl;
+            }
+            arbiter = std::make_unique<LineArbiter>(endpoints.size());
+            for (size_t i = 0; i < endpoints.size(); ++i) {
+                taps.push_back(std::unique_ptr<ArbitratedLine<Handler>>(
+                    new ArbitratedLine<Handler>{arbiter.get(), handler, i}));
+                lines.push_back(std::make_unique<LineClient>(endpoints[i].host, endpoints[i].port, taps.back().get()));
+                markets.push_back(lines.back().get());
+            }
+        }
+        return connectClients(markets, config);
+    }
+
+    void processEvents() {
+        if (!running) return;
+        fd_set readSet, writeSet;
+        if (!waitForEvents(readSet, writeSet)) return;
+
+        if (marketClient) {
+            if (marketReadable(readSet, 0)) marketClient->processIncomingData();
+        } else {
+            for (size_t i = 0; i < lines.size(); ++i) {
+                if (marketReadable(readSet, i)) lines[i]->processIncomingData();
+            }
+        }
+        serviceOrders(readSet, writeSet);
+        serviceEventSources(readSet, writeSet);
+        handlePeriodicTasks();
+    }
+};
+
+// Adapter that keeps the std::function quote/trade callback API available.
+struct QuoteTradeCallbackAdapter {
     std::function<void(const QuoteMessage&)> quoteCallback;
     std::function<void(const TradeMessage&)> tradeCallback;
 
+    void onQuote(const QuoteMessage& quote) { if (quoteCallback) quoteCallback(quote); }
+    void onTrade(const TradeMessage& trade) { if (tradeCallback) tradeCallback(trade); }
+};
+
+class NetworkManager final : public BasicNetworkManager<QuoteTradeCallbackAdapter> {
+private:
+    std::unique_ptr<QuoteTradeCallbackAdapter> callbacks;
+
 public:
     NetworkManager();
-    ~NetworkManager();
-
-    NetworkManager(const NetworkManager&) = delete;
-    NetworkManager& operator=(const NetworkManager&) = delete;
 
     NetworkManager(NetworkManager&&) = default;
     NetworkManager& operator=(NetworkManager&&) = default;
 
-    bool initialize(const Config& config);
-    void processEvents();
-    void stop();
-
     void setQuoteCallback(std::function<void(const QuoteMessage&)> cb);
     void setTradeCallback(std::function<void(const TradeMessage&)> cb);
-
-    bool sendOrder(const OrderMessage& order);
-
-private:
-    void handleMarketData(const MessageHeader& header, const void* data);
-    void handlePeriodicTasks();
-    void tryReconnectMarket();
-    void tryReconnectOrder();
 };
 
 #endif
@@ -5,12 +5,22 @@
 #include "message.h"
 #include "wire_format.h"
 #include "metrics.h"
+#include "spsc_ring.h"
+#include "realtime.h"
+#include "order_template.h"
 #include <array>
-#include <mutex>
+#include <atomic>
+#include <cstring>
 
+// Threading: sendOrder(), flush() and processSendQueue() belong to the
+// event-loop thread, which alone touches the backlog of bytes waiting for the
+// socket. queueOrder() may be called from one strategy thread: it is the only
+// producer of the inbox ring and wakes the event loop through wakeFd(), whose
+// next send moves the inbox onto the backlog.
 class OrderClient : public TcpClient {
 private:
-    static constexpr size_t MAX_QUEUE_DEPTH = 1000;
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+    static constexpr size_t MAX_GATHER = 64;
 
     struct PendingSend {
         std::array<uint8_t, WireFormat::ORDER_SIZE> data;
@@ -18,32 +28,77 @@ private:
         size_t offset;
     };
 
-    static constexpr size_t QUEUE_CAPACITY = MAX_QUEUE_DEPTH;
-    PendingSend queue[QUEUE_CAPACITY];
-    size_t qHead{0};
-    size_t qTail{0};
-    size_t qSize{0};
-    std::mutex queueMutex;
-
-    bool enqueue(const PendingSend& ps) noexcept {
-        if (qSize == QUEUE_CAPACITY) return false;
-        queue[qTail] = ps;
-        qTail = (qTail + 1) % QUEUE_CAPACITY;
-        ++qSize;
-        if (qSize > g_systemMetrics.cold.queueHighWater.load(std::memory_order_relaxed)) {
-            g_systemMetrics.cold.queueHighWater.store(qSize, std::memory_order_relaxed);
+    SpscRing<PendingSend, QUEUE_CAPACITY> inbox;
+    std::array<PendingSend, QUEUE_CAPACITY> backlog;
+    size_t backlogHead{0};
+    size_t backlogTail{0};
+    OrderTemplate cachedTemplate;
+
+    // Self-pipe raised by queueOrder(); wakePending keeps it to one byte
+    // until the event loop collects.
+    int wakeRead{-1};
+    int wakeWrite{-1};
+    std::atomic<bool> wakePending{false};
+
+    bool coalesce{false};
+    uint64_t coalesceBudgetNanos{0};
+    uint64_t batchStartNanos{0};
+    size_t batchOrders{0};
+    // Kernel receive timestamp behind the oldest staged order, 0 if unknown.
+    uint64_t batchRxKernelNanos{0};
+
+    size_t backlogSize() const noexcept { return backlogTail - backlogHead; }
+    PendingSend& backlogAt(size_t i) noexcept { return backlog[(backlogHead + i) % QUEUE_CAPACITY]; }
+
+    bool enqueue(const uint8_t* data, size_t len) noexcept {
+        if (backlogSize() == QUEUE_CAPACITY) return false;
+        PendingSend& ps = backlog[backlogTail % QUEUE_CAPACITY];
+        std::memcpy(ps.data.data(), data, len);
+        ps.length = len;
+        ps.offset = 0;
+        ++backlogTail;
+        size_t depth = backlogSize();
+        if (depth > g_systemMetrics.cold.queueHighWater.load(std::memory_order_relaxed)) {
+            g_systemMetrics.cold.queueHighWater.store(depth, std::memory_order_relaxed);
         }
         return true;
     }
-    PendingSend& front() noexcept { return queue[qHead]; }
-    void popFront() noexcept { if (qSize) { qHead = (qHead + 1) % QUEUE_CAPACITY; --qSize; } }
-    bool empty() const noexcept { return qSize == 0; }
+
+    // Event loop: moves orders from the inbox to the backlog, as far as it has room.
+    void collectQueued() noexcept;
+    // Event loop: discards everything unsent after a fatal send error.
+    void dropPending() noexcept;
+
+    static bool isSendable(const OrderMessage& order) noexcept {
+        return (order.side == 'B' || order.side == 'S') && order.quantity != 0 && order.price > 0;
+    }
+
+    bool transmit(const uint8_t* buffer, size_t size, char side, uint32_t quantity, int32_t price) noexcept;
 
 public:
     OrderClient(const std::string& host, uint16_t port);
+    ~OrderClient();
 
     bool sendOrder(const OrderMessage& order) noexcept;
+    bool sendOrder(OrderTemplate& tmpl, uint64_t timestamp, uint32_t quantity, int32_t price) noexcept;
+    // Strategy thread. False when the inbox is full.
+    bool queueOrder(const OrderMessage& order) noexcept;
+    // Readable once queueOrder() has added orders the event loop has not collected.
+    int wakeFd() const noexcept { return wakeRead; }
     void processSendQueue() noexcept;
+
+    // Coalescing mode: orders are staged and written with one gather write
+    // when flush() runs at the end of the event-loop cycle, or immediately
+    // once the oldest staged order has waited longer than budgetNanos.
+    void setCoalescing(bool enabled, uint64_t budgetNanos) noexcept;
+    bool isCoalescing() const noexcept { return coalesce; }
+    void flush() noexcept;
+    bool hasPendingSends() const noexcept { return backlogSize() != 0 || !inbox.empty(); }
+    size_t pendingSends() const noexcept { return backlogSize() + inbox.size(); }
+    void prefault() noexcept {
+        inbox.prefault();
+        Realtime::prefault(backlog.data(), sizeof(backlog));
+    }
 };
 
 #endif
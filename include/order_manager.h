@@ -7,10 +7,12 @@
 #include <cstdint>
 #include <functional>
 #include "message.h"
+#include "message_view.h"
 #include "optional.h"
 #include "vwap_calculator.h"
 #include "decision_engine.h"
 #include "circular_buffer.h"
+#include "order_template.h"
 
 class OrderManager final {
 public:
@@ -40,18 +42,21 @@ private:
     std::unique_ptr<VwapCalculator> vwapCalculator;
     std::unique_ptr<DecisionEngine> decisionEngine;
     std::function<void(const OrderMessage&)> orderCallback;
+    OrderTemplate orderTemplate;
 
     uint64_t totalQuotesProcessed;
     uint64_t totalTradesProcessed;
     uint64_t totalOrdersSent;
     bool vwapWindowCompleteNotified;
+    bool announce;
 
     static constexpr size_t MAX_ORDER_HISTORY = 1000;
     CircularBuffer<OrderRecord, MAX_ORDER_HISTORY> orderHistory;
 
 public:
+    // announce=false keeps a scratch manager (warmup) off stdout.
     OrderManager(const std::string& symbol, char side,
-                uint32_t maxOrderSize, uint32_t vwapWindowSeconds);
+                uint32_t maxOrderSize, uint32_t vwapWindowSeconds, bool announce = true);
     ~OrderManager();
 
     OrderManager(const OrderManager&) = delete;
@@ -61,18 +66,27 @@ public:
     OrderManager& operator=(OrderManager&&) = default;
 
     Optional<OrderMessage> processQuote(const QuoteMessage& quote);
+    // Reads the traded side straight off the wire body.
+    Optional<OrderMessage> processQuote(const QuoteView& quote);
     void processTrade(const TradeMessage& trade);
+    // Same as count processTrade calls on consecutive trades, given as columns.
+    void processTrades(const uint64_t* timestamps, const uint32_t* quantities,
+                       const int32_t* prices, size_t count);
     void setOrderCallback(std::function<void(const OrderMessage&)> cb) { orderCallback = std::move(cb); }
 
     void printStatistics() const;
+    void prefault() noexcept;
     void printOrderHistory() const;
     void printOrderHistory(size_t count) const;
     State getState() const noexcept { return currentState; }
     bool isReadyToTrade() const noexcept { return currentState == State::READY_TO_TRADE; }
+    // Hot thread only; see vwapSnapshot() for other threads.
     double getCurrentVwap() const { return vwapCalculator->getCurrentVwap(); }
+    VwapSnapshot vwapSnapshot() const noexcept { return vwapCalculator->readSnapshot(); }
     uint64_t getQuoteCount() const noexcept { return totalQuotesProcessed; }
     uint64_t getTradeCount() const noexcept { return totalTradesProcessed; }
     uint64_t getOrderCount() const noexcept { return totalOrdersSent; }
+    OrderTemplate& getOrderTemplate() noexcept { return orderTemplate; }
 
     std::vector<OrderRecord> getOrderHistory() const {
         std::vector<OrderRecord> history;
@@ -85,7 +99,8 @@ public:
 private:
     void checkVwapWindowComplete();
     void recordOrder(const OrderMessage& order, const std::string& reason);
-    std::string buildReason(const QuoteMessage& q, int32_t vwapCents) const;
+    Optional<OrderMessage> processQuote(uint64_t timestamp, int32_t price, uint32_t quantity);
+    std::string buildReason(int32_t price, int32_t vwapCents) const;
 };
 
 #endif
@@ -0,0 +1,54 @@
+#ifndef ORDER_TEMPLATE_H
+#define ORDER_TEMPLATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "wire_format.h"
+#include "message_schema.h"
+
+// Pre-serialized order image laid out by OrderSchema. Symbol and side are
+// written once at construction; each send only patches timestamp, quantity
+// and price, all through the schema's setters.
+class OrderTemplate final {
+private:
+    alignas(32) uint8_t wire[OrderSchema::size];
+    char side;
+
+public:
+    OrderTemplate() noexcept : side('\0') { std::memset(wire, 0, sizeof(wire)); }
+
+    OrderTemplate(const char* symbol, size_t symbolLen, char orderSide) noexcept : side(orderSide) {
+        std::memset(wire, 0, sizeof(wire));
+        constexpr size_t width = sizeof(OrderMessage::symbol);
+        std::memcpy(wire + OrderSchema::offset<OrderFields::Symbol>(), symbol, symbolLen < width ? symbolLen : width);
+        OrderSchema::set<OrderFields::Side>(wire, orderSide);
+    }
+
+    bool valid() const noexcept { return side == 'B' || side == 'S'; }
+    char getSide() const noexcept { return side; }
+
+    bool matches(const char* symbol8, char orderSide) const noexcept {
+        return side == orderSide &&
+               std::memcmp(OrderSchema::get<OrderFields::Symbol>(wire), symbol8, 8) == 0;
+    }
+
+    inline const uint8_t* patch(uint64_t timestamp, uint32_t quantity, int32_t price) noexcept {
+        OrderSchema::set<OrderFields::Timestamp>(wire, timestamp);
+        OrderSchema::set<OrderFields::Quantity>(wire, quantity);
+        OrderSchema::set<OrderFields::Price>(wire, price);
+        return wire;
+    }
+
+    const uint8_t* data() const noexcept { return wire; }
+    static constexpr size_t size() noexcept { return OrderSchema::size; }
+};
+
+// patch() takes exactly the schema's field types, so a schema change cannot
+// narrow or widen a patched field behind the send path's back.
+static_assert(std::is_same<OrderFields::Timestamp::codec::value_type, uint64_t>::value, "Order template timestamp type");
+static_assert(std::is_same<OrderFields::Quantity::codec::value_type, uint32_t>::value, "Order template quantity type");
+static_assert(std::is_same<OrderFields::Price::codec::value_type, int32_t>::value, "Order template price type");
+
+#endif // ORDER_TEMPLATE_H
@@ -0,0 +1,53 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Hardware performance counters for the calling thread, opened as one
+// perf_event_open group so every event covers the same instructions. Events
+// the PMU lacks are left out of the group; when the group cannot be opened
+// at all (perf_event_paranoid, no PMU in a VM, not Linux) open() fails with
+// a reason and callers carry on without counters.
+class PerfCounters {
+public:
+    enum Event : size_t { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, EVENT_COUNT };
+
+    struct Reading {
+        uint64_t values[EVENT_COUNT];
+        bool counted[EVENT_COUNT];
+        // Share of the interval the group was on the PMU; below 1 the values
+        // are scaled up from a multiplexed sample.
+        double coverage;
+
+        bool valid() const noexcept { return coverage > 0; }
+    };
+
+    PerfCounters() noexcept;
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool open();
+    void close() noexcept;
+    bool isOpen() const noexcept { return leaderFd >= 0; }
+    const std::string& unavailableReason() const noexcept { return reason; }
+
+    // Resets and enables the group; stop() disables it and reads it back.
+    void start() noexcept;
+    Reading stop() noexcept;
+
+    static const char* eventName(Event event) noexcept;
+
+private:
+    int leaderFd;
+    int fds[EVENT_COUNT];
+    // Position of each event in the group read, or -1 when not counted.
+    int slot[EVENT_COUNT];
+    size_t members;
+    std::string reason;
+};
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,57 @@
+#ifndef QUOTE_CONFLATOR_H
+#define QUOTE_CONFLATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "wire_format.h"
+#include "message_view.h"
+#include "symbol_filter.h"
+
+// Holds the newest quote body per symbol until the end of a drain. A later
+// quote for the same symbol overwrites the held one in place.
+class QuoteConflator final {
+public:
+    static constexpr size_t MAX_SYMBOLS = 64;
+
+    enum class HoldResult { HELD, REPLACED, FULL };
+
+private:
+    struct Slot {
+        uint64_t symbol;
+        uint8_t body[WireFormat::QUOTE_SIZE];
+    };
+    Slot slots[MAX_SYMBOLS];
+    size_t count;
+
+public:
+    QuoteConflator() noexcept : count(0) {}
+
+    bool empty() const noexcept { return count == 0; }
+    size_t size() const noexcept { return count; }
+
+    // FULL means nothing was held; release() the current quotes and retry.
+    inline HoldResult hold(const uint8_t* body) noexcept {
+        uint64_t symbol = SymbolFilter::load(body);
+        for (size_t i = 0; i < count; ++i) {
+            if (slots[i].symbol == symbol) {
+                std::memcpy(slots[i].body, body, WireFormat::QUOTE_SIZE);
+                return HoldResult::REPLACED;
+            }
+        }
+        if (count == MAX_SYMBOLS) return HoldResult::FULL;
+        slots[count].symbol = symbol;
+        std::memcpy(slots[count].body, body, WireFormat::QUOTE_SIZE);
+        ++count;
+        return HoldResult::HELD;
+    }
+
+    // Hands every held quote to fn(const QuoteView&) in first-seen symbol order.
+    template<typename Fn>
+    void release(Fn&& fn) {
+        for (size_t i = 0; i < count; ++i) fn(QuoteView(slots[i].body));
+        count = 0;
+    }
+};
+
+#endif // QUOTE_CONFLATOR_H
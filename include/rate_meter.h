@@ -0,0 +1,64 @@
+#ifndef RATE_METER_H
+#define RATE_METER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "metrics.h"
+
+// Rolling per-second rates of market data messages, bytes (in and out) and
+// orders over the last minute. It samples the cumulative hot counters at most
+// once a second, so the hot path pays nothing beyond its counter increments
+// and poll() is a single comparison between samples. Owned by one thread.
+class RateMeter final {
+public:
+    static constexpr size_t SECONDS = 60;
+    static constexpr uint64_t NANOS_PER_SECOND = 1'000'000'000ULL;
+
+    struct Rates {
+        double last = 0;       // most recent second
+        double avg10 = 0;      // mean of the last 10 seconds
+        double avg60 = 0;      // mean of the last 60 seconds
+        double peak = 0;       // highest single second since start
+    };
+
+    struct Report {
+        Rates messages;
+        Rates bytes;
+        Rates orders;
+        uint64_t seconds = 0;  // seconds covered so far, at most SECONDS
+
+        void print() const;
+    };
+
+    RateMeter() noexcept;
+
+    // Call as often as convenient; samples g_systemMetrics once a second.
+    inline void poll(uint64_t nowNanos) noexcept {
+        if (nowNanos - lastNanos >= NANOS_PER_SECOND) sample(nowNanos, g_systemMetrics.hot.total());
+    }
+
+    // Records the totals at nowNanos. The first call only sets the baseline;
+    // a gap of several seconds fills each of them with the gap's mean rate.
+    void sample(uint64_t nowNanos, const HotCounters::Totals& totals) noexcept;
+
+    Report report() const noexcept;
+    void print() const { report().print(); }
+
+private:
+    struct Second {
+        double messages;
+        double bytes;
+        double orders;
+    };
+
+    Second history[SECONDS];
+    size_t next;
+    uint64_t filled;
+    uint64_t lastNanos;
+    HotCounters::Totals lastTotals;
+    Second peak;
+
+    Rates rates(double Second::*field) const noexcept;
+};
+
+#endif // RATE_METER_H
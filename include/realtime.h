@@ -0,0 +1,34 @@
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <pthread.h>
+#include <unistd.h>
+
+// Thread placement and memory residency for the trading threads. Every call
+// is best effort: failures are reported and trading continues unpinned.
+namespace Realtime {
+    // Restricts thread to one CPU. False when the CPU does not exist or the
+    // call is refused.
+    bool pinThread(pthread_t thread, int cpu) noexcept;
+    // SCHED_FIFO at priority (1-99). Needs CAP_SYS_NICE or an RLIMIT_RTPRIO
+    // allowance; false otherwise.
+    bool setFifoPriority(pthread_t thread, int priority) noexcept;
+    // mlockall(MCL_CURRENT | MCL_FUTURE).
+    bool lockMemory() noexcept;
+    // Prints the thread's allowed CPUs and scheduling policy.
+    void reportThread(const char* name, pthread_t thread);
+
+    // Writes one byte per page of [data, data + bytes) back to itself so
+    // every page is mapped and private before the hot path first touches
+    // it. Only for memory no other thread is using yet.
+    inline void prefault(void* data, size_t bytes) noexcept {
+        static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
+        for (size_t i = 0; i < bytes; i += page) p[i] = p[i];
+        if (bytes) p[bytes - 1] = p[bytes - 1];
+    }
+}
+
+#endif // REALTIME_H
@@ -0,0 +1,71 @@
+#ifndef RUNTIME_CONFIG_H
+#define RUNTIME_CONFIG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "socket_tuning.h"
+
+struct FeedEndpoint {
+    std::string host;
+    uint16_t port;
+};
+
+// Optional tuning knobs, read from VWAP_* environment variables so the
+// positional command line stays unchanged.
+struct RuntimeConfig {
+    bool coalesceOrders;
+    uint64_t coalesceBudgetNanos;
+    std::string logFile;
+    bool batchDispatch;
+    bool conflateQuotes;
+    // Redundant market data lines carrying the same stream as the primary
+    // one, arbitrated first-copy-wins.
+    std::vector<FeedEndpoint> extraMarketDataLines;
+    // Market data over UDP datagrams instead of TCP; the market data
+    // host:port then names the local (or multicast) address to receive on.
+    bool marketDataUdp;
+    // Kernel software receive timestamps on TCP market data, feeding the
+    // kernel-to-user and kernel-to-order latency histograms.
+    bool rxTimestamps;
+    // Socket option profiles for the TCP market data and order connections.
+    SocketTuning marketDataSocket;
+    SocketTuning orderSocket;
+    // CPUs for the event loop and async logger threads; -1 leaves them to
+    // the scheduler.
+    int eventLoopCpu;
+    int loggerCpu;
+    // SCHED_FIFO priority for the event loop thread; 0 keeps SCHED_OTHER.
+    int fifoPriority;
+    bool lockMemory;
+    // Touch every page of the receive buffers, VWAP arrays and order queue
+    // before trading starts.
+    bool prefault;
+    // Run synthetic traffic through a scratch pipeline before connecting.
+    bool warmup;
+    // Name of the /dev/shm stats segment read by vwap_stat; empty disables
+    // it. Republished every statsIntervalMicros.
+    std::string statsSegment;
+    uint64_t statsIntervalMicros;
+    // Loopback port serving Prometheus metrics; 0 disables it.
+    uint16_t metricsPort;
+    // Per-message trace file for TRACE=1 builds; empty disables tracing.
+    // With traceOnSignal only the most recent records are kept and written
+    // on SIGUSR2 and at exit.
+    std::string traceFile;
+    bool traceOnSignal;
+
+    RuntimeConfig()
+        : coalesceOrders(false), coalesceBudgetNanos(50'000), batchDispatch(false), conflateQuotes(false),
+          marketDataUdp(false), rxTimestamps(false),
+          marketDataSocket(SocketTuning::standard()), orderSocket(SocketTuning::standard()),
+          eventLoopCpu(-1), loggerCpu(-1), fifoPriority(0), lockMemory(false), prefault(false),
+          warmup(false), statsIntervalMicros(10'000), metricsPort(0), traceOnSignal(false) {}
+
+    void loadFromEnv();
+    void print() const;
+};
+
+RuntimeConfig& runtimeConfig();
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <type_traits>
+#include "metrics.h"
+
+// Single-writer sequence lock around a small trivially copyable value.
+//
+// The writer never waits: it makes the sequence odd, stores the value and
+// makes it even again. A reader copies the value between two loads of the
+// sequence and keeps the copy only if both saw the same even number. The
+// value is held as relaxed atomic words so torn copies are detected rather
+// than being data races.
+template<typename T>
+class Seqlock final {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock values must be trivially copyable");
+
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> words[WORDS];
+
+public:
+    Seqlock() noexcept : sequence(0) {
+        for (size_t i = 0; i < WORDS; ++i) words[i].store(0, std::memory_order_relaxed);
+    }
+    // Takes the current value and version. The source's writer must not
+    // store during the move; its readers may carry on.
+    Seqlock(Seqlock&& other) noexcept : sequence(other.sequence.load(std::memory_order_acquire)) {
+        for (size_t i = 0; i < WORDS; ++i) {
+            words[i].store(other.words[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    // Writer thread only.
+    void store(const T& value) noexcept {
+        uint64_t raw[WORDS] = {};
+        std::memcpy(raw, &value, sizeof(T));
+        const uint64_t s = sequence.load(std::memory_order_relaxed);
+        sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) words[i].store(raw[i], std::memory_order_relaxed);
+        sequence.store(s + 2, std::memory_order_release);
+    }
+
+    // One attempt, wait-free: false when a store was in progress or
+    // completed during the copy, leaving out unspecified.
+    bool tryLoad(T& out) const noexcept {
+        const uint64_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) return false;
+        uint64_t raw[WORDS];
+        for (size_t i = 0; i < WORDS; ++i) raw[i] = words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != before) return false;
+        std::memcpy(&out, raw, sizeof(T));
+        return true;
+    }
+
+    // Retries until a consistent copy is read. Lock-free: only a writer
+    // storing continuously can keep a reader retrying.
+    T load() const noexcept {
+        T out;
+        while (!tryLoad(out)) {}
+        return out;
+    }
+
+    // Number of completed stores.
+    uint64_t version() const noexcept { return sequence.load(std::memory_order_acquire) / 2; }
+};
+
+#endif // SEQLOCK_H
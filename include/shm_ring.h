@@ -0,0 +1,121 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <sys/types.h>
+#include "metrics.h"
+#include "wire_format.h"
+
+// Single-producer/multi-consumer broadcast ring in a /dev/shm file.
+//
+// Every slot carries one whole wire frame. The writer never waits for
+// readers: slot i is published seqlock style by storing an odd sequence,
+// copying the frame and then storing the even sequence 2n for message n.
+// A reader that finds a later sequence than it expects has been lapped; it
+// skips past the overwritten messages and counts them as lost.
+namespace ShmRing {
+    constexpr const char* SCHEME = "shm://";
+    constexpr uint64_t MAGIC = 0x31474E5250415756ULL;  // "VWAPRNG1"
+    constexpr uint32_t VERSION = 1;
+    constexpr size_t DEFAULT_SLOTS = 4096;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint64_t> sequence;
+        uint32_t length;
+        uint8_t data[CACHE_LINE_SIZE - sizeof(uint64_t) - sizeof(uint32_t)];
+    };
+
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t slotSize;
+        std::atomic<uint32_t> writerOpen;
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> writeSequence;
+    };
+
+    static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Ring sequences must be lock-free across processes");
+    static_assert(sizeof(Slot) == CACHE_LINE_SIZE, "One slot per cache line");
+    static_assert(sizeof(Slot::data) >= WireFormat::MAX_MESSAGE_SIZE, "A slot must hold the largest frame");
+
+    inline size_t mappedSize(size_t slotCount) noexcept { return sizeof(Header) + slotCount * sizeof(Slot); }
+
+    // "shm://name" yields name; false for any other address or a name that
+    // is empty or contains '/'.
+    bool parseAddress(const std::string& address, std::string& name);
+    std::string path(const std::string& name);
+}
+
+class ShmRingWriter final {
+private:
+    ShmRing::Header* header;
+    ShmRing::Slot* slots;
+    size_t slotCount;
+    uint64_t sequence;
+
+public:
+    explicit ShmRingWriter(size_t slots = ShmRing::DEFAULT_SLOTS);
+    ~ShmRingWriter();
+
+    ShmRingWriter(const ShmRingWriter&) = delete;
+    ShmRingWriter& operator=(const ShmRingWriter&) = delete;
+
+    // Creates or reuses /dev/shm/<name> and restarts the stream at message
+    // 1; attached readers notice and follow.
+    bool create(const std::string& name);
+    // Marks the ring closed so readers see end of stream. The file is left
+    // in place for the next writer.
+    void close() noexcept;
+    bool isOpen() const noexcept { return header != nullptr; }
+
+    // Publishes one whole frame. Returns false when it does not fit a slot.
+    inline bool publish(const uint8_t* frame, size_t size) noexcept;
+
+    uint64_t published() const noexcept { return sequence; }
+};
+
+class ShmRingReader final {
+private:
+    const ShmRing::Header* header;
+    const ShmRing::Slot* slots;
+    size_t slotCount;
+    size_t mappedBytes;
+    uint64_t next;
+
+public:
+    ShmRingReader() noexcept;
+    ~ShmRingReader();
+
+    ShmRingReader(const ShmRingReader&) = delete;
+    ShmRingReader& operator=(const ShmRingReader&) = delete;
+
+    // Fails unless a writer currently has the ring open. Reading starts with
+    // the next message published.
+    bool open(const std::string& name);
+    void close() noexcept;
+    bool isOpen() const noexcept { return header != nullptr; }
+
+    // Copies whole frames into out. Returns the bytes copied, 0 when nothing
+    // is pending, or -1 once the writer has closed and the ring is drained.
+    // Messages overwritten before they were read are added to lost.
+    ssize_t read(uint8_t* out, size_t maxBytes, uint64_t& lost) noexcept;
+};
+
+inline bool ShmRingWriter::publish(const uint8_t* frame, size_t size) noexcept {
+    if (size > sizeof(ShmRing::Slot::data)) return false;
+    const uint64_t n = ++sequence;
+    ShmRing::Slot& slot = slots[(n - 1) & (slotCount - 1)];
+    slot.sequence.store(2 * n - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.length = static_cast<uint32_t>(size);
+    std::memcpy(slot.data, frame, size);
+    slot.sequence.store(2 * n, std::memory_order_release);
+    header->writeSequence.store(n, std::memory_order_release);
+    return true;
+}
+
+#endif // SHM_RING_H
@@ -10,6 +10,7 @@
 #include <memory>
 #include "message.h"
 #include "csv_reader.h"
+#include "shm_ring.h"
 
 enum class MarketScenario {
     STEADY,
@@ -30,6 +31,18 @@ struct SimulatorConfig {
     std::string csvPath = "";
     double replaySpeed = 1.0;
     bool verbose = false;
+    // Non-zero makes the stream reproducible: prices come from this seed and
+    // timestamps from the message sequence, so instances with the same
+    // options publish identical feeds.
+    uint64_t seed = 0;
+    // "host:port" switches from serving TCP clients to sending UDP
+    // datagrams there, each carrying up to udpFramesPerDatagram frames from
+    // one generation tick.
+    std::string udpTarget = "";
+    int udpFramesPerDatagram = 1;
+    // Non-empty publishes into the shared memory ring /dev/shm/<shmName>
+    // instead of serving TCP clients.
+    std::string shmName = "";
 };
 
 class MarketDataSimulator {
@@ -60,13 +73,26 @@ private:
     double currentAsk;
     uint64_t sequenceNumber;
 
+    std::vector<uint8_t> datagram;
+    int datagramFrames;
+    uint64_t datagramSequence;
+    uint64_t datagramsSent;
+    uint64_t datagramSendFailures;
+    int lastSendError;
+    std::unique_ptr<ShmRingWriter> ringWriter;
+
     void runServer();
     bool setupSocket();
+    bool setupUdpSocket();
+    void sendDatagramFrame(const uint8_t* data, size_t size);
+    // Sends the frames held for the current datagram, if any.
+    void flushDatagram();
     void acceptClients();
     void broadcastMessage(const uint8_t* data, size_t size);
     void handleClient(int clientSocket);
 
     void generateMarketData();
+    void generateMessage();
     void generateSteadyPrices();
     void generateTrendingPrices(bool up);
     void generateVolatilePrices();
@@ -78,6 +104,7 @@ private:
     std::vector<uint8_t> serializeTrade(const TradeMessage& trade);
     double generatePrice(double base, double volatility);
     uint64_t getCurrentTimestamp();
+    uint64_t messageTimestamp();
 
     void cleanup();
 };
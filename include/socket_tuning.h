@@ -0,0 +1,49 @@
+#ifndef SOCKET_TUNING_H
+#define SOCKET_TUNING_H
+
+#include <string>
+
+// Named socket option sets applied per TCP connection. A field left at its
+// "unset" value keeps the kernel default. Every option is read back after
+// it is set, since the kernel may clamp, double or refuse it.
+struct SocketTuning {
+    static constexpr int UNSET = -1;
+
+    std::string name;
+    int receiveBuffer;    // SO_RCVBUF bytes
+    int sendBuffer;       // SO_SNDBUF bytes
+    bool quickAck;        // TCP_QUICKACK, re-armed after every read
+    int receiveLowWater;  // SO_RCVLOWAT bytes
+    int busyPollMicros;   // SO_BUSY_POLL
+    int typeOfService;    // IP_TOS
+    int incomingCpu;      // SO_INCOMING_CPU
+
+    struct Applied {
+        int receiveBuffer = UNSET;
+        int sendBuffer = UNSET;
+        int quickAck = UNSET;
+        int receiveLowWater = UNSET;
+        int busyPollMicros = UNSET;
+        int typeOfService = UNSET;
+        int incomingCpu = UNSET;
+    };
+
+    // The buffers this client always used: 64 KiB receive, 4 KiB send.
+    static SocketTuning standard();
+    // Immediate ACKs, wake on any byte, busy polling and IPTOS_LOWDELAY.
+    static SocketTuning latency();
+    // Large buffers, wake only once a whole frame is queued, IPTOS_THROUGHPUT.
+    static SocketTuning throughput();
+
+    // "latency", "throughput" or "standard", optionally followed by
+    // ",key=value" overrides: rcvbuf, sndbuf, quickack, lowat, busypoll,
+    // tos, cpu. Returns false and leaves out untouched on any bad token.
+    static bool parse(const std::string& spec, SocketTuning& out);
+
+    // Applies every set option to fd and reads each back into applied.
+    // Fails only when the buffer sizes are refused; the rest are best effort.
+    bool apply(int fd, Applied& applied) const noexcept;
+    void print(const char* label, const Applied& applied) const;
+};
+
+#endif // SOCKET_TUNING_H
@@ -0,0 +1,146 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <type_traits>
+#include "metrics.h"
+#include "realtime.h"
+
+// Wait-free single-producer/single-consumer ring.
+//
+// Each side keeps a private cursor plus a cached copy of the other side's
+// published cursor, so the shared atomics are only touched when the cache is
+// exhausted or when a batch is published. Producer: stage()/publish() or
+// tryPush(). Consumer: peek()/pop()/release() or tryPop().
+template<typename T, size_t CAPACITY>
+class SpscRing final {
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SpscRing elements must be trivially copyable");
+
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    struct alignas(CACHE_LINE_SIZE) ProducerSide {
+        std::atomic<size_t> tail{0};
+        size_t localTail{0};
+        size_t cachedHead{0};
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ConsumerSide {
+        std::atomic<size_t> head{0};
+        size_t localHead{0};
+        size_t cachedTail{0};
+    };
+
+    ProducerSide prod;
+    ConsumerSide cons;
+    alignas(CACHE_LINE_SIZE) T slots[CAPACITY];
+
+public:
+    SpscRing() noexcept = default;
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    static constexpr size_t capacity() noexcept { return CAPACITY; }
+
+    // Maps every slot page; call before either side starts.
+    void prefault() noexcept { Realtime::prefault(slots, sizeof(slots)); }
+
+    // Producer: write an element without making it visible to the consumer.
+    bool stage(const T& item) noexcept {
+        if (prod.localTail - prod.cachedHead == CAPACITY) {
+            prod.cachedHead = cons.head.load(std::memory_order_acquire);
+            if (prod.localTail - prod.cachedHead == CAPACITY) return false;
+        }
+        slots[prod.localTail & MASK] = item;
+        ++prod.localTail;
+        return true;
+    }
+
+    // Producer: make every staged element visible with a single release store.
+    void publish() noexcept {
+        prod.tail.store(prod.localTail, std::memory_order_release);
+    }
+
+    bool tryPush(const T& item) noexcept {
+        if (!stage(item)) return false;
+        publish();
+        return true;
+    }
+
+    // Producer: the next free slot, to be filled in place and published
+    // with commit(); nullptr when the ring is full.
+    T* claim() noexcept {
+        if (prod.localTail - prod.cachedHead == CAPACITY) {
+            prod.cachedHead = cons.head.load(std::memory_order_acquire);
+            if (prod.localTail - prod.cachedHead == CAPACITY) return nullptr;
+        }
+        return &slots[prod.localTail & MASK];
+    }
+
+    void commit() noexcept {
+        ++prod.localTail;
+        publish();
+    }
+
+    // Producer-side occupancy estimate (includes staged elements).
+    size_t producerSize() const noexcept {
+        return prod.localTail - cons.head.load(std::memory_order_acquire);
+    }
+
+    // Consumer: oldest unconsumed element, or nullptr when empty.
+    T* peek() noexcept {
+        if (cons.localHead == cons.cachedTail) {
+            cons.cachedTail = prod.tail.load(std::memory_order_acquire);
+            if (cons.localHead == cons.cachedTail) return nullptr;
+        }
+        return &slots[cons.localHead & MASK];
+    }
+
+    // Consumer: element i positions past the oldest, or nullptr.
+    T* peekAt(size_t i) noexcept {
+        if (cons.cachedTail - cons.localHead <= i) {
+            cons.cachedTail = prod.tail.load(std::memory_order_acquire);
+            if (cons.cachedTail - cons.localHead <= i) return nullptr;
+        }
+        return &slots[(cons.localHead + i) & MASK];
+    }
+
+    // Consumer: retire the peeked element; slots are not handed back to the
+    // producer until release().
+    void pop() noexcept { ++cons.localHead; }
+
+    void release() noexcept {
+        cons.head.store(cons.localHead, std::memory_order_release);
+    }
+
+    bool tryPop(T& out) noexcept {
+        T* p = peek();
+        if (!p) return false;
+        out = *p;
+        pop();
+        release();
+        return true;
+    }
+
+    // Consumer: drop everything currently visible.
+    void drain() noexcept {
+        cons.localHead = cons.cachedTail = prod.tail.load(std::memory_order_acquire);
+        release();
+    }
+
+    bool empty() const noexcept {
+        return cons.head.load(std::memory_order_acquire) ==
+               prod.tail.load(std::memory_order_acquire);
+    }
+
+    size_t size() const noexcept {
+        return prod.tail.load(std::memory_order_acquire) -
+               cons.head.load(std::memory_order_acquire);
+    }
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,101 @@
+#ifndef STATS_SEGMENT_H
+#define STATS_SEGMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <string>
+#include <sys/types.h>
+#include "metrics.h"
+#include "rate_meter.h"
+#include "seqlock.h"
+
+// Read-only metrics export in a /dev/shm file. The trader republishes a
+// MetricsSnapshot and its rate meter report on its own schedule; readers map
+// the file read-only and copy the record through a seqlock, so any number of
+// them can poll at any rate without the trader ever waiting or noticing.
+namespace StatsSegment {
+    constexpr uint64_t MAGIC = 0x3141545350415756ULL;  // "VWAPSTA1"
+    constexpr uint32_t VERSION = 1;
+    constexpr const char* DEFAULT_NAME = "vwap_stats";
+
+    struct Record {
+        MetricsSnapshot metrics;
+        RateMeter::Report rates;
+        uint64_t publishedNanos;  // CLOCK_REALTIME
+        uint64_t startedNanos;    // CLOCK_REALTIME
+    };
+
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t recordSize;
+        int32_t pid;
+        std::atomic<uint32_t> writerOpen;
+        Seqlock<Record> record;
+    };
+
+    static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Segment sequences must be lock-free across processes");
+}
+
+class StatsSegmentWriter final {
+private:
+    StatsSegment::Header* header;
+    uint64_t intervalNanos;
+    uint64_t lastPublish;
+    uint64_t startedNanos;
+
+public:
+    explicit StatsSegmentWriter(uint64_t intervalNanos = 10'000'000ULL) noexcept;
+    ~StatsSegmentWriter();
+
+    StatsSegmentWriter(const StatsSegmentWriter&) = delete;
+    StatsSegmentWriter& operator=(const StatsSegmentWriter&) = delete;
+
+    // Creates or reuses /dev/shm/<name>.
+    bool create(const std::string& name);
+    // Marks the segment closed; the last record stays readable.
+    void close() noexcept;
+    bool isOpen() const noexcept { return header != nullptr; }
+
+    // Publishes when intervalNanos have passed since the last publish;
+    // otherwise a single comparison. nowNanos is any monotonic clock.
+    inline void poll(uint64_t nowNanos, const RateMeter& meter) noexcept {
+        if (header && nowNanos - lastPublish >= intervalNanos) {
+            lastPublish = nowNanos;
+            publish(MetricsSnapshot::capture(g_systemMetrics), meter.report());
+        }
+    }
+
+    void publish(const MetricsSnapshot& metrics, const RateMeter::Report& rates) noexcept;
+    uint64_t published() const noexcept { return header ? header->record.version() : 0; }
+};
+
+class StatsSegmentReader final {
+private:
+    const StatsSegment::Header* header;
+    size_t mappedBytes;
+
+public:
+    StatsSegmentReader() noexcept;
+    ~StatsSegmentReader();
+
+    StatsSegmentReader(const StatsSegmentReader&) = delete;
+    StatsSegmentReader& operator=(const StatsSegmentReader&) = delete;
+
+    // Fails when the file is missing or from a different layout version. A
+    // closed segment still opens, so the last published record can be read.
+    bool open(const std::string& name);
+    void close() noexcept;
+    bool isOpen() const noexcept { return header != nullptr; }
+
+    // Copies the latest record. False when nothing has been published yet or
+    // no consistent copy was read within a bounded number of attempts.
+    bool read(StatsSegment::Record& out) const noexcept;
+    // Number of records published since the writer created the segment.
+    uint64_t version() const noexcept { return header ? header->record.version() : 0; }
+    bool writerOpen() const noexcept { return header && header->writerOpen.load(std::memory_order_acquire) != 0; }
+    pid_t writerPid() const noexcept { return header ? header->pid : 0; }
+};
+
+#endif // STATS_SEGMENT_H
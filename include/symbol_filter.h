@@ -0,0 +1,56 @@
+#ifndef SYMBOL_FILTER_H
+#define SYMBOL_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Small set of subscribed symbols, each packed into the uint64_t formed by
+// its zero-padded 8 wire bytes. An empty filter accepts every symbol.
+class SymbolFilter final {
+public:
+    static constexpr size_t MAX_SYMBOLS = 8;
+
+private:
+    uint64_t words[MAX_SYMBOLS];
+    size_t count;
+
+public:
+    SymbolFilter() noexcept : count(0) { std::memset(words, 0, sizeof(words)); }
+
+    static inline uint64_t pack(const char* symbol, size_t len) noexcept {
+        uint64_t word = 0;
+        std::memcpy(&word, symbol, len < 8 ? len : 8);
+        return word;
+    }
+
+    static inline uint64_t load(const uint8_t* wireSymbol) noexcept {
+        uint64_t word;
+        std::memcpy(&word, wireSymbol, sizeof(word));
+        return word;
+    }
+
+    bool add(const char* symbol, size_t len) noexcept {
+        if (len == 0 || len > 8) return false;
+        uint64_t word = pack(symbol, len);
+        if (matches(word)) return true;
+        if (count == MAX_SYMBOLS) return false;
+        words[count++] = word;
+        return true;
+    }
+
+    void clear() noexcept { count = 0; }
+    bool empty() const noexcept { return count == 0; }
+    size_t size() const noexcept { return count; }
+
+    inline bool matches(uint64_t word) const noexcept {
+        for (size_t i = 0; i < count; ++i) {
+            if (words[i] == word) return true;
+        }
+        return false;
+    }
+
+    inline bool accepts(uint64_t word) const noexcept { return count == 0 || matches(word); }
+};
+
+#endif // SYMBOL_FILTER_H
@@ -5,7 +5,10 @@
 #include <cstdint>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <sys/uio.h>
 #include <cerrno>
+#include <chrono>
+#include "socket_tuning.h"
 
 class TcpClient {
 public:
@@ -51,12 +54,19 @@ protected:
     uint32_t reconnectAttempts;
     uint64_t lastConnectAttempt;
     uint32_t currentBackoffMs;
+    std::chrono::steady_clock::time_point connectStarted;
 
     uint64_t bytesReceived;
     uint64_t bytesSent;
     uint64_t messagesReceived;
     uint64_t messagesSent;
 
+    bool rxTimestamps;
+    bool rxTimestampsActive;
+
+    SocketTuning tuning;
+    SocketTuning::Applied appliedTuning;
+
     static constexpr uint32_t INITIAL_BACKOFF_MS = 1000;
     static constexpr uint32_t MAX_BACKOFF_MS = 30000;
     static constexpr uint32_t MAX_RECONNECT_ATTEMPTS = 10;
@@ -66,17 +76,45 @@ public:
     explicit TcpClient(const std::string& host, uint16_t port);
     ~TcpClient();
 
+    // Blocks for up to CONNECT_TIMEOUT_SEC; used for the initial connection.
     bool connect() noexcept;
     bool connectWithTimeout(int timeoutSec) noexcept;
     void disconnect() noexcept;
+    // Never blocks. Returns true only when the connection completed at once;
+    // otherwise isConnecting() may be true and the caller waits for the
+    // socket to become writable, then calls completeConnect(), polling
+    // connectTimedOut() meanwhile.
     bool reconnect() noexcept;
     bool isConnected() const noexcept { return state == ConnectionState::CONNECTED; }
+    bool isConnecting() const noexcept { return state == ConnectionState::CONNECTING; }
+
+    // Starts a non-blocking connect: true when connected or in progress.
+    bool beginConnect() noexcept;
+    // Finishes an in-progress connect once the socket is writable.
+    bool completeConnect() noexcept;
+    // Abandons an in-progress connect older than CONNECT_TIMEOUT_SEC.
+    bool connectTimedOut() noexcept;
 
     bool setNonBlocking() noexcept;
     bool setSocketOptions() noexcept;
 
     ssize_t send(const uint8_t* data, size_t len) noexcept;
+    ssize_t sendv(const struct iovec* iov, size_t iovcnt) noexcept;
     ssize_t receive(uint8_t* buffer, size_t len) noexcept;
+    // Like receive(), also returning the kernel's software receive timestamp
+    // (CLOCK_REALTIME nanoseconds) of the data, or 0 when none was attached.
+    ssize_t receiveStamped(uint8_t* buffer, size_t len, uint64_t& kernelNanos) noexcept;
+
+    // Requests SO_TIMESTAMPNS (or SO_TIMESTAMPING) receive timestamps on
+    // this and every later socket. Returns false when the current socket
+    // refused them; receiveStamped() then reports 0.
+    bool enableRxTimestamps(bool enabled) noexcept;
+    bool rxTimestampsAvailable() const noexcept { return rxTimestampsActive; }
+
+    // Used for this and every later socket; the standard profile by default.
+    bool setTuning(const SocketTuning& profile) noexcept;
+    const SocketTuning& getTuning() const noexcept { return tuning; }
+    const SocketTuning::Applied& getAppliedTuning() const noexcept { return appliedTuning; }
 
     ErrorType getLastError() const noexcept { return lastError; }
     std::string getErrorString() const;
@@ -90,6 +128,9 @@ protected:
     bool resolveAddress() noexcept;
     [[gnu::cold]] void handleConnectError() noexcept;
     uint32_t calculateBackoff() noexcept;
+    void markConnected() noexcept;
+    bool applyRxTimestamps() noexcept;
+    void rearmQuickAck() noexcept;
     static ErrorType mapErrno(int e, ErrorType def) noexcept;
 };
 
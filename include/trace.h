@@ -0,0 +1,175 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "aligned_new.h"
+#include "async_logger.h"
+
+// Per-message stage tracing for chasing latency outliers. Each thread writes
+// compact binary records into its own fixed-size ring, overwriting the
+// oldest; a background thread streams them to a file, or in signal mode
+// dumps the most recent ones when asked (SIGUSR2 in the trader). Trace
+// points compile to nothing unless built with -DVWAP_TRACING (make TRACE=1).
+// trace_decode turns a trace file back into per-message stage latencies.
+
+enum class TraceStage : uint8_t { RECV, FRAME, PARSE, VWAP_UPDATE, DECISION, ORDER_SEND, COUNT };
+
+const char* traceStageName(TraceStage stage) noexcept;
+
+// messageTs is the traced message's own timestamp, which ties the stages of
+// one message together; RECV and FRAME come before it is parsed and carry 0.
+struct TraceRecord {
+    uint64_t ticks;
+    uint64_t messageTs;
+    uint32_t arg;
+    uint8_t stage;
+    uint8_t thread;
+    uint16_t _reserved;
+};
+
+static_assert(sizeof(TraceRecord) == 24, "TraceRecord is written to disk as is");
+
+namespace TraceFile {
+    constexpr uint64_t MAGIC = 0x3143525450415756ULL; // "VWAPTRC1"
+    constexpr uint32_t VERSION = 1;
+
+    // Followed by TraceRecords to the end of the file. The two tick/nanosecond
+    // pairs are taken at start and at the last flush; readers interpolate
+    // between them.
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t startTicks;
+        uint64_t startNanos;
+        uint64_t endTicks;
+        uint64_t endNanos;
+        uint64_t records;
+        uint64_t lost;
+    };
+}
+
+// Single-writer ring that never blocks its writer: once full, each record
+// overwrites the oldest. drain() may run concurrently on another thread and
+// discards any slot it finds overwritten while copying.
+class TraceRing : public AlignedNew<TraceRing> {
+public:
+    static constexpr size_t CAPACITY = 1 << 14;
+
+    TraceRing() noexcept : claimed(0), head(0), tail(0) {}
+
+    TraceRing(const TraceRing&) = delete;
+    TraceRing& operator=(const TraceRing&) = delete;
+
+    inline void record(TraceStage stage, uint64_t messageTs, uint32_t arg, uint64_t ticks) noexcept {
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        claimed.store(h + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        Slot& slot = slots[h & MASK];
+        slot.ticks.store(ticks, std::memory_order_relaxed);
+        slot.messageTs.store(messageTs, std::memory_order_relaxed);
+        slot.meta.store(static_cast<uint64_t>(stage) | (static_cast<uint64_t>(arg) << 32), std::memory_order_relaxed);
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // Appends the records written since the last drain, oldest first, tagged
+    // with thread. Returns how many were overwritten before they were read.
+    uint64_t drain(std::vector<TraceRecord>& out, uint8_t thread) noexcept;
+
+    uint64_t written() const noexcept { return head.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint64_t MASK = CAPACITY - 1;
+    static_assert((CAPACITY & MASK) == 0, "CAPACITY must be a power of two");
+
+    struct Slot {
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> messageTs{0};
+        std::atomic<uint64_t> meta{0};
+    };
+
+    // claimed moves before a slot is rewritten and head after, so a reader
+    // rechecking claimed knows which of its copies may be torn.
+    alignas(64) std::atomic<uint64_t> claimed;
+    std::atomic<uint64_t> head;
+    alignas(64) uint64_t tail;
+    Slot slots[CAPACITY];
+};
+
+class Tracer final {
+public:
+    enum class Mode : uint8_t { STREAM, SIGNAL };
+    static constexpr size_t MAX_THREADS = 64;
+
+    Tracer() = default;
+    ~Tracer();
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    // STREAM writes records out as they arrive; SIGNAL keeps only the most
+    // recent CAPACITY per thread and writes them on requestDump() and stop().
+    bool start(const char* path, Mode mode);
+    void stop() noexcept;
+    bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+    // The flusher thread, for placement; valid while active.
+    std::thread::native_handle_type flusherThread() noexcept { return flusher.native_handle(); }
+
+    // Async-signal-safe.
+    void requestDump() noexcept { dumpRequested.store(true, std::memory_order_relaxed); }
+
+    uint64_t writtenRecords() const noexcept { return written.load(std::memory_order_relaxed); }
+    uint64_t lostRecords() const noexcept { return lost.load(std::memory_order_relaxed); }
+
+    inline void record(TraceStage stage, uint64_t messageTs, uint32_t arg) noexcept {
+        if (!active.load(std::memory_order_relaxed)) return;
+        TraceRing* r = tlsOwner == instance ? tlsRing : registerThread();
+        if (r) r->record(stage, messageTs, arg, AsyncLogger::nowTicks());
+    }
+
+private:
+    // As in AsyncLogger, the owner is an instance number so a tracer built
+    // where a destroyed one stood does not inherit its rings.
+    static thread_local TraceRing* tlsRing;
+    static thread_local uint64_t tlsOwner;
+    static std::atomic<uint64_t> nextInstance;
+
+    const uint64_t instance{nextInstance.fetch_add(1, std::memory_order_relaxed) + 1};
+
+    std::atomic<bool> active{false};
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> dumpRequested{false};
+    std::mutex registryMutex;
+    std::vector<TraceRing*> rings;
+    // The thread writing each ring, by index.
+    std::vector<std::thread::id> ringThreads;
+    std::thread flusher;
+    Mode mode{Mode::STREAM};
+    FILE* out{nullptr};
+    TraceFile::Header header{};
+    std::vector<TraceRecord> scratch;
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> lost{0};
+
+    TraceRing* registerThread() noexcept;
+    void run() noexcept;
+    // Overwritten records count as lost only when streaming.
+    size_t flushOnce(bool countLost) noexcept;
+    void writeHeader() noexcept;
+};
+
+extern Tracer g_tracer;
+
+#ifdef VWAP_TRACING
+#define VWAP_TRACE(stage, messageTs, arg) \
+    g_tracer.record(TraceStage::stage, (messageTs), static_cast<uint32_t>(arg))
+#else
+#define VWAP_TRACE(stage, messageTs, arg) ((void)0)
+#endif
+
+#endif // TRACE_H
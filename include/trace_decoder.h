@@ -0,0 +1,80 @@
+#ifndef TRACE_DECODER_H
+#define TRACE_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "trace.h"
+
+// Rebuilds per-message stage timings from a trace file. On each thread the
+// latest RECV and FRAME are bound to the next PARSE, which opens a message
+// keyed by its timestamp; later stages carrying that timestamp attach to the
+// newest message parsed with it, whichever thread records them.
+class TraceDecoder {
+public:
+    static constexpr size_t STAGES = static_cast<size_t>(TraceStage::COUNT);
+
+    struct Message {
+        uint64_t messageTs;
+        uint8_t thread;
+        uint8_t type;
+        bool ordered;
+        // Nanoseconds on the tracer's steady clock; 0 where the stage was not seen.
+        uint64_t stageNanos[STAGES];
+
+        bool has(TraceStage stage) const noexcept { return stageNanos[static_cast<size_t>(stage)] != 0; }
+        uint64_t at(TraceStage stage) const noexcept { return stageNanos[static_cast<size_t>(stage)]; }
+        // From the first stage seen to the last.
+        uint64_t totalNanos() const noexcept;
+    };
+
+    // The intervals reported per message.
+    struct Span {
+        TraceStage from;
+        TraceStage to;
+        const char* name;
+        // Twelve characters at most, for table columns.
+        const char* column;
+    };
+    static constexpr size_t SPANS = 5;
+    static const Span SPAN_LIST[SPANS];
+
+    struct Summary {
+        std::string name;
+        size_t count;
+        uint64_t p50, p90, p99, p999, max;
+    };
+
+    TraceDecoder() noexcept;
+
+    // False with error set when the file is missing or not a trace.
+    bool load(const std::string& path, std::string& error);
+    void decode(const TraceFile::Header& header, const std::vector<TraceRecord>& records);
+
+    const TraceFile::Header& header() const noexcept { return fileHeader; }
+    const std::vector<Message>& messages() const noexcept { return decoded; }
+    size_t records() const noexcept { return recordCount; }
+    size_t threads() const noexcept { return threadCount; }
+    // Stage records whose message was never parsed in the trace.
+    size_t unmatched() const noexcept { return unmatchedCount; }
+
+    uint64_t toNanos(uint64_t ticks) const noexcept;
+    // Span duration for one message, or -1 when either end is missing.
+    static int64_t spanNanos(const Message& message, const Span& span) noexcept;
+    // One row per span, then the end-to-end total.
+    std::vector<Summary> summarize() const;
+    // Chrome trace-event JSON: each message is a nestable async event with
+    // one child per span, on the track of the thread that parsed it.
+    void writeChrome(std::ostream& out) const;
+
+private:
+    TraceFile::Header fileHeader;
+    std::vector<Message> decoded;
+    size_t recordCount;
+    size_t threadCount;
+    size_t unmatchedCount;
+};
+
+#endif // TRACE_DECODER_H
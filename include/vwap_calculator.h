@@ -1,12 +1,26 @@
 #ifndef VWAP_CALCULATOR_H
 #define VWAP_CALCULATOR_H
 
+#include <cstddef>
 #include <cstdint>
 #include "circular_buffer.h"
 #include <array>
+#include "realtime.h"
+#include "seqlock.h"
 
 struct TradeMessage;
 
+// The calculator state other threads may read, published after every
+// update that accepted a trade.
+struct VwapSnapshot {
+    double vwap;
+    uint64_t sumPriceVolume;
+    uint64_t sumVolume;
+    uint64_t lastTradeTime;
+    uint32_t tradeCount;
+    bool windowComplete;
+};
+
 class VwapCalculator final {
 private:
     alignas(64) struct HotData {
@@ -37,6 +51,8 @@ private:
     uint64_t totalTradesProcessed;
     uint64_t rejectedTrades;
 
+    Seqlock<VwapSnapshot> published;
+
 public:
     explicit VwapCalculator(uint32_t windowSeconds) noexcept;
 
@@ -47,6 +63,11 @@ public:
     ~VwapCalculator() = default;
 
     void addTrade(const TradeMessage& trade) noexcept;
+    // Adds count trades given as parallel columns, in order. Returns how many were accepted.
+    size_t addTrades(const uint64_t* timestamps, const uint32_t* quantities,
+                     const int32_t* prices, size_t count) noexcept;
+    // Hot thread only: refreshes the cached VWAP. Other threads read
+    // readSnapshot() instead.
     double getCurrentVwap() const noexcept;
     bool hasCompleteWindow() const noexcept { return firstWindowComplete && !tradeWindow.empty(); }
 
@@ -57,9 +78,19 @@ public:
     uint64_t getLastTradeTime() const noexcept { return lastTradeTime; }
     uint32_t getPrefixGeneration() const noexcept { return prefixGeneration; }
 
+    // Any thread. readSnapshot() retries while a publish is in progress;
+    // tryReadSnapshot() makes one wait-free attempt.
+    VwapSnapshot readSnapshot() const noexcept { return published.load(); }
+    bool tryReadSnapshot(VwapSnapshot& out) const noexcept { return published.tryLoad(out); }
+    uint64_t snapshotVersion() const noexcept { return published.version(); }
+
     void printStatistics() const noexcept;
+    // Maps the window and prefix arrays before the first trade arrives.
+    void prefault() noexcept { Realtime::prefault(this, sizeof(*this)); }
 
 private:
+    bool appendTrade(uint64_t ts, uint32_t qty, int32_t price) noexcept;
+    void publish() noexcept;
     void removeExpiredTrades(uint64_t currentTime) noexcept;
     void rebuildPrefixes() noexcept;
     void appendPrefix(uint32_t qty, uint64_t pv) noexcept;
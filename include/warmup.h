@@ -0,0 +1,46 @@
+#ifndef WARMUP_H
+#define WARMUP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Pre-trading warmup. Synthetic trades and quotes for the traded symbol are
+// framed, parsed, run through VWAP and the decision engine of a scratch
+// OrderManager, and every resulting order is serialized into the order
+// template and discarded. Rounds repeat until the median quote-to-order
+// latency settles. The scratch state is then dropped and the global metrics
+// reset, so only the warmed caches and branch predictors remain.
+class Warmup final {
+public:
+    static constexpr size_t MIN_ROUNDS = 3;
+    static constexpr size_t MAX_ROUNDS = 50;
+    static constexpr size_t TICKS_PER_ROUND = 256;
+    // A round whose median is within this fraction of the previous round's
+    // counts as stable; two stable rounds in a row end the warmup.
+    static constexpr double STABLE_TOLERANCE = 0.05;
+
+    struct Report {
+        size_t rounds = 0;
+        uint64_t quotes = 0;
+        uint64_t trades = 0;
+        uint64_t orders = 0;
+        uint64_t elapsedNanos = 0;
+        // Median quote-to-order latency of the first round that ordered.
+        uint64_t firstRoundMedianNanos = 0;
+        uint64_t lastRoundMedianNanos = 0;
+        // Quote-to-serialized-order latency of the first order a fresh
+        // OrderManager produces, in a cold process and after warming.
+        uint64_t coldFirstOrderNanos = 0;
+        uint64_t warmFirstOrderNanos = 0;
+        bool stable = false;
+
+        void print() const;
+    };
+
+    // Must run before the async logger starts; it borrows the logger with a
+    // /dev/null sink so the logging path is warmed without output.
+    static Report run(const std::string& symbol, char side, uint32_t maxOrderSize, uint32_t windowSeconds);
+};
+
+#endif // WARMUP_H
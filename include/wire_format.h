@@ -30,6 +30,12 @@ namespace WireFormat {
     constexpr size_t ORDER_PRICE_OFFSET = 21;
     
     constexpr size_t MAX_MESSAGE_SIZE = HEADER_SIZE + QUOTE_SIZE;
+
+    // UDP transport: each datagram is an 8-byte little-endian datagram
+    // sequence number followed by whole frames. A sender that restarts
+    // begins again at sequence 1.
+    constexpr size_t DATAGRAM_SEQUENCE_SIZE = 8;
+    constexpr size_t MAX_DATAGRAM_SIZE = 1472;
 }
 
 static_assert(WireFormat::QUOTE_ASK_PRICE_OFFSET + 4 == WireFormat::QUOTE_SIZE, 
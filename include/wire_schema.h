@@ -0,0 +1,210 @@
+#ifndef WIRE_SCHEMA_H
+#define WIRE_SCHEMA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <initializer_list>
+#include "endian_converter.h"
+
+// Compile-time wire schemas. A message type is declared once as an ordered
+// list of WireField members; offsets and total size are the packed prefix
+// sums of the field sizes. Parse, serialize, validation and in-place field
+// access are all generated from that list.
+
+namespace WireSchemaDetail {
+    template<size_t N> struct ByteOrder;
+    template<> struct ByteOrder<1> {
+        static uint8_t toHost(uint8_t v) noexcept { return v; }
+    };
+    template<> struct ByteOrder<4> {
+        static uint32_t toHost(uint32_t v) noexcept { return EndianConverter::ltoh32(v); }
+    };
+    template<> struct ByteOrder<8> {
+        static uint64_t toHost(uint64_t v) noexcept { return EndianConverter::ltoh64(v); }
+    };
+
+    template<size_t N> struct UnsignedOf;
+    template<> struct UnsignedOf<1> { using type = uint8_t; };
+    template<> struct UnsignedOf<4> { using type = uint32_t; };
+    template<> struct UnsignedOf<8> { using type = uint64_t; };
+
+    template<typename T> struct FormatChar;
+    template<> struct FormatChar<char>     { static constexpr char value = 'c'; };
+    template<> struct FormatChar<uint32_t> { static constexpr char value = 'I'; };
+    template<> struct FormatChar<int32_t>  { static constexpr char value = 'i'; };
+    template<> struct FormatChar<uint64_t> { static constexpr char value = 'Q'; };
+    template<> struct FormatChar<int64_t>  { static constexpr char value = 'q'; };
+
+    template<typename... Fs>
+    constexpr size_t offsetAt(size_t index) noexcept {
+        const size_t sizes[] = { Fs::size..., 0 };
+        size_t offset = 0;
+        for (size_t i = 0; i < index; ++i) offset += sizes[i];
+        return offset;
+    }
+
+    template<typename F, typename... Fs>
+    constexpr size_t indexOf() noexcept {
+        const bool same[] = { std::is_same<F, Fs>::value..., false };
+        for (size_t i = 0; i < sizeof...(Fs); ++i) {
+            if (same[i]) return i;
+        }
+        return sizeof...(Fs);
+    }
+
+    inline void expand(std::initializer_list<int>) noexcept {}
+}
+
+// Little-endian scalar or fixed-length character array as it appears on the wire.
+template<typename T, typename Enable = void>
+struct WireValue;
+
+template<typename T>
+struct WireValue<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+    using value_type = T;
+    using raw_type = typename WireSchemaDetail::UnsignedOf<sizeof(T)>::type;
+
+    static inline T load(const uint8_t* p) noexcept {
+        raw_type raw;
+        std::memcpy(&raw, p, sizeof(raw));
+        return static_cast<T>(WireSchemaDetail::ByteOrder<sizeof(T)>::toHost(raw));
+    }
+    static inline void store(uint8_t* p, T value) noexcept {
+        raw_type raw = WireSchemaDetail::ByteOrder<sizeof(T)>::toHost(static_cast<raw_type>(value));
+        std::memcpy(p, &raw, sizeof(raw));
+    }
+    static inline void decode(const uint8_t* p, T& out) noexcept { out = load(p); }
+    static inline void encode(uint8_t* p, const T& in) noexcept { store(p, in); }
+    static void appendFormat(std::string& fmt) { fmt += WireSchemaDetail::FormatChar<T>::value; }
+};
+
+template<size_t N>
+struct WireValue<char[N]> {
+    using value_type = const char*;
+
+    static inline const char* load(const uint8_t* p) noexcept { return reinterpret_cast<const char*>(p); }
+    static inline void store(uint8_t* p, const char* value) noexcept { std::memcpy(p, value, N); }
+    static inline void decode(const uint8_t* p, char (&out)[N]) noexcept { std::memcpy(out, p, N); }
+    static inline void encode(uint8_t* p, const char (&in)[N]) noexcept { std::memcpy(p, in, N); }
+    static void appendFormat(std::string& fmt) { fmt += std::to_string(N); fmt += 's'; }
+};
+
+// Per-field value constraints.
+namespace WireCheck {
+    struct Any {
+        template<typename V> static constexpr bool check(const V&) noexcept { return true; }
+    };
+    struct NonZero {
+        template<typename V> static constexpr bool check(V v) noexcept { return v != 0; }
+    };
+    // Rejects values whose sign bit is set when read as the signed type of the same width.
+    struct NonNegative {
+        template<typename V> static constexpr bool check(V v) noexcept {
+            return static_cast<typename std::make_signed<V>::type>(v) >= 0;
+        }
+    };
+    template<char A, char B>
+    struct OneOf {
+        static constexpr bool check(char v) noexcept { return v == A || v == B; }
+    };
+}
+
+template<typename Msg, typename T, T Msg::*Member, typename Check = WireCheck::Any>
+struct WireField {
+    using message_type = Msg;
+    using type = T;
+    using codec = WireValue<T>;
+    using check_type = Check;
+    static constexpr size_t size = sizeof(T);
+
+    static inline const T& of(const Msg& m) noexcept { return m.*Member; }
+    static inline void decodeInto(const uint8_t* p, Msg& m) noexcept { codec::decode(p, m.*Member); }
+    static inline void encodeFrom(uint8_t* p, const Msg& m) noexcept { codec::encode(p, m.*Member); }
+    static inline bool valid(const uint8_t* p) noexcept { return Check::check(codec::load(p)); }
+    static inline bool valid(const Msg& m) noexcept { return Check::check(m.*Member); }
+};
+
+// Cross-field constraints.
+namespace WireRule {
+    // Signed A <= signed B, each read at its own width.
+    template<typename A, typename B>
+    struct NotGreater {
+        template<typename V>
+        static constexpr int64_t asSigned(V v) noexcept {
+            return static_cast<typename std::make_signed<V>::type>(v);
+        }
+        template<typename Schema>
+        static inline bool check(const uint8_t* wire) noexcept {
+            return asSigned(Schema::template get<A>(wire)) <= asSigned(Schema::template get<B>(wire));
+        }
+        template<typename Schema, typename Msg>
+        static inline bool check(const Msg& m) noexcept {
+            return asSigned(A::of(m)) <= asSigned(B::of(m));
+        }
+    };
+}
+
+template<typename... Fs> struct WireFields {};
+template<typename... Rs> struct WireRules {};
+
+template<typename Msg, typename Fields, typename Rules = WireRules<>>
+struct WireSchema;
+
+template<typename Msg, typename... Fs, typename... Rs>
+struct WireSchema<Msg, WireFields<Fs...>, WireRules<Rs...>> {
+    static_assert(sizeof...(Fs) > 0, "A schema needs at least one field");
+    static_assert(std::is_trivially_copyable<Msg>::value, "Schema messages must be trivially copyable");
+
+    using message_type = Msg;
+    static constexpr size_t size = WireSchemaDetail::offsetAt<Fs...>(sizeof...(Fs));
+
+    template<typename F>
+    static constexpr size_t offset() noexcept {
+        static_assert(WireSchemaDetail::indexOf<F, Fs...>() < sizeof...(Fs), "Field is not part of this schema");
+        return WireSchemaDetail::offsetAt<Fs...>(WireSchemaDetail::indexOf<F, Fs...>());
+    }
+
+    template<typename F>
+    static inline typename F::codec::value_type get(const uint8_t* wire) noexcept {
+        return F::codec::load(wire + offset<F>());
+    }
+
+    template<typename F>
+    static inline void set(uint8_t* wire, typename F::codec::value_type value) noexcept {
+        F::codec::store(wire + offset<F>(), value);
+    }
+
+    static inline void decode(const uint8_t* wire, Msg& out) noexcept {
+        WireSchemaDetail::expand({ (Fs::decodeInto(wire + offset<Fs>(), out), 0)... });
+    }
+
+    static inline void encode(const Msg& in, uint8_t* wire) noexcept {
+        WireSchemaDetail::expand({ (Fs::encodeFrom(wire + offset<Fs>(), in), 0)... });
+    }
+
+    static inline bool valid(const uint8_t* wire) noexcept {
+        bool ok = true;
+        WireSchemaDetail::expand({ (ok &= Fs::valid(wire + offset<Fs>()), 0)... });
+        WireSchemaDetail::expand({ (ok &= Rs::template check<WireSchema>(wire), 0)..., 0 });
+        return ok;
+    }
+
+    static inline bool valid(const Msg& m) noexcept {
+        bool ok = true;
+        WireSchemaDetail::expand({ (ok &= Fs::valid(m), 0)... });
+        WireSchemaDetail::expand({ (ok &= Rs::template check<WireSchema>(m), 0)..., 0 });
+        return ok;
+    }
+
+    // Python struct format, e.g. "<8sQcIi" for orders.
+    static std::string structFormat() {
+        std::string fmt = "<";
+        WireSchemaDetail::expand({ (Fs::codec::appendFormat(fmt), 0)... });
+        return fmt;
+    }
+};
+
+#endif // WIRE_SCHEMA_H
@@ -9,7 +9,9 @@ import struct
 import sys
 from datetime import datetime
 
-ORDER_SIZE = 25  # Fixed size per spec
+# Mirrors OrderSchema in include/message_schema.h (OrderSchema::structFormat()).
+ORDER_FORMAT = '<8sQcIi'
+ORDER_SIZE = struct.calcsize(ORDER_FORMAT)  # 25 bytes per spec
 
 def recv_fully(sock, n):
     data = bytearray()
@@ -23,10 +25,8 @@ def recv_fully(sock, n):
 def parse_order(payload):
     if len(payload) != ORDER_SIZE:
         raise ValueError("Invalid order size")
-    symbol_raw = payload[0:8]
-    timestamp, = struct.unpack_from('<Q', payload, 8)
-    side = chr(payload[16])
-    quantity, price = struct.unpack_from('<Ii', payload, 17)
+    symbol_raw, timestamp, side_raw, quantity, price = struct.unpack(ORDER_FORMAT, payload)
+    side = side_raw.decode('ascii', errors='ignore')
     symbol = symbol_raw.decode('ascii', errors='ignore').rstrip('\x00')
     return {
         'symbol': symbol,
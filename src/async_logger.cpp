@@ -0,0 +1,192 @@
+#include "async_logger.h"
+#include <cinttypes>
+
+AsyncLogger g_asyncLogger;
+thread_local AsyncLogger::ThreadRing* AsyncLogger::tlsRing = nullptr;
+thread_local uint64_t AsyncLogger::tlsOwner = 0;
+std::atomic<uint64_t> AsyncLogger::nextInstance{0};
+
+namespace {
+const char* const FORMAT_SPECS[] = {
+    "[ORDER] {S} {u} @ ${$} (VWAP: ${$}) Reason: {z}",
+    "Order sent: {S} {u} @ ${$}",
+    "[ORDER SENT] {s} {S} {u} @ ${$} (VWAP: ${$})",
+    "[VWAP UPDATE] Current VWAP: ${$} (after {u} trades)",
+    "[ORDER SENT] {S} {u} {s} @ ${$} (Order #{u})",
+    "[VWAP UPDATE] Current VWAP: ${$} (after {u} trades)",
+};
+
+static_assert(sizeof(FORMAT_SPECS) / sizeof(FORMAT_SPECS[0]) == static_cast<size_t>(LogFmt::COUNT),
+              "Every LogFmt needs a format spec");
+
+inline double asDouble(uint64_t v) noexcept { double d; std::memcpy(&d, &v, sizeof(d)); return d; }
+
+inline size_t append(size_t cap, size_t pos, int n) noexcept {
+    if (n <= 0) return pos;
+    size_t next = pos + static_cast<size_t>(n);
+    return next < cap ? next : (cap ? cap - 1 : 0);
+}
+}
+
+AsyncLogger::~AsyncLogger() {
+    stop();
+    for (ThreadRing* r : rings) delete r;
+}
+
+const char* AsyncLogger::formatSpec(LogFmt fmt) noexcept {
+    size_t idx = static_cast<size_t>(fmt);
+    return idx < static_cast<size_t>(LogFmt::COUNT) ? FORMAT_SPECS[idx] : "<unknown log format>";
+}
+
+size_t AsyncLogger::format(const LogRecord& rec, char* buf, size_t cap) noexcept {
+    if (cap == 0) return 0;
+    const char* spec = formatSpec(static_cast<LogFmt>(rec.fmt));
+    size_t pos = 0;
+    size_t argIdx = 0;
+    for (const char* p = spec; *p && pos + 1 < cap; ++p) {
+        if (p[0] == '{' && p[1] && p[2] == '}') {
+            uint64_t a = argIdx < rec.argc ? rec.args[argIdx] : 0;
+            ++argIdx;
+            char* dst = buf + pos;
+            size_t room = cap - pos;
+            switch (p[1]) {
+                case 'u': pos = append(cap, pos, std::snprintf(dst, room, "%" PRIu64, a)); break;
+                case 'i': pos = append(cap, pos, std::snprintf(dst, room, "%" PRId64, static_cast<int64_t>(a))); break;
+                case 'f': pos = append(cap, pos, std::snprintf(dst, room, "%.2f", asDouble(a))); break;
+                case '$': pos = append(cap, pos, std::snprintf(dst, room, "%.2f", asDouble(a) / 100.0)); break;
+                case 'c': pos = append(cap, pos, std::snprintf(dst, room, "%c", static_cast<char>(a))); break;
+                case 'S': pos = append(cap, pos, std::snprintf(dst, room, "%s", static_cast<char>(a) == 'B' ? "BUY" : "SELL")); break;
+                case 's': {
+                    char sym[9] = {0};
+                    std::memcpy(sym, &a, 8);
+                    pos = append(cap, pos, std::snprintf(dst, room, "%s", sym));
+                    break;
+                }
+                case 'z': {
+                    const char* str = reinterpret_cast<const char*>(static_cast<uintptr_t>(a));
+                    pos = append(cap, pos, std::snprintf(dst, room, "%s", str ? str : ""));
+                    break;
+                }
+                default: --argIdx; buf[pos++] = p[0]; continue;
+            }
+            p += 2;
+        } else {
+            buf[pos++] = *p;
+        }
+    }
+    buf[pos] = '\0';
+    return pos;
+}
+
+void AsyncLogger::writeRecord(FILE* f, const LogRecord& rec, bool withTimestamp) noexcept {
+    char line[256];
+    size_t n = 0;
+    if (withTimestamp) {
+        int w = std::snprintf(line, sizeof(line), "%" PRIu64 " ", ticksToNanos(rec.ticks));
+        n = w > 0 ? static_cast<size_t>(w) : 0;
+    }
+    n += format(rec, line + n, sizeof(line) - n - 1);
+    line[n++] = '\n';
+    std::fwrite(line, 1, n, f);
+    written.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t AsyncLogger::ticksToNanos(uint64_t ticks) const noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t nowT = nowTicks();
+    uint64_t nowN = nowNanos();
+    if (nowT <= startTicks || ticks < startTicks) return nowN;
+    double nsPerTick = static_cast<double>(nowN - startNanos) / static_cast<double>(nowT - startTicks);
+    return startNanos + static_cast<uint64_t>(static_cast<double>(ticks - startTicks) * nsPerTick);
+#else
+    return ticks;
+#endif
+}
+
+AsyncLogger::ThreadRing* AsyncLogger::registerThread() noexcept {
+    const std::thread::id self = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    // A thread coming back from another logger keeps the ring it had here.
+    ThreadRing* r = nullptr;
+    for (ThreadRing* existing : rings) {
+        if (existing->owner == self) {
+            r = existing;
+            break;
+        }
+    }
+    if (!r) {
+        r = new (std::nothrow) ThreadRing();
+        if (!r) return nullptr;
+        r->owner = self;
+        rings.push_back(r);
+        ringCount.store(rings.size(), std::memory_order_release);
+    }
+    tlsRing = r;
+    tlsOwner = instance;
+    return r;
+}
+
+bool AsyncLogger::start(FILE* sink, bool withTimestamps) {
+    if (active.load() || !sink) return false;
+    out = sink;
+    timestamps = withTimestamps;
+    startTicks = nowTicks();
+    startNanos = nowNanos();
+    stopRequested.store(false);
+    active.store(true, std::memory_order_release);
+    writer = std::thread(&AsyncLogger::run, this);
+    return true;
+}
+
+bool AsyncLogger::startFile(const char* path) {
+    FILE* f = std::fopen(path, "a");
+    if (!f) return false;
+    if (!start(f, true)) { std::fclose(f); return false; }
+    ownsFile = true;
+    return true;
+}
+
+void AsyncLogger::stop() noexcept {
+    if (!active.exchange(false)) return;
+    stopRequested.store(true, std::memory_order_release);
+    if (writer.joinable()) writer.join();
+    drainOnce();
+    std::fflush(out);
+    if (ownsFile) { std::fclose(out); ownsFile = false; }
+    out = nullptr;
+}
+
+uint64_t AsyncLogger::droppedRecords() noexcept {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    uint64_t total = 0;
+    for (ThreadRing* r : rings) total += r->dropped.load(std::memory_order_relaxed);
+    return total;
+}
+
+size_t AsyncLogger::drainOnce() noexcept {
+    if (ringCount.load(std::memory_order_acquire) != drainRings.size()) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        drainRings = rings;
+    }
+    size_t drained = 0;
+    for (ThreadRing* r : drainRings) {
+        LogRecord* rec;
+        while ((rec = r->ring.peek()) != nullptr) {
+            writeRecord(out, *rec, timestamps);
+            r->ring.pop();
+            ++drained;
+        }
+        r->ring.release();
+    }
+    return drained;
+}
+
+void AsyncLogger::run() noexcept {
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        if (drainOnce()) {
+            std::fflush(out);
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+}
@@ -5,15 +5,76 @@
 #include <iomanip>
 #include <algorithm>
 #include <cstring>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <unistd.h>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
 
 #include "vwap_calculator.h"
 #include "order_manager.h"
 #include "message_buffer.h"
 #include "memory_pool.h"
 #include "circular_buffer.h"
+#include "message_serializer.h"
+#include "order_template.h"
+#include "message_parser.h"
+#include "message_view.h"
+#include "message_schema.h"
+#include "endian_converter.h"
+#include "async_logger.h"
+#include "shm_ring.h"
+#include "socket_tuning.h"
+#include "perf_counters.h"
 
 using namespace std::chrono;
 
+// The field-by-field codec that preceded the schema templates, kept as the
+// reference the generated code is measured against.
+namespace HandwrittenCodec {
+inline bool parseQuote(const uint8_t* buffer, QuoteMessage& quote) noexcept {
+    std::memset(&quote, 0, sizeof(quote));
+    std::memcpy(quote.symbol, buffer + WireFormat::QUOTE_SYMBOL_OFFSET, 8);
+    uint64_t timestamp;
+    std::memcpy(&timestamp, buffer + WireFormat::QUOTE_TIMESTAMP_OFFSET, sizeof(uint64_t));
+    quote.timestamp = EndianConverter::ltoh64(timestamp);
+    uint32_t bidQty;
+    std::memcpy(&bidQty, buffer + WireFormat::QUOTE_BID_QTY_OFFSET, sizeof(uint32_t));
+    quote.bidQuantity = EndianConverter::ltoh32(bidQty);
+    uint32_t bidPrice;
+    std::memcpy(&bidPrice, buffer + WireFormat::QUOTE_BID_PRICE_OFFSET, sizeof(uint32_t));
+    quote.bidPrice = EndianConverter::ltoh32(bidPrice);
+    uint32_t askQty;
+    std::memcpy(&askQty, buffer + WireFormat::QUOTE_ASK_QTY_OFFSET, sizeof(uint32_t));
+    quote.askQuantity = EndianConverter::ltoh32(askQty);
+    int32_t askPrice;
+    std::memcpy(&askPrice, buffer + WireFormat::QUOTE_ASK_PRICE_OFFSET, sizeof(int32_t));
+    quote.askPrice = EndianConverter::ltoh32_signed(askPrice);
+    return true;
+}
+
+inline bool validateQuote(const QuoteMessage& quote) noexcept {
+    if (quote.bidQuantity == 0 || quote.askQuantity == 0) return false;
+    if (quote.askPrice < 0 || static_cast<int32_t>(quote.bidPrice) < 0) return false;
+    if (static_cast<int32_t>(quote.bidPrice) > quote.askPrice) return false;
+    return true;
+}
+
+inline void serializeOrder(uint8_t* buffer, const OrderMessage& order) noexcept {
+    std::memcpy(buffer + WireFormat::ORDER_SYMBOL_OFFSET, order.symbol, 8);
+    uint64_t timestamp = EndianConverter::htol64(order.timestamp);
+    std::memcpy(buffer + WireFormat::ORDER_TIMESTAMP_OFFSET, &timestamp, sizeof(uint64_t));
+    buffer[WireFormat::ORDER_SIDE_OFFSET] = order.side;
+    uint32_t quantity = EndianConverter::htol32(order.quantity);
+    std::memcpy(buffer + WireFormat::ORDER_QUANTITY_OFFSET, &quantity, sizeof(uint32_t));
+    int32_t price = EndianConverter::htol32_signed(order.price);
+    std::memcpy(buffer + WireFormat::ORDER_PRICE_OFFSET, &price, sizeof(int32_t));
+}
+}
+
 class PerformanceBenchmark {
 private:
     static constexpr size_t NUM_MESSAGES = 10000;
@@ -33,9 +94,22 @@ private:
         double throughput;
     };
 
+    // With --perf, hardware counters are read around each single-threaded
+    // measured loop and reported per message after its section.
+    struct CounterRow {
+        std::string name;
+        PerfCounters::Reading reading;
+        size_t messages;
+    };
+
+    bool countersRequested;
+    PerfCounters perf;
+    std::vector<CounterRow> counterRows;
+
 public:
-    PerformanceBenchmark() : rng(42) {
+    explicit PerformanceBenchmark(bool hardwareCounters = false) : rng(42), countersRequested(hardwareCounters) {
         generateTestData();
+        if (countersRequested) perf.open();
     }
 
     void runAllBenchmarks() {
@@ -43,6 +117,14 @@ public:
         std::cout << "    VWAP Trading System Performance" << std::endl;
         std::cout << "           Benchmark Results" << std::endl;
         std::cout << "=========================================" << std::endl;
+        if (countersRequested) {
+            if (perf.isOpen()) {
+                std::cout << "Hardware counters: on (user space, per message)" << std::endl;
+            } else {
+                std::cout << "Hardware counters unavailable: " << perf.unavailableReason() << std::endl;
+                std::cout << "Reporting latency only" << std::endl;
+            }
+        }
 
         std::cout << "\n1. VWAP CALCULATOR PERFORMANCE" << std::endl;
         std::cout << "-------------------------------" << std::endl;
@@ -50,6 +132,7 @@ public:
         auto vwapResult = benchmarkVwap();
 
         printResult("VWAP Calculation", vwapResult);
+        printCounters();
 
         std::cout << "\n2. ORDER MANAGER PERFORMANCE" << std::endl;
         std::cout << "-----------------------------" << std::endl;
@@ -57,11 +140,13 @@ public:
         auto orderResult = benchmarkOrderManager();
 
         printResult("Order Processing", orderResult);
+        printCounters();
 
         std::cout << "\n3. MEMORY ALLOCATION PERFORMANCE" << std::endl;
         std::cout << "---------------------------------" << std::endl;
 
         benchmarkMemoryAllocations();
+        printCounters();
 
         std::cout << "\n4. END-TO-END LATENCY" << std::endl;
         std::cout << "----------------------" << std::endl;
@@ -69,6 +154,41 @@ public:
         auto e2eResult = benchmarkEndToEnd();
 
         printResult("End-to-End", e2eResult);
+        printCounters();
+
+        std::cout << "\n5. ORDER SERIALIZATION" << std::endl;
+        std::cout << "----------------------" << std::endl;
+
+        benchmarkOrderSerialization();
+        printCounters();
+
+        std::cout << "\n6. ASYNC LOGGER HOT PATH" << std::endl;
+        std::cout << "------------------------" << std::endl;
+
+        benchmarkAsyncLogger();
+        printCounters();
+
+        std::cout << "\n7. MESSAGE PARSING" << std::endl;
+        std::cout << "------------------" << std::endl;
+
+        benchmarkMessageParsing();
+        printCounters();
+
+        std::cout << "\n8. SCHEMA CODEC" << std::endl;
+        std::cout << "---------------" << std::endl;
+
+        benchmarkSchemaCodec();
+        printCounters();
+
+        std::cout << "\n9. SHARED MEMORY TRANSPORT" << std::endl;
+        std::cout << "---------------------------" << std::endl;
+
+        benchmarkShmTransport();
+
+        std::cout << "\n10. SOCKET TUNING PROFILES" << std::endl;
+        std::cout << "--------------------------" << std::endl;
+
+        benchmarkSocketProfiles();
 
         printSummary();
     }
@@ -112,6 +232,7 @@ private:
             calculator.addTrade(testTrades[i]);
         }
 
+        perf.start();
         auto startTotal = high_resolution_clock::now();
 
         for (size_t i = WARMUP_MESSAGES; i < NUM_MESSAGES; ++i) {
@@ -128,6 +249,7 @@ private:
         }
 
         auto endTotal = high_resolution_clock::now();
+        countersStop("VWAP Calculation", NUM_MESSAGES - WARMUP_MESSAGES);
 
         return calculateStats(latencies, startTotal, endTotal);
     }
@@ -170,6 +292,7 @@ private:
             manager.processTrade(testTrades[i]);
         }
 
+        perf.start();
         auto startTotal = high_resolution_clock::now();
 
         for (size_t i = 100; i < NUM_MESSAGES; ++i) {
@@ -182,6 +305,7 @@ private:
         }
 
         auto endTotal = high_resolution_clock::now();
+        countersStop("Order Processing", NUM_MESSAGES - 100);
 
         return calculateStats(latencies, startTotal, endTotal);
     }
@@ -214,12 +338,14 @@ private:
     void benchmarkMemoryAllocations() {
         const size_t NUM_ALLOCS = 100000;
 
+        perf.start();
         auto start = high_resolution_clock::now();
         for (size_t i = 0; i < NUM_ALLOCS; ++i) {
             std::vector<uint8_t>* vec = new std::vector<uint8_t>(256);
             delete vec;
         }
         auto end = high_resolution_clock::now();
+        countersStop("Dynamic (new/del)", NUM_ALLOCS);
         double dynamicTimeUs = duration<double, std::micro>(end - start).count();
 
     std::cout << "Allocation Type    | Time (µs) | Ops/sec" << std::endl;
@@ -229,10 +355,461 @@ private:
           << std::setw(8) << static_cast<size_t>(NUM_ALLOCS / (dynamicTimeUs / 1000000.0)) << std::endl;
     }
 
+    void benchmarkOrderSerialization() {
+        const size_t ITERATIONS = 1000000;
+        uint8_t wire[WireFormat::ORDER_SIZE];
+        uint64_t checksum = 0;
+
+        OrderMessage order;
+        std::memcpy(order.symbol, "IBM", 3);
+        order.side = 'B';
+
+        perf.start();
+        auto start = high_resolution_clock::now();
+        for (size_t i = 0; i < ITERATIONS; ++i) {
+            const QuoteMessage& q = testQuotes[i % NUM_MESSAGES];
+            order.timestamp = q.timestamp;
+            order.quantity = q.askQuantity;
+            order.price = q.askPrice;
+            MessageSerializer::serializeOrder(wire, sizeof(wire), order);
+            checksum += wire[WireFormat::ORDER_QUANTITY_OFFSET];
+        }
+        auto end = high_resolution_clock::now();
+        countersStop("serializeOrder", ITERATIONS);
+        double serializeNs = duration<double, std::nano>(end - start).count() / ITERATIONS;
+
+        OrderTemplate tmpl("IBM", 3, 'B');
+        perf.start();
+        start = high_resolution_clock::now();
+        for (size_t i = 0; i < ITERATIONS; ++i) {
+            const QuoteMessage& q = testQuotes[i % NUM_MESSAGES];
+            const uint8_t* out = tmpl.patch(q.timestamp, q.askQuantity, q.askPrice);
+            checksum += out[WireFormat::ORDER_QUANTITY_OFFSET];
+        }
+        end = high_resolution_clock::now();
+        countersStop("OrderTemplate", ITERATIONS);
+        double templateNs = duration<double, std::nano>(end - start).count() / ITERATIONS;
+
+        volatile uint64_t sink = checksum;
+        (void)sink;
+
+        std::cout << "Encoder            | ns/order" << std::endl;
+        std::cout << "-------------------|---------" << std::endl;
+        std::cout << "serializeOrder     | " << std::setw(8) << std::fixed << std::setprecision(2) << serializeNs << std::endl;
+        std::cout << "OrderTemplate      | " << std::setw(8) << templateNs << std::endl;
+        if (templateNs > 0) {
+            std::cout << "Speedup: " << std::setprecision(2) << (serializeNs / templateNs) << "x" << std::endl;
+        }
+    }
+
+    void benchmarkMessageParsing() {
+        const size_t ITERATIONS = 1000000;
+        std::vector<uint8_t> quoteWire(NUM_MESSAGES * WireFormat::QUOTE_SIZE);
+        std::vector<uint8_t> tradeWire(NUM_MESSAGES * WireFormat::TRADE_SIZE);
+        for (size_t i = 0; i < NUM_MESSAGES; ++i) {
+            MessageSerializer::serializeQuote(&quoteWire[i * WireFormat::QUOTE_SIZE], WireFormat::QUOTE_SIZE, testQuotes[i]);
+            MessageSerializer::serializeTrade(&tradeWire[i * WireFormat::TRADE_SIZE], WireFormat::TRADE_SIZE, testTrades[i]);
+        }
+        uint64_t checksum = 0;
+
+        perf.start();
+        auto start = high_resolution_clock::now();
+        for (size_t i = 0; i < ITERATIONS; ++i) {
+            const uint8_t* body = &quoteWire[(i % NUM_MESSAGES) * WireFormat::QUOTE_SIZE];
+            QuoteMessage q;
+            if (MessageParser::parseQuote(body, WireFormat::QUOTE_SIZE, q) && MessageParser::validateQuote(q)) {
+                checksum += q.bidPrice + static_cast<uint32_t>(q.askPrice);
+            }
+        }
+        auto end = high_resolution_clock::now();
+        countersStop("parseQuote + validate", ITERATIONS);
+        double parseQuoteNs = duration<double, std::nano>(end - start).count() / ITERATIONS;
+
+        perf.start();
+        start = high_resolution_clock::now();
+        for (size_t i = 0; i < ITERATIONS; ++i) {
+            QuoteView view(&quoteWire[(i % NUM_MESSAGES) * WireFormat::QUOTE_SIZE]);
+            if (view.valid()) {
+                checksum += view.bidPrice() + static_cast<uint32_t>(view.askPrice());
+            }
+        }
+        end = high_resolution_clock::now();
+        countersStop("QuoteView", ITERATIONS);
+        double viewQuoteNs = duration<double, std::nano>(end - start).count() / ITERATIONS;
+
+        perf.start();
+        start = high_resolution_clock::now();
+        for (size_t i = 0; i < ITERATIONS; ++i) {
+            QuoteView view(&quoteWire[(i % NUM_MESSAGES) * WireFormat::QUOTE_SIZE]);
+            if (view.valid()) {
+                QuoteMessage q = view.toMessage();
+                checksum += q.bidPrice + static_cast<uint32_t>(q.askPrice);
+            }
+        }
+        end = high_resolution_clock::now();
+        countersStop("QuoteView + materialize", ITERATIONS);
+        double materializeQuoteNs = duration<double, std::nano>(end - start).count() / ITERATIONS;
+
+        perf.start();
+        start = high_resolution_clock::now();
+        for (size_t i = 0; i < ITERATIONS; ++i) {
+            const uint8_t* body = &tradeWire[(i % NUM_MESSAGES) * WireFormat::TRADE_SIZE];
+            TradeMessage t;
+            if (MessageParser::parseTrade(body, WireFormat::TRADE_SIZE, t) && MessageParser::validateTrade(t)) {
+                checksum += t.quantity;
+            }
+        }
+        end = high_resolution_clock::now();
+        countersStop("parseTrade + validate", ITERATIONS);
+        double parseTradeNs = duration<double, std::nano>(end - start).count() / ITERATIONS;
+
+        perf.start();
+        start = high_resolution_clock::now();
+        for (size_t i = 0; i < ITERATIONS; ++i) {
+            TradeView view(&tradeWire[(i % NUM_MESSAGES) * WireFormat::TRADE_SIZE]);
+            if (view.valid()) {
+                checksum += view.quantity();
+            }
+        }
+        end = high_resolution_clock::now();
+        countersStop("TradeView", ITERATIONS);
+        double viewTradeNs = duration<double, std::nano>(end - start).count() / ITERATIONS;
+
+        volatile uint64_t sink = checksum;
+        (void)sink;
+
+        std::cout << "Decoder                  | ns/msg" << std::endl;
+        std::cout << "-------------------------|-------" << std::endl;
+        std::cout << "parseQuote + validate    | " << std::setw(6) << std::fixed << std::setprecision(2) << parseQuoteNs << std::endl;
+        std::cout << "QuoteView                | " << std::setw(6) << viewQuoteNs << std::endl;
+        std::cout << "QuoteView + materialize  | " << std::setw(6) << materializeQuoteNs << std::endl;
+        std::cout << "parseTrade + validate    | " << std::setw(6) << parseTradeNs << std::endl;
+        std::cout << "TradeView                | " << std::setw(6) << viewTradeNs << std::endl;
+    }
+
+    template<typename Fn>
+    double nanosPerOp(const char* name, size_t iterations, Fn&& fn) {
+        perf.start();
+        auto start = high_resolution_clock::now();
+        for (size_t i = 0; i < iterations; ++i) fn(i);
+        auto end = high_resolution_clock::now();
+        countersStop(name, iterations);
+        return duration<double, std::nano>(end - start).count() / iterations;
+    }
+
+    void benchmarkSchemaCodec() {
+        const size_t ITERATIONS = 1000000;
+        std::vector<uint8_t> quoteWire(NUM_MESSAGES * WireFormat::QUOTE_SIZE);
+        for (size_t i = 0; i < NUM_MESSAGES; ++i) {
+            QuoteSchema::encode(testQuotes[i], &quoteWire[i * WireFormat::QUOTE_SIZE]);
+        }
+        uint64_t checksum = 0;
+
+        double handDecode = nanosPerOp("Quote decode (handwritten)", ITERATIONS, [&](size_t i) {
+            QuoteMessage q;
+            HandwrittenCodec::parseQuote(&quoteWire[(i % NUM_MESSAGES) * WireFormat::QUOTE_SIZE], q);
+            if (HandwrittenCodec::validateQuote(q)) checksum += q.bidPrice;
+        });
+        double schemaDecode = nanosPerOp("Quote decode (schema)", ITERATIONS, [&](size_t i) {
+            QuoteMessage q;
+            QuoteSchema::decode(&quoteWire[(i % NUM_MESSAGES) * WireFormat::QUOTE_SIZE], q);
+            if (QuoteSchema::valid(q)) checksum += q.bidPrice;
+        });
+
+        uint8_t wire[WireFormat::ORDER_SIZE];
+        OrderMessage order;
+        std::memcpy(order.symbol, "IBM", 3);
+        order.side = 'B';
+        double handEncode = nanosPerOp("Order encode (handwritten)", ITERATIONS, [&](size_t i) {
+            const QuoteMessage& q = testQuotes[i % NUM_MESSAGES];
+            order.timestamp = q.timestamp; order.quantity = q.askQuantity; order.price = q.askPrice;
+            HandwrittenCodec::serializeOrder(wire, order);
+            checksum += wire[WireFormat::ORDER_QUANTITY_OFFSET];
+        });
+        double schemaEncode = nanosPerOp("Order encode (schema)", ITERATIONS, [&](size_t i) {
+            const QuoteMessage& q = testQuotes[i % NUM_MESSAGES];
+            order.timestamp = q.timestamp; order.quantity = q.askQuantity; order.price = q.askPrice;
+            OrderSchema::encode(order, wire);
+            checksum += wire[WireFormat::ORDER_QUANTITY_OFFSET];
+        });
+
+        volatile uint64_t sink = checksum;
+        (void)sink;
+
+        std::cout << "Codec                      | handwritten | schema (ns/msg)" << std::endl;
+        std::cout << "---------------------------|-------------|----------------" << std::endl;
+        std::cout << "Quote decode + validate    | " << std::setw(11) << std::fixed << std::setprecision(2) << handDecode
+                  << " | " << std::setw(8) << schemaDecode << std::endl;
+        std::cout << "Order encode               | " << std::setw(11) << handEncode
+                  << " | " << std::setw(8) << schemaEncode << std::endl;
+    }
+
+    static uint64_t steadyNanos() {
+        return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Spins briefly, then yields so the peer thread can run when both share a core.
+    static void relax(unsigned& idle) {
+        if (++idle > 256) std::this_thread::yield();
+    }
+
+    // One frame in flight at a time: the sender stamps a trade with the send
+    // time and waits until the busy-polling receiver has decoded it, so each
+    // sample is a one-way latency without queueing behind earlier frames.
+    template<typename SendFn, typename ReceiveFn>
+    std::vector<double> oneWayLatencies(size_t count, SendFn&& sendFrame, ReceiveFn&& receiveBytes) {
+        constexpr size_t FRAME = WireFormat::HEADER_SIZE + WireFormat::TRADE_SIZE;
+        std::vector<double> latencies;
+        latencies.reserve(count);
+        std::atomic<size_t> received{0};
+
+        std::thread reader([&] {
+            uint8_t pending[4096 + FRAME];
+            size_t have = 0;
+            unsigned idle = 0;
+            while (received.load(std::memory_order_relaxed) < count) {
+                ssize_t n = receiveBytes(pending + have, sizeof(pending) - have);
+                if (n <= 0) {
+                    relax(idle);
+                    continue;
+                }
+                idle = 0;
+                have += static_cast<size_t>(n);
+                size_t used = 0;
+                for (; have - used >= FRAME; used += FRAME) {
+                    uint64_t sent;
+                    std::memcpy(&sent, pending + used + WireFormat::HEADER_SIZE + WireFormat::TRADE_TIMESTAMP_OFFSET, sizeof(sent));
+                    latencies.push_back(static_cast<double>(steadyNanos() - sent));
+                    received.fetch_add(1, std::memory_order_release);
+                }
+                std::memmove(pending, pending + used, have - used);
+                have -= used;
+            }
+        });
+
+        uint8_t frame[FRAME];
+        TradeMessage trade = testTrades[0];
+        for (size_t i = 0; i < count; ++i) {
+            trade.timestamp = steadyNanos();
+            MessageSerializer::serializeTradeMessage(frame, sizeof(frame), trade);
+            sendFrame(frame, sizeof(frame));
+            unsigned idle = 0;
+            while (received.load(std::memory_order_acquire) <= i) relax(idle);
+        }
+        reader.join();
+        return latencies;
+    }
+
+    // Buffer sizes must be set before connecting to shape the TCP window, so
+    // a tuning is applied to the listener (inherited on accept) and sender
+    // first, then again to the accepted socket.
+    static bool openLoopback(int& sender, int& receiver, const SocketTuning* tuning = nullptr) {
+        SocketTuning::Applied applied;
+        int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listener < 0) return false;
+        if (tuning) tuning->apply(listener, applied);
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        bool ok = ::bind(listener, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0 &&
+                  ::listen(listener, 1) == 0 &&
+                  ::getsockname(listener, reinterpret_cast<struct sockaddr*>(&addr), &len) == 0;
+        sender = ok ? ::socket(AF_INET, SOCK_STREAM, 0) : -1;
+        if (tuning && sender >= 0) tuning->apply(sender, applied);
+        ok = sender >= 0 && ::connect(sender, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0;
+        receiver = ok ? ::accept(listener, nullptr, nullptr) : -1;
+        ::close(listener);
+        if (tuning && receiver >= 0) tuning->apply(receiver, applied);
+        if (receiver < 0) {
+            if (sender >= 0) ::close(sender);
+            return false;
+        }
+        int one = 1;
+        setsockopt(sender, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        fcntl(receiver, F_SETFL, fcntl(receiver, F_GETFL, 0) | O_NONBLOCK);
+        return true;
+    }
+
+    // A negative streamRate leaves out the throughput column.
+    void printTransportRow(const char* name, std::vector<double>& latencies, double streamRate = -1) {
+        if (latencies.empty()) {
+            std::cout << name << " | unavailable" << std::endl;
+            return;
+        }
+        std::sort(latencies.begin(), latencies.end());
+        double sum = 0;
+        for (double ns : latencies) sum += ns;
+        std::cout << name << " | " << std::setw(8) << std::fixed << std::setprecision(0) << (sum / latencies.size())
+                  << " | " << std::setw(8) << latencies[latencies.size() / 2]
+                  << " | " << std::setw(8) << latencies[latencies.size() * 99 / 100];
+        if (streamRate >= 0) std::cout << " | " << std::setw(12) << std::setprecision(2) << (streamRate / 1e6);
+        std::cout << std::endl;
+    }
+
+    void benchmarkShmTransport() {
+        const size_t MESSAGES = 20000;
+
+        const std::string ringName = "vwap_bench_" + std::to_string(::getpid());
+        std::vector<double> shmLatencies;
+        {
+            ShmRingWriter writer;
+            ShmRingReader reader;
+            if (writer.create(ringName) && reader.open(ringName)) {
+                uint64_t lost = 0;
+                shmLatencies = oneWayLatencies(MESSAGES,
+                    [&](const uint8_t* data, size_t size) { writer.publish(data, size); },
+                    [&](uint8_t* out, size_t max) { return reader.read(out, max, lost); });
+            }
+        }
+        std::remove(ShmRing::path(ringName).c_str());
+
+        std::vector<double> tcpLatencies;
+        int sender, receiver;
+        if (openLoopback(sender, receiver)) {
+            tcpLatencies = oneWayLatencies(MESSAGES,
+                [&](const uint8_t* data, size_t size) { ::send(sender, data, size, MSG_NOSIGNAL); },
+                [&](uint8_t* out, size_t max) { return ::recv(receiver, out, max, 0); });
+            ::close(sender);
+            ::close(receiver);
+        }
+
+        std::cout << "One-way latency, " << MESSAGES << " trades, one in flight" << std::endl;
+        std::cout << "Transport    |  mean ns |   p50 ns |   p99 ns" << std::endl;
+        std::cout << "-------------|----------|----------|---------" << std::endl;
+        printTransportRow("shm ring    ", shmLatencies);
+        printTransportRow("TCP loopback", tcpLatencies);
+    }
+
+    // Streams count trade frames as fast as the sender can write them and
+    // returns the receive rate in frames per second.
+    double streamThroughput(int sender, int receiver, size_t count, bool quickAck) {
+        constexpr size_t FRAME = WireFormat::HEADER_SIZE + WireFormat::TRADE_SIZE;
+        constexpr size_t BURST = 64;
+        uint8_t burst[BURST * FRAME];
+        for (size_t i = 0; i < BURST; ++i) {
+            MessageSerializer::serializeTradeMessage(burst + i * FRAME, FRAME, testTrades[i]);
+        }
+
+        auto start = steady_clock::now();
+        std::thread writer([&] {
+            for (size_t sent = 0; sent < count; sent += BURST) {
+                size_t off = 0;
+                while (off < sizeof(burst)) {
+                    ssize_t n = ::send(sender, burst + off, sizeof(burst) - off, MSG_NOSIGNAL);
+                    if (n <= 0) return;
+                    off += static_cast<size_t>(n);
+                }
+            }
+        });
+
+        const size_t total = (count + BURST - 1) / BURST * BURST * FRAME;
+        size_t got = 0;
+        uint8_t buffer[65536];
+        unsigned idle = 0;
+        while (got < total) {
+            ssize_t n = ::recv(receiver, buffer, sizeof(buffer), 0);
+            if (n <= 0) {
+                relax(idle);
+                continue;
+            }
+            idle = 0;
+            got += static_cast<size_t>(n);
+            if (quickAck) {
+                int one = 1;
+                setsockopt(receiver, IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one));
+            }
+        }
+        writer.join();
+        return static_cast<double>(total / FRAME) / duration<double>(steady_clock::now() - start).count();
+    }
+
+    void benchmarkSocketProfiles() {
+        const size_t MESSAGES = 20000;
+        const size_t STREAMED = 1000000;
+        const SocketTuning profiles[] = {SocketTuning::standard(), SocketTuning::latency(), SocketTuning::throughput()};
+
+        std::cout << "TCP loopback, " << MESSAGES << " trades one in flight, then " << STREAMED << " streamed" << std::endl;
+        std::cout << "Profile    |  mean ns |   p50 ns |   p99 ns | stream Mmsg/s" << std::endl;
+        std::cout << "-----------|----------|----------|----------|--------------" << std::endl;
+        for (const SocketTuning& profile : profiles) {
+            std::vector<double> latencies;
+            double rate = 0;
+            int sender, receiver;
+            if (openLoopback(sender, receiver, &profile)) {
+                latencies = oneWayLatencies(MESSAGES,
+                    [&](const uint8_t* data, size_t size) { ::send(sender, data, size, MSG_NOSIGNAL); },
+                    [&](uint8_t* out, size_t max) {
+                        ssize_t n = ::recv(receiver, out, max, 0);
+                        if (n > 0 && profile.quickAck) {
+                            int one = 1;
+                            setsockopt(receiver, IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one));
+                        }
+                        return n;
+                    });
+                rate = streamThroughput(sender, receiver, STREAMED, profile.quickAck);
+                ::close(sender);
+                ::close(receiver);
+            }
+            char name[16];
+            std::snprintf(name, sizeof(name), "%-10s", profile.name.c_str());
+            printTransportRow(name, latencies, rate);
+        }
+    }
+
+    // Mean log() cost over rounds that stay below the per-thread ring
+    // capacity, so drops do not flatter the result.
+    double measureAsyncLogger(bool timestamps, size_t records, size_t rounds, uint64_t& dropped) {
+        FILE* sink = std::fopen("/dev/null", "w");
+        if (!sink) return -1;
+        AsyncLogger logger;
+        logger.start(sink, timestamps);
+
+        double totalNs = 0;
+        // The sleeps between rounds run in the kernel and stay out of the counts.
+        if (!timestamps) perf.start();
+        for (size_t round = 0; round < rounds; ++round) {
+            auto start = high_resolution_clock::now();
+            for (size_t i = 0; i < records; ++i) {
+                const TradeMessage& t = testTrades[i];
+                logger.log(LogLevel::INFO, LogFmt::MANAGER_VWAP_UPDATE, static_cast<double>(t.price), static_cast<uint64_t>(i));
+            }
+            auto end = high_resolution_clock::now();
+            totalNs += duration<double, std::nano>(end - start).count();
+            std::this_thread::sleep_for(milliseconds(5));
+        }
+        if (!timestamps) countersStop("log() hot path", records * rounds);
+        logger.stop();
+        std::fclose(sink);
+        dropped = logger.droppedRecords();
+        return totalNs / static_cast<double>(records * rounds);
+    }
+
+    void benchmarkAsyncLogger() {
+        const size_t RECORDS = 2000;
+        const size_t ROUNDS = 50;
+        uint64_t dropped = 0, droppedStamped = 0;
+        const double plainNs = measureAsyncLogger(false, RECORDS, ROUNDS, dropped);
+        if (plainNs < 0) {
+            std::cout << "Skipped: /dev/null unavailable" << std::endl;
+            return;
+        }
+        const double stampedNs = measureAsyncLogger(true, RECORDS, ROUNDS, droppedStamped);
+
+        std::cout << "Records logged:   " << (RECORDS * ROUNDS) << " per mode" << std::endl;
+        std::cout << "Dropped:          " << (dropped + droppedStamped) << std::endl;
+        std::cout << "Hot path cost:    " << std::fixed << std::setprecision(1)
+                  << plainNs << " ns/record (target < 50 ns)" << std::endl;
+        // File logging prints a timestamp, which costs a TSC read per record.
+        std::cout << "With timestamps:  " << stampedNs << " ns/record" << std::endl;
+    }
+
     BenchmarkResult benchmarkEndToEnd() {
         OrderManager manager("IBM", 'B', 100, 5);
         std::vector<double> latencies;
 
+        perf.start();
         auto startTotal = high_resolution_clock::now();
 
         for (size_t i = 0; i < NUM_MESSAGES; ++i) {
@@ -250,6 +827,7 @@ private:
         }
 
         auto endTotal = high_resolution_clock::now();
+        countersStop("End-to-End", NUM_MESSAGES);
 
         return calculateStats(latencies, startTotal, endTotal);
     }
@@ -304,6 +882,52 @@ private:
         return result;
     }
 
+    void countersStop(const char* name, size_t messages) {
+        if (!perf.isOpen()) return;
+        counterRows.push_back({name, perf.stop(), messages});
+    }
+
+    static void printPerMessage(const PerfCounters::Reading& r, PerfCounters::Event event, size_t messages) {
+        if (!r.counted[event]) {
+            std::cout << " | " << std::setw(8) << "-";
+            return;
+        }
+        std::cout << " | " << std::setw(8) << std::fixed << std::setprecision(event <= PerfCounters::INSTRUCTIONS ? 1 : 3)
+                  << static_cast<double>(r.values[event]) / messages;
+    }
+
+    // Prints and clears the rows collected since the last call.
+    void printCounters() {
+        if (counterRows.empty()) return;
+        std::cout << "\nHardware counters per message:" << std::endl;
+        std::cout << "Loop                       |   cycles |    instr |      IPC | L1D miss | LLC miss |  br miss" << std::endl;
+        std::cout << "---------------------------|----------|----------|----------|----------|----------|---------" << std::endl;
+        for (const CounterRow& row : counterRows) {
+            std::cout << std::left << std::setw(26) << row.name << std::right;
+            const PerfCounters::Reading& r = row.reading;
+            if (!r.valid() || row.messages == 0) {
+                std::cout << " | not scheduled on the PMU" << std::endl;
+                continue;
+            }
+            printPerMessage(r, PerfCounters::CYCLES, row.messages);
+            printPerMessage(r, PerfCounters::INSTRUCTIONS, row.messages);
+            if (r.counted[PerfCounters::INSTRUCTIONS] && r.values[PerfCounters::CYCLES] > 0) {
+                std::cout << " | " << std::setw(8) << std::setprecision(2)
+                          << static_cast<double>(r.values[PerfCounters::INSTRUCTIONS]) / r.values[PerfCounters::CYCLES];
+            } else {
+                std::cout << " | " << std::setw(8) << "-";
+            }
+            printPerMessage(r, PerfCounters::L1D_MISSES, row.messages);
+            printPerMessage(r, PerfCounters::LLC_MISSES, row.messages);
+            printPerMessage(r, PerfCounters::BRANCH_MISSES, row.messages);
+            if (r.coverage < 1.0) {
+                std::cout << "  (scaled, on PMU " << std::setprecision(0) << r.coverage * 100 << "%)";
+            }
+            std::cout << std::endl;
+        }
+        counterRows.clear();
+    }
+
     void printResult(const std::string& name, const BenchmarkResult& result) {
         std::cout << "\n" << name << " Performance:" << std::endl;
         std::cout << "  Mean latency:    " << std::fixed << std::setprecision(3)
@@ -362,8 +986,18 @@ private:
     }
 };
 
-int main() {
-    PerformanceBenchmark benchmark;
+int main(int argc, char* argv[]) {
+    bool hardwareCounters = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--perf") == 0) {
+            hardwareCounters = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--perf]" << std::endl;
+            std::cerr << "  --perf  Report cycles, instructions, cache and branch misses per message" << std::endl;
+            return 2;
+        }
+    }
+    PerformanceBenchmark benchmark(hardwareCounters);
     benchmark.runAllBenchmarks();
     return 0;
 }
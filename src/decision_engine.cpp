@@ -4,6 +4,7 @@
 #include <cstring>
 #include <chrono>
 #include "metrics.h"
+#include "async_logger.h"
 
 bool DecisionEngine::QuoteIdentifier::operator==(const QuoteIdentifier& other) const noexcept {
     return timestamp == other.timestamp &&
@@ -27,19 +28,23 @@ DecisionEngine::DecisionEngine(const std::string& symbol, char side, uint32_t ma
             rejCooldown(0),
             rejDuplicate(0) {}
 
-void DecisionEngine::onVwapWindowComplete() {
+void DecisionEngine::onVwapWindowComplete(bool announce) {
     if (currentState == TradingState::WAITING_FOR_FIRST_WINDOW) {
         currentState = TradingState::READY_TO_TRADE;
-        std::cout << "Decision Engine: First VWAP window complete, ready to trade" << std::endl;
+        if (announce) std::cout << "Decision Engine: First VWAP window complete, ready to trade" << std::endl;
     }
 }
 
 Optional<OrderMessage> DecisionEngine::evaluateQuote(const QuoteMessage& quote, double vwap) {
+    if (side == 'B') return evaluateQuote(quote.timestamp, quote.askPrice, quote.askQuantity, vwap);
+    return evaluateQuote(quote.timestamp, static_cast<int32_t>(quote.bidPrice), quote.bidQuantity, vwap);
+}
+
+Optional<OrderMessage> DecisionEngine::evaluateQuote(uint64_t timestamp, int32_t price,
+                                                     uint32_t quantity, double vwap) {
     quotesProcessed++;
-    extern SystemMetrics g_systemMetrics;
-    g_systemMetrics.hot.quotesProcessed.fetch_add(1, std::memory_order_relaxed);
     auto wallStart = std::chrono::steady_clock::now();
-    uint64_t currentTime = quote.timestamp;
+    uint64_t currentTime = timestamp;
     struct LatencyScope {
         std::chrono::steady_clock::time_point start;
         ~LatencyScope() {
@@ -63,7 +68,7 @@ Optional<OrderMessage> DecisionEngine::evaluateQuote(const QuoteMessage& quote,
     return Optional<OrderMessage>();
     }
 
-    if (isDuplicateQuote(quote)) {
+    if (isDuplicateQuote({timestamp, price, quantity})) {
     recordDecision({
             Decision::REJECTED_DUPLICATE,
             currentTime,
@@ -91,18 +96,10 @@ Optional<OrderMessage> DecisionEngine::evaluateQuote(const QuoteMessage& quote,
     return Optional<OrderMessage>();
     }
 
-    double relevantPrice;
-    uint32_t relevantQuantity;
+    double relevantPrice = price;
+    uint32_t relevantQuantity = quantity;
 
-    if (side == 'B') {
-        relevantPrice = quote.askPrice;
-        relevantQuantity = quote.askQuantity;
-    } else {
-        relevantPrice = quote.bidPrice;
-        relevantQuantity = quote.bidQuantity;
-    }
-
-    if (!shouldTriggerOrder(quote, vwap)) {
+    if (!shouldTriggerOrder(price, vwap)) {
     recordDecision({
             Decision::REJECTED_PRICE_UNFAVORABLE,
             currentTime,
@@ -118,11 +115,11 @@ Optional<OrderMessage> DecisionEngine::evaluateQuote(const QuoteMessage& quote,
 
     uint32_t orderSize = calculateOrderSize(relevantQuantity);
 
-    OrderMessage order = buildOrder(quote, orderSize);
+    OrderMessage order = buildOrder(timestamp, price, orderSize);
 
     currentState = TradingState::ORDER_SENT;
     lastOrderTimestamp = currentTime;
-    lastProcessedQuote = {quote.timestamp, static_cast<int32_t>(relevantPrice), relevantQuantity};
+    lastProcessedQuote = {timestamp, price, quantity};
 
     recordDecision({
         Decision::ORDER_TRIGGERED,
@@ -141,15 +138,15 @@ Optional<OrderMessage> DecisionEngine::evaluateQuote(const QuoteMessage& quote,
     return Optional<OrderMessage>(order);
 }
 
-bool DecisionEngine::shouldTriggerOrder(const QuoteMessage& quote, double vwap) const noexcept {
+bool DecisionEngine::shouldTriggerOrder(int32_t price, double vwap) const noexcept {
     if (vwap <= 0) {
         return false;
     }
 
     if (side == 'B') {
-        return static_cast<double>(quote.askPrice) < vwap;
+        return static_cast<double>(price) < vwap;
     } else {
-        return static_cast<double>(quote.bidPrice) > vwap;
+        return static_cast<double>(price) > vwap;
     }
 }
 
@@ -157,15 +154,7 @@ uint32_t DecisionEngine::calculateOrderSize(uint32_t quoteSize) const noexcept {
     return std::min(quoteSize, maxOrderSize);
 }
 
-bool DecisionEngine::isDuplicateQuote(const QuoteMessage& quote) const noexcept {
-    QuoteIdentifier current;
-
-    if (side == 'B') {
-        current = {quote.timestamp, static_cast<int32_t>(quote.askPrice), quote.askQuantity};
-    } else {
-        current = {quote.timestamp, static_cast<int32_t>(quote.bidPrice), quote.bidQuantity};
-    }
-
+bool DecisionEngine::isDuplicateQuote(const QuoteIdentifier& current) const noexcept {
     return current == lastProcessedQuote;
 }
 
@@ -184,18 +173,12 @@ void DecisionEngine::recordDecision(const Decision& decision) {
     }
 
     if (decision.type == Decision::ORDER_TRIGGERED) {
-        std::cout << "[ORDER] "
-                  << (side == 'B' ? "BUY" : "SELL")
-                  << " " << decision.orderSize
-                  << " @ $" << std::fixed << std::setprecision(2)
-                  << (decision.quotePrice / 100.0)
-                  << " (VWAP: $" << (decision.vwap / 100.0) << ")"
-                  << " Reason: " << decision.reason
-                  << std::endl;
+        VWAP_LOG_INFO(LogFmt::DECISION_ORDER, side, decision.orderSize,
+                      decision.quotePrice, decision.vwap, decision.reason);
     }
 }
 
-OrderMessage DecisionEngine::buildOrder(const QuoteMessage& quote, uint32_t orderSize) const {
+OrderMessage DecisionEngine::buildOrder(uint64_t timestamp, int32_t price, uint32_t orderSize) const {
     OrderMessage order;
 
     std::memcpy(order.symbol, symbol.c_str(),
@@ -205,17 +188,13 @@ OrderMessage DecisionEngine::buildOrder(const QuoteMessage& quote, uint32_t orde
         order.symbol[i] = '\0';
     }
 
-    order.timestamp = quote.timestamp;
+    order.timestamp = timestamp;
 
     order.side = side;
 
     order.quantity = orderSize;
 
-    if (side == 'B') {
-        order.price = static_cast<int32_t>(quote.askPrice);
-    } else {
-        order.price = static_cast<int32_t>(quote.bidPrice);
-    }
+    order.price = price;
 
     return order;
 }
@@ -0,0 +1,80 @@
+#include "line_arbiter.h"
+#include "metrics.h"
+#include <cstring>
+#include <cstdio>
+
+namespace {
+inline uint64_t mix(uint64_t h, uint64_t v) noexcept {
+    h ^= v * 0x9E3779B97F4A7C15ULL;
+    h = (h << 27) | (h >> 37);
+    return h * 0xC2B2AE3D27D4EB4FULL;
+}
+}
+
+LineArbiter::LineArbiter(size_t lineCount)
+    : entries(BUCKETS * WAYS, Entry{0, 0, 0}),
+      lines(lineCount < MAX_LINES ? lineCount : MAX_LINES),
+      nextSequence(0) {
+}
+
+uint64_t LineArbiter::fingerprint(uint8_t type, const uint8_t* body, size_t length) noexcept {
+    uint64_t h = mix(0x51ED270B27CB5F3DULL, type);
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, body + i, sizeof(word));
+        h = mix(h, word);
+    }
+    if (i < length) {
+        uint64_t tail = 0;
+        std::memcpy(&tail, body + i, length - i);
+        h = mix(h, tail);
+    }
+    h ^= h >> 31;
+    return h ? h : 1;
+}
+
+bool LineArbiter::admit(size_t line, uint8_t type, const uint8_t* body, size_t length, uint64_t nowNanos) noexcept {
+    if (line >= lines.size()) return false;
+    const uint64_t fp = fingerprint(type, body, length);
+    Entry* bucket = &entries[(fp & (BUCKETS - 1)) * WAYS];
+
+    Entry* victim = bucket;
+    for (size_t w = 0; w < WAYS; ++w) {
+        Entry& e = bucket[w];
+        if (!live(e)) {
+            if (live(*victim)) victim = &e;
+            continue;
+        }
+        if (e.fingerprint == fp) {
+            LineStats& s = lines[line];
+            uint64_t lag = nowNanos > e.firstSeenNanos ? nowNanos - e.firstSeenNanos : 0;
+            ++s.duplicates;
+            s.lagTotalNanos += lag;
+            if (lag > s.lagMaxNanos) s.lagMaxNanos = lag;
+            g_systemMetrics.feed.lineDuplicates.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (live(*victim) && e.sequence < victim->sequence) victim = &e;
+    }
+
+    // A full bucket of live entries evicts its oldest; the window is then
+    // slightly shorter for that bucket only.
+    victim->fingerprint = fp;
+    victim->firstSeenNanos = nowNanos;
+    victim->sequence = ++nextSequence;
+    ++lines[line].wins;
+    return true;
+}
+
+void LineArbiter::printStatistics() const {
+    std::printf("Feed lines: %zu  unique messages: %llu\n", lines.size(), (unsigned long long)nextSequence);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        const LineStats& s = lines[i];
+        double winRate = nextSequence ? 100.0 * (double)s.wins / (double)nextSequence : 0.0;
+        double avgLag = s.duplicates ? (double)s.lagTotalNanos / (double)s.duplicates : 0.0;
+        std::printf("  Line %zu: wins=%llu (%.1f%%) late copies=%llu lag ns avg/max: %.0f/%llu\n",
+            i, (unsigned long long)s.wins, winRate, (unsigned long long)s.duplicates,
+            avgLag, (unsigned long long)s.lagMaxNanos);
+    }
+}
@@ -5,11 +5,21 @@
 #include <csignal>
 #include <chrono>
 #include <iomanip>
+#include <unistd.h>
 #include "config.h"
 #include "order_manager.h"
 #include "network_manager.h"
 #include "message.h"
 #include "metrics.h"
+#include "runtime_config.h"
+#include "async_logger.h"
+#include "realtime.h"
+#include "warmup.h"
+#include "rate_meter.h"
+#include "stats_segment.h"
+#include "metrics_http.h"
+#include "shm_ring.h"
+#include "trace.h"
 
 volatile sig_atomic_t g_shutdown_requested = 0;
 
@@ -121,6 +131,7 @@ void print_config(const Config& config) {
     std::cout << "\nNetwork Configuration:" << std::endl;
     std::cout << "  Market Data: " << config.marketDataHost << ":" << config.marketDataPort << std::endl;
     std::cout << "  Order Server: " << config.orderHost << ":" << config.orderPort << std::endl;
+    runtimeConfig().print();
     std::cout << "==========================================\n" << std::endl;
 }
 
@@ -131,6 +142,142 @@ void print_startup_banner() {
     std::cout << "╚═══════════════════════════════════════╝" << std::endl;
 }
 
+// Pins and prioritises the trading threads and makes the hot structures
+// resident, then reports where each thread may run. Runs once every
+// connection and the logger are up, before the first market data is read.
+void prepare_threads(NetworkManagerBase& network, OrderManager& orderManager, bool loggerStarted) {
+    const RuntimeConfig& cfg = runtimeConfig();
+    const pthread_t eventLoop = pthread_self();
+    if (cfg.eventLoopCpu >= 0) Realtime::pinThread(eventLoop, cfg.eventLoopCpu);
+    if (cfg.loggerCpu >= 0 && loggerStarted) Realtime::pinThread(g_asyncLogger.writerThread(), cfg.loggerCpu);
+    if (cfg.fifoPriority > 0) Realtime::setFifoPriority(eventLoop, cfg.fifoPriority);
+
+    if (cfg.prefault) {
+        orderManager.prefault();
+        network.prefault();
+    }
+    if (cfg.lockMemory) Realtime::lockMemory();
+
+    std::cout << "Thread placement:" << std::endl;
+    Realtime::reportThread("event loop", eventLoop);
+    if (loggerStarted) Realtime::reportThread("async logger", g_asyncLogger.writerThread());
+}
+
+// Strategy callbacks bound to the network layer at compile time.
+struct TradingHandler {
+    OrderManager& orderManager;
+    BasicNetworkManager<TradingHandler>* network;
+    uint64_t totalQuotes;
+    uint64_t totalTrades;
+    uint64_t totalOrders;
+
+    explicit TradingHandler(OrderManager& manager)
+        : orderManager(manager), network(nullptr),
+          totalQuotes(0), totalTrades(0), totalOrders(0) {}
+
+    // Only subscribed symbols reach the handler; the framing layer drops the rest.
+    inline void onQuote(const QuoteView& view) { handleQuote(view); }
+
+    inline void onTrade(const TradeView& view) {
+        totalTrades++;
+
+        orderManager.processTrade(view.toMessage());
+
+        if (totalTrades % 10 == 0) {
+            double currentVwap = orderManager.getCurrentVwap();
+            if (currentVwap > 0) {
+                VWAP_LOG_INFO(LogFmt::MAIN_VWAP_UPDATE, currentVwap, totalTrades);
+            }
+        }
+    }
+
+    // Batch mode: runs of trades go through the VWAP in one call, and each
+    // quote is evaluated at its place in the stream, so decisions see the
+    // same VWAP as in per-frame mode.
+    void onBatch(const FrameBatch& batch) {
+        batch.forEachRun(
+            [&](size_t first, size_t count) {
+                uint64_t before = totalTrades;
+                totalTrades += count;
+                orderManager.processTrades(batch.timestamp + first, batch.quantity + first,
+                                           batch.price + first, count);
+                if (totalTrades / 10 != before / 10) {
+                    double currentVwap = orderManager.getCurrentVwap();
+                    if (currentVwap > 0) {
+                        VWAP_LOG_INFO(LogFmt::MAIN_VWAP_UPDATE, currentVwap, totalTrades);
+                    }
+                }
+            },
+            [&](size_t i) { handleQuote(batch.quoteAt(i)); });
+    }
+
+    // QuoteView from the framing layer or QuoteMessage from a batch; the
+    // order manager reads only the traded side of either.
+    template<typename Quote>
+    void handleQuote(const Quote& quote) {
+        totalQuotes++;
+
+        Optional<OrderMessage> orderOpt = orderManager.processQuote(quote);
+
+        if (orderOpt.has_value()) {
+            OrderMessage order = orderOpt.value();
+
+            if (network->sendOrder(orderManager.getOrderTemplate(),
+                                   order.timestamp, order.quantity, order.price)) {
+                totalOrders++;
+                VWAP_LOG_INFO(LogFmt::MAIN_ORDER_SENT, order.side, order.quantity, LogSymbol(order.symbol),
+                              static_cast<double>(order.price), totalOrders);
+            } else {
+                std::cerr << "[ERROR] Failed to send order to server" << std::endl;
+            }
+        }
+    }
+};
+
+// Optional metrics export: the shared memory stats segment polled by
+// vwap_stat and the Prometheus endpoint served from the event loop.
+void start_metrics_export(NetworkManagerBase& network, StatsSegmentWriter& statsSegment,
+                          MetricsHttpServer& metricsServer) {
+    const RuntimeConfig& rc = runtimeConfig();
+    if (!rc.statsSegment.empty() && statsSegment.create(rc.statsSegment)) {
+        std::cout << "Publishing stats to " << ShmRing::path(rc.statsSegment) << std::endl;
+    }
+    if (rc.metricsPort != 0 && metricsServer.listen(rc.metricsPort)) {
+        network.addEventSource(&metricsServer);
+        std::cout << "Serving metrics on http://127.0.0.1:" << metricsServer.port() << "/metrics" << std::endl;
+    }
+}
+
+void trace_dump_handler(int) {
+    g_tracer.requestDump();
+}
+
+// Per-message tracing for TRACE=1 builds; decode the file with trace_decode.
+void start_tracing() {
+    const RuntimeConfig& rc = runtimeConfig();
+    if (rc.traceFile.empty()) return;
+#ifndef VWAP_TRACING
+    std::cerr << "VWAP_TRACE_FILE ignored: trace points are not built in (make TRACE=1)" << std::endl;
+#else
+    const Tracer::Mode mode = rc.traceOnSignal ? Tracer::Mode::SIGNAL : Tracer::Mode::STREAM;
+    if (!g_tracer.start(rc.traceFile.c_str(), mode)) {
+        std::cerr << "Failed to open trace file " << rc.traceFile << std::endl;
+        return;
+    }
+    if (mode == Tracer::Mode::SIGNAL) {
+        struct sigaction sa;
+        std::memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = trace_dump_handler;
+        sigemptyset(&sa.sa_mask);
+        sa.sa_flags = SA_RESTART;
+        sigaction(SIGUSR2, &sa, nullptr);
+        std::cout << "Tracing to " << rc.traceFile << " on SIGUSR2 (pid " << getpid() << ")" << std::endl;
+    } else {
+        std::cout << "Tracing to " << rc.traceFile << std::endl;
+    }
+#endif
+}
+
 int main(int argc, char* argv[]) {
     Config config;
     if (!parse_arguments(argc, argv, config)) {
@@ -138,6 +285,8 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    runtimeConfig().loadFromEnv();
+
     print_startup_banner();
     print_config(config);
 
@@ -152,8 +301,16 @@ int main(int argc, char* argv[]) {
             config.vwapWindowSeconds
         );
 
+        if (runtimeConfig().warmup) {
+            std::cout << "Warming up..." << std::endl;
+            Warmup::run(config.symbol, config.side, config.maxOrderSize, config.vwapWindowSeconds).print();
+        }
+
         std::cout << "Initializing Network Manager..." << std::endl;
-        NetworkManager networkManager;
+        TradingHandler handler(orderManager);
+        BasicNetworkManager<TradingHandler> networkManager(&handler);
+        handler.network = &networkManager;
+        networkManager.subscribe(config.symbol);
 
         if (!networkManager.initialize(config)) {
             std::cerr << "Failed to initialize network connections" << std::endl;
@@ -163,66 +320,22 @@ int main(int argc, char* argv[]) {
 
         std::cout << "Network connections established successfully" << std::endl;
 
-        uint64_t totalQuotes = 0;
-        uint64_t totalTrades = 0;
-        uint64_t totalOrders = 0;
-        auto startTime = std::chrono::steady_clock::now();
-        auto lastStatsTime = startTime;
-
-        networkManager.setQuoteCallback([&](const QuoteMessage& quote) {
-            if (std::strncmp(quote.symbol, config.symbol.c_str(),
-                           std::min(sizeof(quote.symbol), config.symbol.length())) != 0) {
-                return;
-            }
-
-            totalQuotes++;
-
-            Optional<OrderMessage> orderOpt = orderManager.processQuote(quote);
-
-            if (orderOpt.has_value()) {
-                OrderMessage order = orderOpt.value();
-
-                if (networkManager.sendOrder(order)) {
-                    totalOrders++;
-
-                    char symbolStr[9] = {0};
-                    std::memcpy(symbolStr, order.symbol, 8);
-
-                    std::cout << "[ORDER SENT] "
-                              << (order.side == 'B' ? "BUY" : "SELL")
-                              << " " << order.quantity
-                              << " " << symbolStr
-                              << " @ $" << std::fixed << std::setprecision(2)
-                              << (order.price / 100.0)
-                              << " (Order #" << totalOrders << ")"
-                              << std::endl;
-                } else {
-                    std::cerr << "[ERROR] Failed to send order to server" << std::endl;
-                }
-            }
-        });
-
-        networkManager.setTradeCallback([&](const TradeMessage& trade) {
-            if (std::strncmp(trade.symbol, config.symbol.c_str(),
-                           std::min(sizeof(trade.symbol), config.symbol.length())) != 0) {
-                return;
-            }
-
-            totalTrades++;
+        const std::string& logFile = runtimeConfig().logFile;
+        bool loggerStarted = logFile.empty() ? g_asyncLogger.start(stdout)
+                                             : g_asyncLogger.startFile(logFile.c_str());
+        if (!loggerStarted) {
+            std::cerr << "Failed to start async logger, logging synchronously" << std::endl;
+        }
 
-            orderManager.processTrade(trade);
+        prepare_threads(networkManager, orderManager, loggerStarted);
 
-            if (totalTrades % 10 == 0) {
-                double currentVwap = orderManager.getCurrentVwap();
-                if (currentVwap > 0) {
-                    std::cout << "[VWAP UPDATE] Current VWAP: $"
-                              << std::fixed << std::setprecision(2)
-                              << (currentVwap / 100.0)
-                              << " (after " << totalTrades << " trades)"
-                              << std::endl;
-                }
-            }
-        });
+        auto startTime = std::chrono::steady_clock::now();
+        auto lastStatsTime = startTime;
+        RateMeter rateMeter;
+        StatsSegmentWriter statsSegment(runtimeConfig().statsIntervalMicros * 1000);
+        MetricsHttpServer metricsServer(&rateMeter);
+        start_metrics_export(networkManager, statsSegment, metricsServer);
+        start_tracing();
 
         std::cout << "\n=== Trading System Started ===" << std::endl;
         std::cout << "Waiting for market data..." << std::endl;
@@ -232,6 +345,10 @@ int main(int argc, char* argv[]) {
             networkManager.processEvents();
 
             auto now = std::chrono::steady_clock::now();
+            const uint64_t nowNanos = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count());
+            rateMeter.poll(nowNanos);
+            statsSegment.poll(nowNanos, rateMeter);
             auto timeSinceLastStats = std::chrono::duration_cast<std::chrono::seconds>(
                 now - lastStatsTime).count();
 
@@ -242,9 +359,9 @@ int main(int argc, char* argv[]) {
                     now - startTime).count();
 
                 std::cout << "\n[STATS] Uptime: " << uptime << "s"
-                          << " | Quotes: " << totalQuotes
-                          << " | Trades: " << totalTrades
-                          << " | Orders: " << totalOrders;
+                          << " | Quotes: " << handler.totalQuotes
+                          << " | Trades: " << handler.totalTrades
+                          << " | Orders: " << handler.totalOrders;
 
                 if (orderManager.isReadyToTrade()) {
                     std::cout << " | Status: READY";
@@ -259,31 +376,44 @@ int main(int argc, char* argv[]) {
                 }
 
                 std::cout << std::endl;
+                rateMeter.print();
             }
         }
 
         std::cout << "\n=== Shutting Down ===" << std::endl;
 
         networkManager.stop();
+        g_asyncLogger.stop();
+        if (g_tracer.isActive()) {
+            g_tracer.stop();
+            std::cout << "Trace: " << g_tracer.writtenRecords() << " records written to "
+                      << runtimeConfig().traceFile << " (" << g_tracer.lostRecords() << " lost)" << std::endl;
+        }
+        statsSegment.publish(MetricsSnapshot::capture(g_systemMetrics), rateMeter.report());
+        statsSegment.close();
+        metricsServer.close();
 
         auto uptime = std::chrono::duration_cast<std::chrono::seconds>(
             std::chrono::steady_clock::now() - startTime).count();
 
         std::cout << "\n=== Final Statistics ===" << std::endl;
         std::cout << "Total Runtime: " << uptime << " seconds" << std::endl;
-        std::cout << "Total Quotes Processed: " << totalQuotes << std::endl;
-        std::cout << "Total Trades Processed: " << totalTrades << std::endl;
-        std::cout << "Total Orders Sent: " << totalOrders << std::endl;
+        std::cout << "Total Quotes Processed: " << handler.totalQuotes << std::endl;
+        std::cout << "Total Trades Processed: " << handler.totalTrades << std::endl;
+        std::cout << "Total Orders Sent: " << handler.totalOrders << std::endl;
 
-        if (totalQuotes > 0) {
-            double orderRate = (100.0 * totalOrders) / totalQuotes;
+        if (handler.totalQuotes > 0) {
+            double orderRate = (100.0 * handler.totalOrders) / handler.totalQuotes;
             std::cout << "Order Rate: " << std::fixed << std::setprecision(2)
                       << orderRate << "%" << std::endl;
         }
 
+        rateMeter.print();
         orderManager.printStatistics();
+        if (const LineArbiter* arbiter = networkManager.getArbiter()) arbiter->printStatistics();
+        if (runtimeConfig().rxTimestamps) MetricsSnapshot::capture(g_systemMetrics).print();
 
-        if (totalOrders > 0) {
+        if (handler.totalOrders > 0) {
             orderManager.printOrderHistory(10);
         }
 
@@ -1,29 +1,217 @@
 #include "market_data_client.h"
-#include "message_parser.h"
 #include <iostream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
 #include "metrics.h"
 #include "wire_format.h"
+#include "endian_converter.h"
+#include "shm_ring.h"
 
-MarketDataClient::MarketDataClient(const std::string& host, uint16_t port)
-    : TcpClient(host, port) {
+// Receive slots for one recvmmsg call. Allocated only in UDP mode.
+struct MarketDataClientBase::DatagramReceiver {
+    static constexpr int BATCH = 32;
+
+    uint8_t data[BATCH][WireFormat::MAX_DATAGRAM_SIZE];
+    struct iovec iov[BATCH];
+#if defined(__linux__)
+    struct mmsghdr headers[BATCH];
+#endif
+    size_t lengths[BATCH];
+    bool truncated[BATCH];
+    uint64_t expectedSequence;
+
+    DatagramReceiver() noexcept : expectedSequence(0) {
+        for (int i = 0; i < BATCH; ++i) {
+            iov[i].iov_base = data[i];
+            iov[i].iov_len = sizeof(data[i]);
+#if defined(__linux__)
+            std::memset(&headers[i], 0, sizeof(headers[i]));
+            headers[i].msg_hdr.msg_iov = &iov[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+#endif
+        }
+    }
+};
+
+MarketDataClientBase::MarketDataClientBase(const std::string& host, uint16_t port)
+    : TcpClient(host, port), transport(Transport::TCP), conflateQuotes(false), fillRxKernelNanos(0) {
+    if (ShmRing::parseAddress(host, ringName)) transport = Transport::SHM;
 }
 
-void MarketDataClient::setMessageCallback(
-    std::function<void(const MessageHeader&, const void*)> cb) {
-    messageCallback = cb;
+MarketDataClientBase::~MarketDataClientBase() = default;
+
+void MarketDataClientBase::setTransport(Transport t) {
+    if (!ringName.empty()) return;
+    if (t == Transport::SHM) {
+        std::cerr << "Shared memory transport needs a shm://name address, not " << host << std::endl;
+        return;
+    }
+    transport = t;
+    if (transport == Transport::UDP && !datagrams) datagrams.reset(new DatagramReceiver());
+}
+
+bool MarketDataClientBase::connect() noexcept {
+    switch (transport) {
+        case Transport::UDP: return openUdp();
+        case Transport::SHM: return openRing();
+        default: return TcpClient::connect();
+    }
+}
+
+bool MarketDataClientBase::reconnect() noexcept {
+    if (transport == Transport::TCP) return TcpClient::reconnect();
+    if (isConnected()) return true;
+    disconnect();
+    return transport == Transport::SHM ? openRing() : openUdp();
+}
+
+void MarketDataClientBase::disconnect() noexcept {
+    if (ring) ring->close();
+    TcpClient::disconnect();
+}
+
+bool MarketDataClientBase::openRing() noexcept {
+    if (isConnected()) return true;
+    if (!ring) ring.reset(new ShmRingReader());
+    if (!ring->open(ringName)) {
+        lastError = ErrorType::CONNECTION_REFUSED;
+        return false;
+    }
+    receiveBuffer.clear();
+    state = ConnectionState::CONNECTED;
+    lastError = ErrorType::NONE;
+    std::cout << "Reading market data from shared memory ring " << ShmRing::path(ringName) << std::endl;
+    return true;
+}
+
+bool MarketDataClientBase::openUdp() noexcept {
+    if (isConnected()) return true;
+    if (!resolveAddress()) return false;
+
+    int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) { lastError = ErrorType::INVALID_ADDRESS; return false; }
+    socketFd.reset(fd);
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    int rcvBufSize = 1 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvBufSize, sizeof(rcvBufSize));
+
+    const bool multicast = IN_MULTICAST(ntohl(serverAddr.sin_addr.s_addr));
+    struct sockaddr_in local = serverAddr;
+    if (multicast) local.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (::bind(fd, reinterpret_cast<struct sockaddr*>(&local), sizeof(local)) < 0) {
+        std::cerr << "Failed to bind UDP market data to " << host << ":" << port << ": " << strerror(errno) << std::endl;
+        lastError = ErrorType::CONNECTION_REFUSED;
+        socketFd.reset();
+        return false;
+    }
+    if (multicast) {
+        struct ip_mreq group;
+        group.imr_multiaddr = serverAddr.sin_addr;
+        group.imr_interface.s_addr = htonl(INADDR_ANY);
+        if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &group, sizeof(group)) < 0) {
+            std::cerr << "Failed to join multicast group " << host << ": " << strerror(errno) << std::endl;
+            socketFd.reset();
+            return false;
+        }
+    }
+    if (!setNonBlocking()) { socketFd.reset(); return false; }
+
+    if (!datagrams) datagrams.reset(new DatagramReceiver());
+    datagrams->expectedSequence = 0;
+    state = ConnectionState::CONNECTED;
+    lastError = ErrorType::NONE;
+    std::cout << "Receiving UDP market data on " << host << ":" << port << std::endl;
+    return true;
+}
+
+int MarketDataClientBase::receiveDatagrams() noexcept {
+    DatagramReceiver& rx = *datagrams;
+    int received;
+#if defined(__linux__)
+    do { received = ::recvmmsg(socketFd.fd, rx.headers, DatagramReceiver::BATCH, MSG_DONTWAIT, nullptr);
+    } while (received < 0 && errno == EINTR);
+    for (int i = 0; i < received; ++i) {
+        rx.lengths[i] = rx.headers[i].msg_len;
+        rx.truncated[i] = (rx.headers[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+    }
+#else
+    received = 0;
+    while (received < DatagramReceiver::BATCH) {
+        ssize_t n = ::recv(socketFd.fd, rx.data[received], sizeof(rx.data[received]), MSG_DONTWAIT | MSG_TRUNC);
+        if (n < 0) {
+            if (received == 0) received = -1;
+            break;
+        }
+        rx.lengths[received] = static_cast<size_t>(n);
+        rx.truncated[received] = static_cast<size_t>(n) > sizeof(rx.data[received]);
+        ++received;
+    }
+#endif
+    if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+        lastError = ErrorType::RECEIVE_FAILED;
+        state = ConnectionState::ERROR_STATE;
+        return -1;
+    }
+    g_systemMetrics.udp.receiveCalls.fetch_add(1, std::memory_order_relaxed);
+    g_systemMetrics.udp.datagramsReceived.fetch_add(static_cast<uint64_t>(received), std::memory_order_relaxed);
+    return received;
+}
+
+bool MarketDataClientBase::datagramPayload(int index, const uint8_t*& payload, size_t& length,
+                                           uint64_t& bytes) noexcept {
+    DatagramReceiver& rx = *datagrams;
+    const size_t size = rx.lengths[index];
+    bytes += size;
+    if (rx.truncated[index] || size < WireFormat::DATAGRAM_SEQUENCE_SIZE) {
+        datagramMalformed();
+        return false;
+    }
+
+    uint64_t sequence;
+    std::memcpy(&sequence, rx.data[index], sizeof(sequence));
+    sequence = EndianConverter::ltoh64(sequence);
+    if (rx.expectedSequence != 0 && sequence != 1) {
+        if (sequence < rx.expectedSequence) {
+            g_systemMetrics.udp.datagramsDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (sequence > rx.expectedSequence) {
+            g_systemMetrics.udp.datagramsLost.fetch_add(sequence - rx.expectedSequence, std::memory_order_relaxed);
+        }
+    }
+    rx.expectedSequence = sequence + 1;
+
+    payload = rx.data[index] + WireFormat::DATAGRAM_SEQUENCE_SIZE;
+    length = size - WireFormat::DATAGRAM_SEQUENCE_SIZE;
+    return true;
 }
 
-bool MarketDataClient::processIncomingData() {
+void MarketDataClientBase::datagramMalformed() noexcept {
+    g_systemMetrics.udp.datagramsDropped.fetch_add(1, std::memory_order_relaxed);
+}
 
-    uint64_t localBytes = 0;
+bool MarketDataClientBase::fillReceiveBuffer(uint64_t& localBytes) noexcept {
+    fillRxKernelNanos = 0;
     for (int iter=0; iter<4; ++iter) {
         uint8_t tempBuffer[4096];
-        ssize_t bytesRead = receive(tempBuffer, sizeof(tempBuffer));
+        uint64_t kernelNanos = 0;
+        ssize_t bytesRead = rxTimestamps ? receiveStamped(tempBuffer, sizeof(tempBuffer), kernelNanos)
+                                         : receive(tempBuffer, sizeof(tempBuffer));
         if (bytesRead <= 0) {
             if (bytesRead == 0) return false;
             if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) break;
             return false;
         }
+        if (rxTimestamps) {
+            g_metricsView.recordKernelToUser(kernelNanos, realtimeNanos());
+            if (fillRxKernelNanos == 0) fillRxKernelNanos = kernelNanos;
+        }
         localBytes += static_cast<uint64_t>(bytesRead);
         if (!receiveBuffer.append(tempBuffer, static_cast<size_t>(bytesRead))) {
             g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
@@ -32,77 +220,60 @@ bool MarketDataClient::processIncomingData() {
         }
         if (bytesRead < static_cast<ssize_t>(sizeof(tempBuffer))) break;
     }
+    return true;
+}
 
-    uint64_t localMsgs = 0;
-    uint64_t localQuotes = 0;
-    uint64_t localTrades = 0;
-    while (true) {
-        MessageHeader header; const uint8_t* bodyPtr; size_t contiguous;
-        auto pr = receiveBuffer.peekMessage(header, bodyPtr, contiguous);
-        if (pr != MessageBuffer::ExtractResult::SUCCESS) {
-            if (pr != MessageBuffer::ExtractResult::NEED_MORE_DATA) {
-
-                if (pr == MessageBuffer::ExtractResult::INVALID_HEADER) {
-                    g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
-                    receiveBuffer.resync();
-                }
-            }
-            break;
-        }
-
-    messagesReceived++;
-    ++localMsgs;
-        bool ok = false;
-        if (header.type == MessageHeader::QUOTE_TYPE) {
-            QuoteMessage quote;
-            uint8_t temp[WireFormat::QUOTE_SIZE];
-            if (contiguous == header.length) {
-                ok = MessageParser::parseQuote(bodyPtr, header.length, quote) && MessageParser::validateQuote(quote);
-            } else {
-                std::memcpy(temp, bodyPtr, contiguous);
-                std::memcpy(temp + contiguous, receiveBuffer.dataPtr(), header.length - contiguous);
-                ok = MessageParser::parseQuote(temp, header.length, quote) && MessageParser::validateQuote(quote);
-            }
-            if (ok) {
-        ++localQuotes;
-                if (messageCallback) messageCallback(header, &quote);
-            } else {
-                g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
-            }
-        } else if (header.type == MessageHeader::TRADE_TYPE) {
-            TradeMessage trade;
-            uint8_t temp[WireFormat::TRADE_SIZE];
-            if (contiguous == header.length) {
-                ok = MessageParser::parseTrade(bodyPtr, header.length, trade) && MessageParser::validateTrade(trade);
-            } else {
-                std::memcpy(temp, bodyPtr, contiguous);
-                std::memcpy(temp + contiguous, receiveBuffer.dataPtr(), header.length - contiguous);
-                ok = MessageParser::parseTrade(temp, header.length, trade) && MessageParser::validateTrade(trade);
-            }
-            if (ok) {
-        ++localTrades;
-                if (messageCallback) messageCallback(header, &trade);
-            } else {
-                g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
-            }
-        } else {
-            g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
-        }
-        receiveBuffer.consume(header);
-
-#if defined(__GNUC__)
-        if (receiveBuffer.availableBytes() >= WireFormat::HEADER_SIZE) {
-            size_t hi = receiveBuffer.headIndex();
-            size_t prefetchOffset = (hi + WireFormat::HEADER_SIZE) & (65536 - 1);
-            __builtin_prefetch(receiveBuffer.dataPtr() + prefetchOffset, 0, 1);
-        }
-#endif
+bool MarketDataClientBase::fillFromRing(uint64_t& localBytes) noexcept {
+    uint8_t tempBuffer[4096];
+    uint64_t lost = 0;
+    ssize_t bytesRead = ring->read(tempBuffer, sizeof(tempBuffer), lost);
+    if (bytesRead < 0) {
+        lastError = ErrorType::CONNECTION_LOST;
+        state = ConnectionState::ERROR_STATE;
+        return false;
     }
-    if (localBytes) g_systemMetrics.hot.bytesReceived.fetch_add(localBytes, std::memory_order_relaxed);
-    if (localMsgs) {
-    g_systemMetrics.hot.messagesReceived.fetch_add(localMsgs, std::memory_order_relaxed);
-    if (localQuotes) g_systemMetrics.hot.quotesProcessed.fetch_add(localQuotes, std::memory_order_relaxed);
-    if (localTrades) g_systemMetrics.hot.tradesProcessed.fetch_add(localTrades, std::memory_order_relaxed);
+    if (bytesRead == 0) return true;
+    localBytes += static_cast<uint64_t>(bytesRead);
+    if (!receiveBuffer.append(tempBuffer, static_cast<size_t>(bytesRead))) {
+        g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
+        receiveBuffer.clear();
     }
     return true;
 }
+
+const uint8_t* MarketDataClientBase::contiguousBody(const MessageHeader& header, const uint8_t* bodyPtr,
+                                                    size_t contiguous, uint8_t* scratch) const noexcept {
+    if (contiguous >= header.length) return bodyPtr;
+    std::memcpy(scratch, bodyPtr, contiguous);
+    std::memcpy(scratch + contiguous, receiveBuffer.dataPtr(), header.length - contiguous);
+    return scratch;
+}
+
+bool MarketDataClientBase::handleFramingError(MessageBuffer::ExtractResult result) noexcept {
+    if (result != MessageBuffer::ExtractResult::INVALID_HEADER) return false;
+    g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
+    return receiveBuffer.resync() > 0;
+}
+
+void MarketDataClientBase::publishCounts(uint64_t localBytes, const DrainCounts& counts) noexcept {
+    HotCounters& hot = localHotCounters();
+    if (localBytes) hot.bytesReceived.add(localBytes);
+    if (counts.messages) {
+        hot.messagesReceived.add(counts.messages);
+        if (counts.quotes) hot.quotesProcessed.add(counts.quotes);
+        if (counts.trades) hot.tradesProcessed.add(counts.trades);
+        if (counts.filtered) g_systemMetrics.feed.messagesFiltered.fetch_add(counts.filtered, std::memory_order_relaxed);
+        if (counts.batches) g_systemMetrics.feed.batchesDispatched.fetch_add(counts.batches, std::memory_order_relaxed);
+        if (counts.conflated) g_systemMetrics.feed.quotesConflated.fetch_add(counts.conflated, std::memory_order_relaxed);
+    }
+}
+
+MarketDataClient::MarketDataClient(const std::string& host, uint16_t port)
+    : BasicMarketDataClient<MessageCallbackAdapter>(host, port) {
+    setHandler(&adapter);
+}
+
+void MarketDataClient::setMessageCallback(
+    std::function<void(const MessageHeader&, const void*)> cb) {
+    adapter.callback = cb;
+}
@@ -4,6 +4,9 @@
 #include <cstring>
 #include <algorithm>
 #include "metrics.h"
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 MessageBuffer::MessageBuffer() noexcept : head(0), tail(0), used(0) {}
 
@@ -60,26 +63,99 @@ size_t MessageBuffer::availableSpace() const noexcept { return BUFFER_SIZE - use
 
 void MessageBuffer::clear() noexcept { head = tail = used = 0; }
 
-size_t MessageBuffer::resync() noexcept {
-    size_t available = used;
-    if (available < WireFormat::HEADER_SIZE + 1) return available;
+namespace {
+inline bool isHeaderPair(uint8_t length, uint8_t type) noexcept {
+    return (type == MessageHeader::QUOTE_TYPE && length == WireFormat::QUOTE_SIZE) ||
+           (type == MessageHeader::TRADE_TYPE && length == WireFormat::TRADE_SIZE);
+}
+
+// Index of the first k < starts with (p[k], p[k+1]) a valid header pair, or
+// starts if there is none. Reads p[0..starts].
+inline size_t findHeaderPair(const uint8_t* p, size_t starts) noexcept {
+    size_t k = 0;
+#if defined(__AVX2__)
+    const __m256i quoteLen = _mm256_set1_epi8(static_cast<char>(WireFormat::QUOTE_SIZE));
+    const __m256i quoteType = _mm256_set1_epi8(static_cast<char>(MessageHeader::QUOTE_TYPE));
+    const __m256i tradeLen = _mm256_set1_epi8(static_cast<char>(WireFormat::TRADE_SIZE));
+    const __m256i tradeType = _mm256_set1_epi8(static_cast<char>(MessageHeader::TRADE_TYPE));
+    for (; k + 32 <= starts; k += 32) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + k));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + k + 1));
+        __m256i quote = _mm256_and_si256(_mm256_cmpeq_epi8(lo, quoteLen), _mm256_cmpeq_epi8(hi, quoteType));
+        __m256i trade = _mm256_and_si256(_mm256_cmpeq_epi8(lo, tradeLen), _mm256_cmpeq_epi8(hi, tradeType));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(quote, trade)));
+        if (mask) return k + static_cast<size_t>(__builtin_ctz(mask));
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i quoteLen16 = _mm_set1_epi8(static_cast<char>(WireFormat::QUOTE_SIZE));
+    const __m128i quoteType16 = _mm_set1_epi8(static_cast<char>(MessageHeader::QUOTE_TYPE));
+    const __m128i tradeLen16 = _mm_set1_epi8(static_cast<char>(WireFormat::TRADE_SIZE));
+    const __m128i tradeType16 = _mm_set1_epi8(static_cast<char>(MessageHeader::TRADE_TYPE));
+    for (; k + 16 <= starts; k += 16) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + k));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + k + 1));
+        __m128i quote = _mm_and_si128(_mm_cmpeq_epi8(lo, quoteLen16), _mm_cmpeq_epi8(hi, quoteType16));
+        __m128i trade = _mm_and_si128(_mm_cmpeq_epi8(lo, tradeLen16), _mm_cmpeq_epi8(hi, tradeType16));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(quote, trade)));
+        if (mask) return k + static_cast<size_t>(__builtin_ctz(mask));
+    }
+#endif
+    for (; k < starts; ++k) {
+        if (isHeaderPair(p[k], p[k + 1])) return k;
+    }
+    return starts;
+}
+}
 
-    const size_t MAX_SCAN = 256;
-    size_t limit = (available < MAX_SCAN) ? available : MAX_SCAN;
-    for (size_t i = 1; i + 1 < limit; ++i) {
-        uint8_t length = buffer[(head + i) & (BUFFER_SIZE - 1)];
-        uint8_t type   = buffer[(head + i + 1) & (BUFFER_SIZE - 1)];
-        bool plausible = false;
-        if (type == MessageHeader::QUOTE_TYPE && length == WireFormat::QUOTE_SIZE) plausible = true;
-        else if (type == MessageHeader::TRADE_TYPE && length == WireFormat::TRADE_SIZE) plausible = true;
-        if (plausible) return i;
+size_t MessageBuffer::scanForHeader(size_t from) const noexcept {
+    const size_t end = used - 1;
+    while (from < end) {
+        size_t phys = (head + from) & (BUFFER_SIZE - 1);
+        size_t run = std::min(end - from, BUFFER_SIZE - 1 - phys);
+        if (run == 0) {
+            // The pair straddles the physical end of the ring.
+            if (isHeaderPair(buffer[phys], buffer[0])) return from;
+            ++from;
+            continue;
+        }
+        size_t hit = findHeaderPair(buffer + phys, run);
+        if (hit < run) return from + hit;
+        from += run;
     }
+    return end;
+}
+
+bool MessageBuffer::confirmHeader(size_t offset) const noexcept {
+    size_t next = offset + WireFormat::HEADER_SIZE + buffer[(head + offset) & (BUFFER_SIZE - 1)];
+    // A candidate whose successor has not arrived yet cannot be refuted; keep it.
+    if (next + WireFormat::HEADER_SIZE > used) return true;
+    return isHeaderPair(buffer[(head + next) & (BUFFER_SIZE - 1)],
+                        buffer[(head + next + 1) & (BUFFER_SIZE - 1)]);
+}
 
-    extern SystemMetrics g_systemMetrics;
-    if (limit >= 8) {
-        g_systemMetrics.perf.resyncEvents.fetch_add(1, std::memory_order_relaxed);
+size_t MessageBuffer::resync() noexcept {
+    if (used < WireFormat::HEADER_SIZE) return 0;
+
+    const size_t none = used - 1;
+    size_t offset = scanForHeader(1);
+    if (offset < none && !confirmHeader(offset)) {
+        // An unconfirmed candidate may be a real frame followed by more
+        // corruption. Drop it only if a confirmed header starts inside it.
+        size_t frameEnd = offset + WireFormat::HEADER_SIZE + buffer[(head + offset) & (BUFFER_SIZE - 1)];
+        size_t next = scanForHeader(offset + 1);
+        while (next < none && next < frameEnd && !confirmHeader(next)) {
+            next = scanForHeader(next + 1);
+        }
+        if (next < frameEnd) offset = next;
     }
-    head = (head + limit) & (BUFFER_SIZE - 1);
-    used -= std::min(used, limit);
-    return limit;
+    // With no candidate, the last byte may still be the length of a header
+    // whose type byte has not arrived.
+    size_t discard = std::min(offset, none);
+
+    head = (head + discard) & (BUFFER_SIZE - 1);
+    used -= discard;
+    g_systemMetrics.perf.resyncEvents.fetch_add(1, std::memory_order_relaxed);
+    g_systemMetrics.feed.resyncBytesDiscarded.fetch_add(discard, std::memory_order_relaxed);
+    return discard;
 }
@@ -1,3 +1,23 @@
 #include "metrics.h"
 SystemMetrics g_systemMetrics;
 MetricsView g_metricsView(&g_systemMetrics);
+thread_local uint64_t g_rxKernelNanos = 0;
+thread_local HotCounters* t_hotCounters = nullptr;
+
+namespace {
+struct HotShard {
+    HotCounters counters;
+
+    HotShard() { g_systemMetrics.hot.attach(&counters); }
+    ~HotShard() {
+        g_systemMetrics.hot.detach(&counters);
+        t_hotCounters = nullptr;
+    }
+};
+}
+
+HotCounters& attachHotCounters() noexcept {
+    static thread_local HotShard shard;
+    t_hotCounters = &shard.counters;
+    return shard.counters;
+}
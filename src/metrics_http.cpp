@@ -0,0 +1,301 @@
+#include "metrics_http.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+inline uint64_t steadyNanos() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void family(std::string& out, const char* name, const char* type, const char* help) {
+    out += "# HELP "; out += name; out += ' '; out += help; out += '\n';
+    out += "# TYPE "; out += name; out += ' '; out += type; out += '\n';
+}
+
+void sample(std::string& out, const char* name, const char* labels, uint64_t value) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%s%s %" PRIu64 "\n", name, labels, value);
+    out += line;
+}
+
+void sample(std::string& out, const char* name, const char* labels, double value) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%s%s %.3f\n", name, labels, value);
+    out += line;
+}
+
+void counter(std::string& out, const char* name, const char* help, uint64_t value) {
+    family(out, name, "counter", help);
+    sample(out, name, "", value);
+}
+
+void gauge(std::string& out, const char* name, const char* help, uint64_t value) {
+    family(out, name, "gauge", help);
+    sample(out, name, "", value);
+}
+
+// Bucket b of a LatencyHistogram holds integer values below 2^b, i.e. at
+// most 2^b - 1; the last bucket is open ended.
+void histogram(std::string& out, const char* name, const char* help, const LatencyHistogram& h) {
+    family(out, name, "histogram", help);
+    const std::string bucket = std::string(name) + "_bucket";
+    uint64_t cumulative = 0;
+    char labels[48];
+    for (size_t b = 0; b + 1 < LatencyHistogram::BUCKETS; ++b) {
+        cumulative += h.buckets[b].load(std::memory_order_relaxed);
+        std::snprintf(labels, sizeof(labels), "{le=\"%" PRIu64 "\"}", (uint64_t{1} << b) - 1);
+        sample(out, bucket.c_str(), labels, cumulative);
+    }
+    cumulative += h.buckets[LatencyHistogram::BUCKETS - 1].load(std::memory_order_relaxed);
+    sample(out, bucket.c_str(), "{le=\"+Inf\"}", cumulative);
+    sample(out, (std::string(name) + "_sum").c_str(), "", h.totalNanos.load(std::memory_order_relaxed));
+    sample(out, (std::string(name) + "_count").c_str(), "", cumulative);
+}
+
+void rates(std::string& out, const char* series, const RateMeter::Rates& r) {
+    char labels[64];
+    const struct { const char* window; double value; } windows[] = {
+        {"1s", r.last}, {"10s", r.avg10}, {"60s", r.avg60}, {"peak", r.peak}};
+    for (const auto& w : windows) {
+        std::snprintf(labels, sizeof(labels), "{series=\"%s\",window=\"%s\"}", series, w.window);
+        sample(out, "vwap_rate_per_second", labels, w.value);
+    }
+}
+
+const char* reason(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        default:  return "Bad Request";
+    }
+}
+
+std::string httpResponse(int status, const std::string& body, const char* contentType) {
+    char head[256];
+    std::snprintf(head, sizeof(head),
+                  "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+                  status, reason(status), contentType, body.size());
+    return head + body;
+}
+}
+
+MetricsHttpServer::MetricsHttpServer(const RateMeter* rateMeter) noexcept
+    : listenFd(-1), boundPort(0), meter(rateMeter) {
+}
+
+MetricsHttpServer::~MetricsHttpServer() {
+    close();
+}
+
+bool MetricsHttpServer::listen(uint16_t port, const char* address) {
+    close();
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, address, &addr.sin_addr) != 1) {
+        std::cerr << "Invalid metrics address " << address << std::endl;
+        return false;
+    }
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "Failed to create metrics socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, 16) < 0) {
+        std::cerr << "Failed to listen for metrics on " << address << ":" << port << ": " << strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    listenFd = fd;
+    boundPort = ntohs(addr.sin_port);
+    return true;
+}
+
+void MetricsHttpServer::close() noexcept {
+    for (Client& client : clients) ::close(client.fd);
+    clients.clear();
+    if (listenFd >= 0) ::close(listenFd);
+    listenFd = -1;
+    boundPort = 0;
+}
+
+void MetricsHttpServer::watch(fd_set& readSet, fd_set& writeSet, int& maxFd) {
+    if (listenFd < 0) return;
+    FD_SET(listenFd, &readSet);
+    maxFd = std::max(maxFd, listenFd);
+
+    const uint64_t now = steadyNanos();
+    for (size_t i = 0; i < clients.size();) {
+        Client& client = clients[i];
+        if (now - client.openedNanos > CLIENT_TIMEOUT_NANOS) {
+            ::close(client.fd);
+            clients[i] = std::move(clients.back());
+            clients.pop_back();
+            continue;
+        }
+        FD_SET(client.fd, client.response.empty() ? &readSet : &writeSet);
+        maxFd = std::max(maxFd, client.fd);
+        ++i;
+    }
+}
+
+void MetricsHttpServer::service(const fd_set& readSet, const fd_set& writeSet) {
+    if (listenFd < 0) return;
+    for (size_t i = 0; i < clients.size();) {
+        Client& client = clients[i];
+        bool open = true;
+        if (client.response.empty() && FD_ISSET(client.fd, &readSet)) open = readRequest(client);
+        else if (!client.response.empty() && FD_ISSET(client.fd, &writeSet)) open = writeResponse(client);
+        if (!open) {
+            ::close(client.fd);
+            clients[i] = std::move(clients.back());
+            clients.pop_back();
+            continue;
+        }
+        ++i;
+    }
+    if (FD_ISSET(listenFd, &readSet)) acceptClients();
+}
+
+void MetricsHttpServer::acceptClients() {
+    while (true) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        if (clients.size() >= MAX_CLIENTS) {
+            ::close(fd);
+            continue;
+        }
+        clients.push_back(Client{fd, steadyNanos(), std::string(), std::string(), 0});
+    }
+}
+
+bool MetricsHttpServer::readRequest(Client& client) {
+    char buffer[1024];
+    bool peerClosed = false;
+    while (true) {
+        ssize_t n = ::recv(client.fd, buffer, sizeof(buffer), 0);
+        if (n == 0) {
+            peerClosed = true;
+            break;
+        }
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            return false;
+        }
+        client.request.append(buffer, static_cast<size_t>(n));
+        if (client.request.size() > MAX_REQUEST_BYTES) return false;
+    }
+    if (client.request.find("\r\n\r\n") == std::string::npos) return !peerClosed;
+    client.response = respond(client.request);
+    return writeResponse(client);
+}
+
+bool MetricsHttpServer::writeResponse(Client& client) {
+    while (client.sent < client.response.size()) {
+        ssize_t n = ::send(client.fd, client.response.data() + client.sent,
+                           client.response.size() - client.sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            if (errno == EINTR) continue;
+            return false;
+        }
+        client.sent += static_cast<size_t>(n);
+    }
+    return false;
+}
+
+std::string MetricsHttpServer::respond(const std::string& request) const {
+    const size_t methodEnd = request.find(' ');
+    const size_t pathEnd = methodEnd == std::string::npos ? std::string::npos : request.find(' ', methodEnd + 1);
+    if (pathEnd == std::string::npos) return httpResponse(400, "bad request\n", "text/plain");
+    const std::string method = request.substr(0, methodEnd);
+    std::string path = request.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+    path = path.substr(0, path.find('?'));
+    if (path != "/metrics" && path != "/") return httpResponse(404, "not found\n", "text/plain");
+    if (method != "GET" && method != "HEAD") return httpResponse(405, "method not allowed\n", "text/plain");
+
+    RateMeter::Report report;
+    if (meter) report = meter->report();
+    std::string response = httpResponse(200, render(g_systemMetrics, meter ? &report : nullptr),
+                                        "text/plain; version=0.0.4; charset=utf-8");
+    if (method == "HEAD") response.resize(response.find("\r\n\r\n") + 4);
+    return response;
+}
+
+std::string MetricsHttpServer::render(const SystemMetrics& m, const RateMeter::Report* rateReport) {
+    const MetricsSnapshot s = MetricsSnapshot::capture(m);
+    std::string out;
+    out.reserve(16384);
+
+    counter(out, "vwap_messages_received_total", "Market data messages received.", s.messagesReceived);
+    counter(out, "vwap_messages_sent_total", "Successful writes to the order connection.", s.messagesSent);
+    counter(out, "vwap_bytes_received_total", "Market data bytes received.", s.bytesReceived);
+    counter(out, "vwap_bytes_sent_total", "Bytes written to the order connection.", s.bytesSent);
+    counter(out, "vwap_orders_placed_total", "Orders written to the order connection.", s.ordersPlaced);
+    counter(out, "vwap_trades_processed_total", "Trade messages delivered.", s.tradesProcessed);
+    counter(out, "vwap_quotes_processed_total", "Quote messages delivered.", s.quotesProcessed);
+
+    counter(out, "vwap_connections_accepted_total", "Connections accepted.", s.connectionsAccepted);
+    counter(out, "vwap_connections_closed_total", "Connections closed.", s.connectionsClosed);
+    counter(out, "vwap_connection_errors_total", "Connection errors.", s.connectionErrors);
+    counter(out, "vwap_messages_dropped_total", "Messages dropped.", s.messagesDropped);
+    counter(out, "vwap_completed_sends_total", "Queued orders sent in full.", s.completedSends);
+    counter(out, "vwap_partial_sends_total", "Order sends that were queued.", s.partialSends);
+    counter(out, "vwap_failed_sends_total", "Order sends that failed.", s.failedSends);
+    gauge(out, "vwap_send_queue_high_water", "Deepest order send queue seen.", s.queueHighWater);
+
+    family(out, "vwap_decision_latency_nanoseconds", "summary", "Quote evaluation latency.");
+    sample(out, "vwap_decision_latency_nanoseconds_sum", "", s.totalLatency);
+    sample(out, "vwap_decision_latency_nanoseconds_count", "", s.latencyCount);
+    gauge(out, "vwap_decision_latency_min_nanoseconds", "Fastest quote evaluation.", s.latencyCount ? s.minLatency : 0);
+    gauge(out, "vwap_decision_latency_max_nanoseconds", "Slowest quote evaluation.", s.maxLatency);
+
+    counter(out, "vwap_resync_events_total", "Framing resynchronisations.", s.resyncEvents);
+    counter(out, "vwap_resync_bytes_discarded_total", "Bytes skipped while resynchronising.", s.resyncBytesDiscarded);
+    counter(out, "vwap_messages_filtered_total", "Messages for unsubscribed symbols.", s.messagesFiltered);
+    counter(out, "vwap_batches_dispatched_total", "Frame batches dispatched.", s.batchesDispatched);
+    counter(out, "vwap_quotes_conflated_total", "Quotes superseded before dispatch.", s.quotesConflated);
+    counter(out, "vwap_line_duplicates_total", "Redundant line copies discarded.", s.lineDuplicates);
+    counter(out, "vwap_ring_overruns_total", "Shared memory ring messages overwritten unread.", s.ringOverruns);
+    counter(out, "vwap_datagrams_received_total", "Market data datagrams received.", s.datagramsReceived);
+    counter(out, "vwap_datagram_receive_calls_total", "Datagram receive system calls.", s.datagramReceiveCalls);
+    counter(out, "vwap_datagrams_lost_total", "Datagrams missing from the sequence.", s.datagramsLost);
+    counter(out, "vwap_datagrams_dropped_total", "Late or malformed datagrams.", s.datagramsDropped);
+
+    counter(out, "vwap_order_flush_syscalls_total", "Coalesced order flush system calls.", s.flushSyscalls);
+    counter(out, "vwap_orders_flushed_total", "Orders written by coalesced flushes.", s.ordersFlushed);
+    counter(out, "vwap_order_batches_flushed_total", "Coalesced order batches.", s.batchesFlushed);
+    counter(out, "vwap_order_batch_delay_nanoseconds_total", "Time orders waited in a batch.", s.batchDelayTotalNanos);
+    gauge(out, "vwap_order_batch_delay_max_nanoseconds", "Longest time an order waited in a batch.", s.batchDelayMaxNanos);
+    counter(out, "vwap_order_budget_flushes_total", "Batches flushed by the latency budget.", s.budgetFlushes);
+
+    histogram(out, "vwap_kernel_to_user_nanoseconds", "Kernel receive timestamp to user space.", m.wire.kernelToUser);
+    histogram(out, "vwap_kernel_to_order_nanoseconds", "Kernel receive timestamp to order written.", m.wire.kernelToOrder);
+    counter(out, "vwap_unstamped_reads_total", "Market data reads without a kernel timestamp.", s.unstampedReads);
+
+    gauge(out, "vwap_peak_messages_per_second", "Highest one-second market data message rate.", s.peakMessagesPerSecond);
+    if (rateReport) {
+        family(out, "vwap_rate_per_second", "gauge", "Rolling rates by series and window.");
+        rates(out, "messages", rateReport->messages);
+        rates(out, "bytes", rateReport->bytes);
+        rates(out, "orders", rateReport->orders);
+    }
+    return out;
+}
@@ -7,78 +7,155 @@
 #include <algorithm>
 #include <thread>
 #include "metrics.h"
+#include "runtime_config.h"
 
-NetworkManager::NetworkManager()
-        : marketClient(nullptr), orderClient(nullptr), running(false),
-            marketReconnectDelay(1000), orderReconnectDelay(1000),
-            lastMarketReconnect(std::chrono::steady_clock::now()),
+NetworkManagerBase::NetworkManagerBase()
+        : orderClient(nullptr), running(false),
+            orderReconnectDelay(1000),
             lastOrderReconnect(std::chrono::steady_clock::now()) {
 }
 
-NetworkManager::~NetworkManager() {
+NetworkManagerBase::~NetworkManagerBase() {
     stop();
 
 }
 
-bool NetworkManager::initialize(const Config& config) {
-    marketClient = std::make_unique<MarketDataClient>(config.marketDataHost,
-                                                      config.marketDataPort);
+std::vector<FeedEndpoint> NetworkManagerBase::marketEndpoints(const Config& config) {
+    std::vector<FeedEndpoint> endpoints{FeedEndpoint{config.marketDataHost, config.marketDataPort}};
+    for (const FeedEndpoint& extra : runtimeConfig().extraMarketDataLines) {
+        if (endpoints.size() == LineArbiter::MAX_LINES) break;
+        endpoints.push_back(extra);
+    }
+    return endpoints;
+}
+
+bool NetworkManagerBase::connectClients(const std::vector<MarketDataClientBase*>& markets, const Config& config) {
+    // Conflating per line would let a stale quote from a slower line through
+    // after a newer one was forwarded, so it only applies to a single line.
+    const bool conflate = runtimeConfig().conflateQuotes && markets.size() == 1;
+    if (runtimeConfig().conflateQuotes && !conflate) {
+        std::cerr << "Quote conflation is not used with redundant feed lines" << std::endl;
+    }
+    marketLines.clear();
+    for (MarketDataClientBase* market : markets) {
+        market->setSubscriptions(subscriptions);
+        market->setConflation(conflate);
+        market->setTransport(runtimeConfig().marketDataUdp ? MarketDataClientBase::Transport::UDP
+                                                           : MarketDataClientBase::Transport::TCP);
+        market->enableRxTimestamps(runtimeConfig().rxTimestamps &&
+                                   market->getTransport() == MarketDataClientBase::Transport::TCP);
+        market->setTuning(runtimeConfig().marketDataSocket);
+        marketLines.push_back(MarketLine{market, 1000, std::chrono::steady_clock::now()});
+    }
     orderClient = std::make_unique<OrderClient>(config.orderHost,
                                                config.orderPort);
 
-    marketClient->setMessageCallback(
-        [this](const MessageHeader& header, const void* data) {
-            handleMarketData(header, data);
-        });
+    orderClient->setCoalescing(runtimeConfig().coalesceOrders, runtimeConfig().coalesceBudgetNanos);
+    orderClient->setTuning(runtimeConfig().orderSocket);
 
-    if (!marketClient->connect()) {
+    size_t connected = 0;
+    for (size_t i = 0; i < markets.size(); ++i) {
+        if (markets[i]->connect()) {
+            ++connected;
+        } else if (markets.size() > 1) {
+            std::cerr << "Market data line " << i << " unavailable, will retry" << std::endl;
+        }
+    }
+    if (connected == 0) {
         std::cerr << "Failed to connect to market data" << std::endl;
         return false;
     }
+    if (runtimeConfig().rxTimestamps) {
+        for (MarketDataClientBase* market : markets) {
+            if (market->isConnected() && !market->rxTimestampsAvailable()) {
+                std::cerr << "Kernel receive timestamps unavailable on this market data line; "
+                             "kernel latency histograms will count it as unstamped" << std::endl;
+                break;
+            }
+        }
+    }
 
     if (!orderClient->connect()) {
         std::cerr << "Failed to connect to order server" << std::endl;
         return false;
     }
 
+    for (MarketDataClientBase* market : markets) {
+        if (market->isConnected() && market->getTransport() == MarketDataClientBase::Transport::TCP) {
+            market->getTuning().print("Market data", market->getAppliedTuning());
+        }
+    }
+    orderClient->getTuning().print("Order", orderClient->getAppliedTuning());
+
     running = true;
     return true;
 }
 
-void NetworkManager::processEvents() {
-    if (!running) return;
-
-    fd_set readSet, writeSet;
+bool NetworkManagerBase::waitForEvents(fd_set& readSet, fd_set& writeSet) {
     struct timeval timeout;
 
     FD_ZERO(&readSet);
     FD_ZERO(&writeSet);
 
     int maxFd = -1;
+    // Lines without a socket (the shared memory ring) are polled every
+    // cycle, so select() must not block.
+    bool polling = false;
 
-    if (marketClient->isConnected()) {
-        int fd = marketClient->getSocketFd();
-        FD_SET(fd, &readSet);
-        maxFd = std::max(maxFd, fd);
-    } else {
-        tryReconnectMarket();
+    for (size_t i = 0; i < marketLines.size(); ++i) {
+        MarketDataClientBase* market = marketLines[i].client;
+        if (market->isConnected()) {
+            int fd = market->getSocketFd();
+            if (fd < 0) {
+                polling = true;
+                continue;
+            }
+            FD_SET(fd, &readSet);
+            maxFd = std::max(maxFd, fd);
+        } else if (market->isConnecting()) {
+            if (market->connectTimedOut()) {
+                marketReconnectFailed(i);
+            } else {
+                FD_SET(market->getSocketFd(), &writeSet);
+                maxFd = std::max(maxFd, market->getSocketFd());
+            }
+        } else {
+            tryReconnectMarket(i);
+        }
     }
 
     if (orderClient->isConnected()) {
-        int fd = orderClient->getSocketFd();
-        FD_SET(fd, &writeSet);
-        maxFd = std::max(maxFd, fd);
+        if (orderClient->hasPendingSends()) {
+            int fd = orderClient->getSocketFd();
+            FD_SET(fd, &writeSet);
+            maxFd = std::max(maxFd, fd);
+        }
+        // Orders queued from a strategy thread end the wait.
+        if (orderClient->wakeFd() >= 0) {
+            FD_SET(orderClient->wakeFd(), &readSet);
+            maxFd = std::max(maxFd, orderClient->wakeFd());
+        }
+    } else if (orderClient->isConnecting()) {
+        if (orderClient->connectTimedOut()) {
+            orderReconnectFailed();
+        } else {
+            FD_SET(orderClient->getSocketFd(), &writeSet);
+            maxFd = std::max(maxFd, orderClient->getSocketFd());
+        }
     } else {
         tryReconnectOrder();
     }
 
+    for (EventSource* source : eventSources) source->watch(readSet, writeSet, maxFd);
+
     timeout.tv_sec = 0;
-    timeout.tv_usec = 100000;
+    timeout.tv_usec = polling ? 0 : 100000;
 
     if (maxFd == -1) {
+        if (polling) return true;
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
         handlePeriodicTasks();
-        return;
+        return false;
     }
 
     int activity = select(maxFd + 1, &readSet, &writeSet, nullptr, &timeout);
@@ -86,55 +163,80 @@ void NetworkManager::processEvents() {
     if (activity < 0) {
         if (errno != EINTR) {
             std::cerr << "Select error: " << strerror(errno) << std::endl;
-            return;
         }
-        return;
+        return false;
     }
+    completePendingConnects(writeSet);
+    return true;
+}
 
-    if (marketClient->isConnected() &&
-        FD_ISSET(marketClient->getSocketFd(), &readSet)) {
-        marketClient->processIncomingData();
+void NetworkManagerBase::completePendingConnects(const fd_set& writeSet) {
+    for (size_t i = 0; i < marketLines.size(); ++i) {
+        MarketDataClientBase* market = marketLines[i].client;
+        if (!market->isConnecting() || !FD_ISSET(market->getSocketFd(), &writeSet)) continue;
+        if (market->completeConnect()) {
+            marketReconnected(i);
+        } else {
+            marketReconnectFailed(i);
+        }
+    }
+    if (orderClient->isConnecting() && FD_ISSET(orderClient->getSocketFd(), &writeSet)) {
+        if (orderClient->completeConnect()) {
+            orderReconnected();
+        } else {
+            orderReconnectFailed();
+        }
     }
+}
+
+void NetworkManagerBase::prefault() noexcept {
+    for (MarketLine& line : marketLines) line.client->prefault();
+    if (orderClient) orderClient->prefault();
+}
 
-    if (orderClient->isConnected() &&
-        FD_ISSET(orderClient->getSocketFd(), &writeSet)) {
+bool NetworkManagerBase::marketReadable(const fd_set& readSet, size_t line) const noexcept {
+    const MarketDataClientBase* market = marketLines[line].client;
+    if (!market->isConnected()) return false;
+    int fd = market->getSocketFd();
+    return fd < 0 || FD_ISSET(fd, &readSet);
+}
+
+void NetworkManagerBase::serviceOrders(const fd_set& readSet, const fd_set& writeSet) {
+    if (!orderClient->isConnected()) return;
+    if (orderClient->isCoalescing()) {
+        orderClient->flush();
+    } else if (FD_ISSET(orderClient->getSocketFd(), &writeSet) ||
+               (orderClient->wakeFd() >= 0 && FD_ISSET(orderClient->wakeFd(), &readSet))) {
         orderClient->processSendQueue();
     }
+}
 
-    handlePeriodicTasks();
+void NetworkManagerBase::serviceEventSources(const fd_set& readSet, const fd_set& writeSet) {
+    for (EventSource* source : eventSources) source->service(readSet, writeSet);
 }
 
-void NetworkManager::stop() {
+void NetworkManagerBase::stop() {
     if (!running) return;
     running = false;
-    if (marketClient) marketClient->disconnect();
+    for (MarketLine& line : marketLines) line.client->disconnect();
     if (orderClient)  orderClient->disconnect();
 }
 
-void NetworkManager::setQuoteCallback(std::function<void(const QuoteMessage&)> cb) {
-    quoteCallback = cb;
-}
-
-void NetworkManager::setTradeCallback(std::function<void(const TradeMessage&)> cb) {
-    tradeCallback = cb;
+bool NetworkManagerBase::subscribe(const std::string& symbol) {
+    if (!subscriptions.add(symbol.data(), symbol.size())) return false;
+    for (MarketLine& line : marketLines) line.client->setSubscriptions(subscriptions);
+    return true;
 }
 
-bool NetworkManager::sendOrder(const OrderMessage& order) {
+bool NetworkManagerBase::sendOrder(const OrderMessage& order) {
     return orderClient ? orderClient->sendOrder(order) : false;
 }
 
-void NetworkManager::handleMarketData(const MessageHeader& header, const void* data) {
-    switch (header.type) {
-        case MessageHeader::QUOTE_TYPE:
-            if (quoteCallback) quoteCallback(*static_cast<const QuoteMessage*>(data));
-            break;
-        case MessageHeader::TRADE_TYPE:
-            if (tradeCallback) tradeCallback(*static_cast<const TradeMessage*>(data));
-            break;
-    }
+bool NetworkManagerBase::sendOrder(OrderTemplate& tmpl, uint64_t timestamp, uint32_t quantity, int32_t price) {
+    return orderClient ? orderClient->sendOrder(tmpl, timestamp, quantity, price) : false;
 }
 
-void NetworkManager::handlePeriodicTasks() {
+void NetworkManagerBase::handlePeriodicTasks() {
     using clock = std::chrono::steady_clock;
     static auto lastCheck = clock::now();
     auto now = clock::now();
@@ -152,36 +254,77 @@ inline uint64_t applyJitter(uint64_t baseMs, uint32_t pctLow = 85, uint32_t pctH
 }
 }
 
-void NetworkManager::tryReconnectMarket() {
+void NetworkManagerBase::tryReconnectMarket(size_t index) {
     using clock = std::chrono::steady_clock;
+    MarketLine& line = marketLines[index];
     auto now = clock::now();
-    if (now - lastMarketReconnect < std::chrono::milliseconds(marketReconnectDelay)) return;
-    lastMarketReconnect = now;
-    if (marketClient->reconnect()) {
-        marketReconnectDelay = 1000;
+    if (now - line.lastReconnect < std::chrono::milliseconds(line.reconnectDelay)) return;
+    line.lastReconnect = now;
+    if (line.client->reconnect()) {
+        marketReconnected(index);
+    } else if (!line.client->isConnecting()) {
+        marketReconnectFailed(index);
+    }
+}
+
+void NetworkManagerBase::marketReconnected(size_t index) {
+    MarketLine& line = marketLines[index];
+    line.reconnectDelay = 1000;
+    if (marketLines.size() > 1) {
+        std::cout << "Market data line " << index << " reconnected" << std::endl;
+    } else {
         std::cout << "Market data reconnected" << std::endl;
-        g_systemMetrics.cold.connectionsAccepted.fetch_add(1, std::memory_order_relaxed);
+    }
+    g_systemMetrics.cold.connectionsAccepted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void NetworkManagerBase::marketReconnectFailed(size_t index) {
+    MarketLine& line = marketLines[index];
+    line.reconnectDelay = std::min(line.reconnectDelay * 2, uint64_t(60000));
+    line.reconnectDelay = applyJitter(line.reconnectDelay);
+    if (marketLines.size() > 1) {
+        std::cerr << "Market data line " << index;
     } else {
-        marketReconnectDelay = std::min(marketReconnectDelay * 2, uint64_t(60000));
-        marketReconnectDelay = applyJitter(marketReconnectDelay);
-        std::cerr << "Market data reconnect failed, next attempt in " << marketReconnectDelay << "ms" << std::endl;
-        g_systemMetrics.cold.connectionErrors.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "Market data";
     }
+    std::cerr << " reconnect failed, next attempt in " << line.reconnectDelay << "ms" << std::endl;
+    g_systemMetrics.cold.connectionErrors.fetch_add(1, std::memory_order_relaxed);
 }
 
-void NetworkManager::tryReconnectOrder() {
+void NetworkManagerBase::tryReconnectOrder() {
     using clock = std::chrono::steady_clock;
     auto now = clock::now();
     if (now - lastOrderReconnect < std::chrono::milliseconds(orderReconnectDelay)) return;
     lastOrderReconnect = now;
     if (orderClient->reconnect()) {
-        orderReconnectDelay = 1000;
-        std::cout << "Order client reconnected" << std::endl;
-        g_systemMetrics.cold.connectionsAccepted.fetch_add(1, std::memory_order_relaxed);
-    } else {
-        orderReconnectDelay = std::min(orderReconnectDelay * 2, uint64_t(60000));
-        orderReconnectDelay = applyJitter(orderReconnectDelay);
-        std::cerr << "Order client reconnect failed, next attempt in " << orderReconnectDelay << "ms" << std::endl;
-        g_systemMetrics.cold.connectionErrors.fetch_add(1, std::memory_order_relaxed);
+        orderReconnected();
+    } else if (!orderClient->isConnecting()) {
+        orderReconnectFailed();
     }
 }
+
+void NetworkManagerBase::orderReconnected() {
+    orderReconnectDelay = 1000;
+    std::cout << "Order client reconnected" << std::endl;
+    g_systemMetrics.cold.connectionsAccepted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void NetworkManagerBase::orderReconnectFailed() {
+    orderReconnectDelay = std::min(orderReconnectDelay * 2, uint64_t(60000));
+    orderReconnectDelay = applyJitter(orderReconnectDelay);
+    std::cerr << "Order client reconnect failed, next attempt in " << orderReconnectDelay << "ms" << std::endl;
+    g_systemMetrics.cold.connectionErrors.fetch_add(1, std::memory_order_relaxed);
+}
+
+NetworkManager::NetworkManager()
+        : callbacks(std::make_unique<QuoteTradeCallbackAdapter>()) {
+    setHandler(callbacks.get());
+}
+
+void NetworkManager::setQuoteCallback(std::function<void(const QuoteMessage&)> cb) {
+    callbacks->quoteCallback = cb;
+}
+
+void NetworkManager::setTradeCallback(std::function<void(const TradeMessage&)> cb) {
+    callbacks->tradeCallback = cb;
+}
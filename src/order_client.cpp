@@ -2,52 +2,97 @@
 #include "message_serializer.h"
 #include "wire_format.h"
 #include <iostream>
-#include <iomanip>
 #include <cerrno>
 #include <cstring>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
 #include "metrics.h"
+#include "async_logger.h"
+#include "trace.h"
+
+namespace {
+inline uint64_t steadyNanos() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+}
 
 OrderClient::OrderClient(const std::string& host, uint16_t port)
     : TcpClient(host, port) {
+    int fds[2];
+    if (::pipe(fds) == 0) {
+        for (int fd : fds) ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        wakeRead = fds[0];
+        wakeWrite = fds[1];
+    } else {
+        std::cerr << "Cannot create order wakeup pipe: " << std::strerror(errno) << std::endl;
+    }
+}
+
+OrderClient::~OrderClient() {
+    if (wakeRead >= 0) ::close(wakeRead);
+    if (wakeWrite >= 0) ::close(wakeWrite);
 }
 
 bool OrderClient::sendOrder(const OrderMessage& order) noexcept {
+    if (!cachedTemplate.matches(order.symbol, order.side)) {
+        cachedTemplate = OrderTemplate(order.symbol, sizeof(order.symbol), order.side);
+    }
+    return sendOrder(cachedTemplate, order.timestamp, order.quantity, order.price);
+}
+
+bool OrderClient::sendOrder(OrderTemplate& tmpl, uint64_t timestamp, uint32_t quantity, int32_t price) noexcept {
     if (state != ConnectionState::CONNECTED) {
     std::cerr << "Cannot send order: not connected" << std::endl;
         return false;
     }
 
-    if (order.side != 'B' && order.side != 'S') return false;
-    if (order.quantity == 0) return false;
-    if (order.price <= 0) return false;
+    if (!tmpl.valid() || quantity == 0 || price <= 0) return false;
 
-    uint8_t buffer[WireFormat::ORDER_SIZE];
-    size_t size = MessageSerializer::serializeOrder(buffer, sizeof(buffer), order);
+    const uint8_t* buffer = tmpl.patch(timestamp, quantity, price);
+    const bool sent = transmit(buffer, OrderTemplate::size(), tmpl.getSide(), quantity, price);
+    VWAP_TRACE(ORDER_SEND, timestamp, sent);
+    return sent;
+}
 
-    if (size == 0) {
-        return false;
+bool OrderClient::transmit(const uint8_t* buffer, size_t size, char side, uint32_t quantity, int32_t price) noexcept {
+    if (coalesce) {
+        if (!enqueue(buffer, size)) {
+            g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        uint64_t now = steadyNanos();
+        if (batchOrders++ == 0) {
+            batchStartNanos = now;
+            batchRxKernelNanos = g_rxKernelNanos;
+        }
+        if (now - batchStartNanos >= coalesceBudgetNanos) {
+            g_systemMetrics.batch.budgetFlushes.fetch_add(1, std::memory_order_relaxed);
+            flush();
+        }
+        return true;
+    }
+
+    // Bytes already queued must reach the wire first or the stream interleaves.
+    if (backlogSize() != 0) {
+        if (enqueue(buffer, size)) { g_systemMetrics.cold.partialSends.fetch_add(1, std::memory_order_relaxed); return true; }
+        g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed); return false;
     }
 
     ssize_t sent = this->send(buffer, size);
     if (sent == static_cast<ssize_t>(size)) {
-        std::cout << "Order sent: "
-                  << (order.side == 'B' ? "BUY" : "SELL")
-                  << " " << order.quantity
-                  << " @ $" << std::fixed << std::setprecision(2)
-                  << (order.price / 100.0) << std::endl;
-        g_systemMetrics.hot.ordersPlaced.fetch_add(1, std::memory_order_relaxed);
+        VWAP_LOG_INFO(LogFmt::CLIENT_ORDER_SENT, side, quantity, static_cast<double>(price));
+        localHotCounters().ordersPlaced.add(1);
+        g_metricsView.recordKernelToOrder(g_rxKernelNanos);
         return true;
     }
     if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
-        PendingSend ps{}; std::memcpy(ps.data.data(), buffer, size); ps.length = size; ps.offset = 0;
-        std::lock_guard<std::mutex> lock(queueMutex);
-        if (enqueue(ps)) { g_systemMetrics.cold.partialSends.fetch_add(1, std::memory_order_relaxed); return true; }
+        if (enqueue(buffer, size)) { g_systemMetrics.cold.partialSends.fetch_add(1, std::memory_order_relaxed); return true; }
         g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed); return false;
     }
     if (sent >= 0 && sent < static_cast<ssize_t>(size)) {
-        PendingSend ps{}; std::memcpy(ps.data.data(), buffer + sent, size - sent); ps.length = size - sent; ps.offset = 0;
-        std::lock_guard<std::mutex> lock(queueMutex);
-        if (enqueue(ps)) { g_systemMetrics.cold.partialSends.fetch_add(1, std::memory_order_relaxed); return true; }
+        if (enqueue(buffer + sent, size - sent)) { g_systemMetrics.cold.partialSends.fetch_add(1, std::memory_order_relaxed); return true; }
         g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed); return false;
     }
     if (sent < 0) {
@@ -62,17 +107,101 @@ bool OrderClient::sendOrder(const OrderMessage& order) noexcept {
     return true;
 }
 
+bool OrderClient::queueOrder(const OrderMessage& order) noexcept {
+    if (!isSendable(order)) return false;
+
+    uint8_t buffer[WireFormat::ORDER_SIZE];
+    size_t size = MessageSerializer::serializeOrder(buffer, sizeof(buffer), order);
+    if (size == 0) return false;
+
+    PendingSend ps;
+    std::memcpy(ps.data.data(), buffer, size);
+    ps.length = size;
+    ps.offset = 0;
+    if (!inbox.tryPush(ps)) {
+        g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (!wakePending.exchange(true, std::memory_order_acq_rel) && wakeWrite >= 0) {
+        const uint8_t byte = 1;
+        ssize_t ignored = ::write(wakeWrite, &byte, 1);
+        (void)ignored;
+    }
+    return true;
+}
+
+void OrderClient::collectQueued() noexcept {
+    // Clearing first means an order queued after this point raises the pipe
+    // again; the acquire makes every order pushed before it visible below.
+    if (wakePending.exchange(false, std::memory_order_acq_rel) && wakeRead >= 0) {
+        uint8_t scratch[64];
+        while (::read(wakeRead, scratch, sizeof(scratch)) > 0) {}
+    }
+    PendingSend* queued;
+    while (backlogSize() < QUEUE_CAPACITY && (queued = inbox.peek()) != nullptr) {
+        enqueue(queued->data.data(), queued->length);
+        inbox.pop();
+    }
+    inbox.release();
+}
+
+void OrderClient::setCoalescing(bool enabled, uint64_t budgetNanos) noexcept {
+    if (coalesce && !enabled) flush();
+    coalesce = enabled;
+    coalesceBudgetNanos = budgetNanos;
+}
+
+void OrderClient::flush() noexcept {
+    uint64_t rxKernelNanos = 0;
+    if (batchOrders) {
+        g_metricsView.recordBatchDelay(steadyNanos() - batchStartNanos);
+        batchOrders = 0;
+        rxKernelNanos = batchRxKernelNanos;
+    }
+    if (hasPendingSends()) processSendQueue();
+    g_metricsView.recordKernelToOrder(rxKernelNanos);
+}
+
 void OrderClient::processSendQueue() noexcept {
-    std::lock_guard<std::mutex> lock(queueMutex);
+    collectQueued();
+    struct iovec iov[MAX_GATHER];
+    while (state == ConnectionState::CONNECTED) {
+        size_t count = 0;
+        size_t total = 0;
+        while (count < MAX_GATHER && count < backlogSize()) {
+            PendingSend* pending = &backlogAt(count);
+            iov[count].iov_base = pending->data.data() + pending->offset;
+            iov[count].iov_len = pending->length - pending->offset;
+            total += iov[count].iov_len;
+            ++count;
+        }
+        if (count == 0) break;
 
-    while (!empty() && state == ConnectionState::CONNECTED) {
-        auto& pending = front();
-        size_t remaining = pending.length - pending.offset;
-        ssize_t sent = this->send(pending.data.data() + pending.offset, remaining);
+        ssize_t sent = (count == 1)
+            ? this->send(static_cast<const uint8_t*>(iov[0].iov_base), iov[0].iov_len)
+            : this->sendv(iov, count);
 
         if (sent > 0) {
-            pending.offset += sent;
-            if (pending.offset >= pending.length) { popFront(); }
+            size_t bytes = static_cast<size_t>(sent);
+            uint64_t completed = 0;
+            while (bytes > 0) {
+                PendingSend* front = &backlogAt(0);
+                size_t remaining = front->length - front->offset;
+                if (bytes >= remaining) {
+                    bytes -= remaining;
+                    ++backlogHead;
+                    ++completed;
+                } else {
+                    front->offset += bytes;
+                    bytes = 0;
+                }
+            }
+            g_metricsView.recordOrderFlush(completed);
+            g_systemMetrics.cold.completedSends.fetch_add(completed, std::memory_order_relaxed);
+            localHotCounters().ordersPlaced.add(completed);
+            if (static_cast<size_t>(sent) < total) break;
+            // Room freed in the backlog may let more of the inbox in.
+            collectQueued();
         } else if (sent < 0) {
             if (errno == EAGAIN || errno == EWOULDBLOCK) {
 
@@ -84,13 +213,20 @@ void OrderClient::processSendQueue() noexcept {
 
                 state = ConnectionState::DISCONNECTED;
 
-                while (!empty()) popFront();
+                dropPending();
                 break;
             } else {
 
-                while (!empty()) popFront();
+                dropPending();
                 break;
             }
+        } else {
+            break;
         }
     }
 }
+
+void OrderClient::dropPending() noexcept {
+    backlogHead = backlogTail;
+    inbox.drain();
+}
@@ -3,17 +3,22 @@
 #include <iomanip>
 #include <cstring>
 #include <algorithm>
+#include "async_logger.h"
+#include "trace.h"
 
-OrderManager::OrderManager(const std::string& symbol, char side, uint32_t maxOrderSize, uint32_t vwapWindowSeconds)
+OrderManager::OrderManager(const std::string& symbol, char side, uint32_t maxOrderSize, uint32_t vwapWindowSeconds,
+                           bool announce)
     : symbol(symbol),
       side(side),
       maxOrderSize(maxOrderSize),
       vwapWindowSeconds(vwapWindowSeconds),
       currentState(State::WAITING_FOR_FIRST_WINDOW),
+      orderTemplate(symbol.data(), symbol.size(), side),
       totalQuotesProcessed(0),
       totalTradesProcessed(0),
       totalOrdersSent(0),
-      vwapWindowCompleteNotified(false) {
+      vwapWindowCompleteNotified(false),
+      announce(announce) {
 
     if (side != 'B' && side != 'S') {
         throw std::invalid_argument("Side must be 'B' or 'S'");
@@ -30,6 +35,7 @@ OrderManager::OrderManager(const std::string& symbol, char side, uint32_t maxOrd
     decisionEngine = std::make_unique<DecisionEngine>(symbol, side, this->maxOrderSize);
     vwapCalculator = std::make_unique<VwapCalculator>(this->vwapWindowSeconds);
 
+    if (!announce) return;
     std::cout << "OrderManager initialized:" << std::endl;
     std::cout << "  Symbol: " << symbol << std::endl;
     std::cout << "  Side: " << side << " (" << (side == 'B' ? "BUY" : "SELL") << ")" << std::endl;
@@ -41,19 +47,32 @@ OrderManager::~OrderManager() {
 }
 
 Optional<OrderMessage> OrderManager::processQuote(const QuoteMessage& quote) {
+    if (side == 'B') return processQuote(quote.timestamp, quote.askPrice, quote.askQuantity);
+    return processQuote(quote.timestamp, static_cast<int32_t>(quote.bidPrice), quote.bidQuantity);
+}
+
+Optional<OrderMessage> OrderManager::processQuote(const QuoteView& quote) {
+    if (side == 'B') return processQuote(quote.timestamp(), quote.askPrice(), quote.askQuantity());
+    return processQuote(quote.timestamp(), static_cast<int32_t>(quote.bidPrice()), quote.bidQuantity());
+}
+
+Optional<OrderMessage> OrderManager::processQuote(uint64_t timestamp, int32_t price, uint32_t quantity) {
     totalQuotesProcessed++;
 
     checkVwapWindowComplete();
 
     double currentVwap = vwapCalculator->getCurrentVwap();
 
-    Optional<OrderMessage> orderOpt = decisionEngine->evaluateQuote(quote, currentVwap);
+    Optional<OrderMessage> orderOpt = decisionEngine->evaluateQuote(timestamp, price, quantity, currentVwap);
+    VWAP_TRACE(DECISION, timestamp, orderOpt.has_value());
 
     if (orderOpt.has_value()) {
         OrderMessage order = orderOpt.value();
 
-    std::string reason = buildReason(quote, static_cast<int32_t>(currentVwap));
+    std::string reason = buildReason(price, static_cast<int32_t>(currentVwap));
     recordOrder(order, reason);
+    VWAP_LOG_INFO(LogFmt::MANAGER_ORDER_SENT, LogSymbol(order.symbol), order.side, order.quantity,
+                  static_cast<double>(order.price), currentVwap);
         totalOrdersSent++;
     if (orderCallback) orderCallback(order);
     }
@@ -64,12 +83,27 @@ Optional<OrderMessage> OrderManager::processQuote(const QuoteMessage& quote) {
 void OrderManager::processTrade(const TradeMessage& trade) {
     totalTradesProcessed++;
     vwapCalculator->addTrade(trade);
+    VWAP_TRACE(VWAP_UPDATE, trade.timestamp, 1);
     checkVwapWindowComplete();
 
     if (totalTradesProcessed % 10 == 0) {
-        double vwap = vwapCalculator->getCurrentVwap();
-        std::cout << "[VWAP UPDATE] Current VWAP: $" << (vwap / 100.0)
-                  << " (after " << totalTradesProcessed << " trades)" << std::endl;
+        VWAP_LOG_INFO(LogFmt::MANAGER_VWAP_UPDATE, vwapCalculator->getCurrentVwap(), totalTradesProcessed);
+    }
+}
+
+void OrderManager::processTrades(const uint64_t* timestamps, const uint32_t* quantities,
+                                 const int32_t* prices, size_t count) {
+    if (count == 0) return;
+    uint64_t before = totalTradesProcessed;
+    totalTradesProcessed += count;
+    vwapCalculator->addTrades(timestamps, quantities, prices, count);
+#ifdef VWAP_TRACING
+    for (size_t i = 0; i < count; ++i) VWAP_TRACE(VWAP_UPDATE, timestamps[i], count);
+#endif
+    checkVwapWindowComplete();
+
+    if (totalTradesProcessed / 10 != before / 10) {
+        VWAP_LOG_INFO(LogFmt::MANAGER_VWAP_UPDATE, vwapCalculator->getCurrentVwap(), totalTradesProcessed);
     }
 }
 
@@ -77,9 +111,9 @@ void OrderManager::checkVwapWindowComplete() {
     if (currentState == State::WAITING_FOR_FIRST_WINDOW &&
         vwapCalculator->hasCompleteWindow()) {
         currentState = State::READY_TO_TRADE;
-        decisionEngine->onVwapWindowComplete();
+        decisionEngine->onVwapWindowComplete(announce);
 
-        if (!vwapWindowCompleteNotified) {
+        if (!vwapWindowCompleteNotified && announce) {
             std::cout << "VWAP window complete - ready to trade" << std::endl;
             vwapWindowCompleteNotified = true;
         }
@@ -101,19 +135,18 @@ void OrderManager::recordOrder(const OrderMessage& order, const std::string& rea
     record.reason = reason;
 
     orderHistory.push_back(std::move(record));
-
-    std::cout << "[ORDER SENT] " << record.symbol
-              << " " << (record.side == 'B' ? "BUY" : "SELL")
-              << " " << record.quantity
-              << " @ $" << (record.price / 100.0)
-              << " | " << reason << std::endl;
 }
 
-std::string OrderManager::buildReason(const QuoteMessage& q, int32_t vwapCents) const {
+std::string OrderManager::buildReason(int32_t price, int32_t vwapCents) const {
     if (side == 'B') {
-        return std::string("Buy Order: Ask (") + std::to_string(q.askPrice) + ") < VWAP (" + std::to_string(vwapCents) + ")";
+        return std::string("Buy Order: Ask (") + std::to_string(price) + ") < VWAP (" + std::to_string(vwapCents) + ")";
     }
-    return std::string("Sell Order: Bid (") + std::to_string(q.bidPrice) + ") > VWAP (" + std::to_string(vwapCents) + ")";
+    return std::string("Sell Order: Bid (") + std::to_string(price) + ") > VWAP (" + std::to_string(vwapCents) + ")";
+}
+
+void OrderManager::prefault() noexcept {
+    vwapCalculator->prefault();
+    Realtime::prefault(&orderHistory, sizeof(orderHistory));
 }
 
 void OrderManager::printStatistics() const {
@@ -0,0 +1,148 @@
+#include "perf_counters.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+#if defined(__linux__)
+struct EventSpec {
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t cacheEvent(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+// Indexed by PerfCounters::Event; CYCLES leads the group.
+const EventSpec EVENTS[PerfCounters::EVENT_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, cacheEvent(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+int openEvent(const EventSpec& spec, int groupFd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.disabled = groupFd < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+std::string paranoidLevel() {
+    std::ifstream in("/proc/sys/kernel/perf_event_paranoid");
+    std::string level;
+    if (!(in >> level)) return "unknown";
+    return level;
+}
+#endif
+}
+
+PerfCounters::PerfCounters() noexcept : leaderFd(-1), members(0) {
+    for (size_t i = 0; i < EVENT_COUNT; ++i) {
+        fds[i] = -1;
+        slot[i] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    close();
+}
+
+const char* PerfCounters::eventName(Event event) noexcept {
+    switch (event) {
+        case CYCLES:        return "cycles";
+        case INSTRUCTIONS:  return "instructions";
+        case L1D_MISSES:    return "L1D misses";
+        case LLC_MISSES:    return "LLC misses";
+        case BRANCH_MISSES: return "branch misses";
+        default:            return "unknown";
+    }
+}
+
+bool PerfCounters::open() {
+    close();
+#if defined(__linux__)
+    leaderFd = openEvent(EVENTS[CYCLES], -1);
+    if (leaderFd < 0) {
+        const int err = errno;
+        if (err == EACCES || err == EPERM) {
+            reason = std::string(strerror(err)) + " (perf_event_paranoid=" + paranoidLevel() +
+                     "; user-space counting needs 2 or lower, or CAP_PERFMON)";
+        } else if (err == ENOENT || err == EOPNOTSUPP) {
+            reason = "no hardware PMU available (virtual machine or container without PMU passthrough)";
+        } else if (err == ENOSYS) {
+            reason = "perf_event_open is not supported by this kernel";
+        } else {
+            reason = strerror(err);
+        }
+        return false;
+    }
+    fds[CYCLES] = leaderFd;
+    slot[CYCLES] = 0;
+    members = 1;
+    for (size_t i = CYCLES + 1; i < EVENT_COUNT; ++i) {
+        fds[i] = openEvent(EVENTS[i], leaderFd);
+        if (fds[i] >= 0) slot[i] = static_cast<int>(members++);
+    }
+    reason.clear();
+    return true;
+#else
+    reason = "perf_event_open is Linux only";
+    return false;
+#endif
+}
+
+void PerfCounters::close() noexcept {
+    for (size_t i = 0; i < EVENT_COUNT; ++i) {
+        if (fds[i] >= 0) ::close(fds[i]);
+        fds[i] = -1;
+        slot[i] = -1;
+    }
+    leaderFd = -1;
+    members = 0;
+}
+
+void PerfCounters::start() noexcept {
+#if defined(__linux__)
+    if (leaderFd < 0) return;
+    ::ioctl(leaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(leaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+PerfCounters::Reading PerfCounters::stop() noexcept {
+    Reading reading{};
+#if defined(__linux__)
+    if (leaderFd < 0) return reading;
+    ::ioctl(leaderFd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // { nr, time_enabled, time_running, value[nr] }
+    uint64_t buffer[3 + EVENT_COUNT];
+    const ssize_t bytes = ::read(leaderFd, buffer, sizeof(buffer));
+    if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buffer[0] != members) return reading;
+    const uint64_t enabled = buffer[1], running = buffer[2];
+    if (enabled == 0 || running == 0) return reading;
+
+    reading.coverage = static_cast<double>(running) / static_cast<double>(enabled);
+    for (size_t i = 0; i < EVENT_COUNT; ++i) {
+        if (slot[i] < 0) continue;
+        reading.counted[i] = true;
+        reading.values[i] = static_cast<uint64_t>(static_cast<double>(buffer[3 + slot[i]]) / reading.coverage);
+    }
+#endif
+    return reading;
+}
@@ -0,0 +1,76 @@
+#include "rate_meter.h"
+#include <algorithm>
+#include <cstdio>
+
+RateMeter::RateMeter() noexcept
+    : history{}, next(0), filled(0), lastNanos(0), lastTotals{}, peak{0, 0, 0} {}
+
+void RateMeter::sample(uint64_t nowNanos, const HotCounters::Totals& totals) noexcept {
+    if (lastNanos == 0 || nowNanos <= lastNanos) {
+        lastNanos = nowNanos ? nowNanos : 1;
+        lastTotals = totals;
+        return;
+    }
+
+    const double elapsed = static_cast<double>(nowNanos - lastNanos) / NANOS_PER_SECOND;
+    const Second rate = {
+        static_cast<double>(totals.messagesReceived - lastTotals.messagesReceived) / elapsed,
+        static_cast<double>(totals.bytesReceived + totals.bytesSent
+                            - lastTotals.bytesReceived - lastTotals.bytesSent) / elapsed,
+        static_cast<double>(totals.ordersPlaced - lastTotals.ordersPlaced) / elapsed,
+    };
+    const uint64_t seconds = std::max<uint64_t>(1, (nowNanos - lastNanos) / NANOS_PER_SECOND);
+    for (uint64_t i = 0; i < std::min<uint64_t>(seconds, uint64_t{SECONDS}); ++i) {
+        history[next] = rate;
+        next = (next + 1) % SECONDS;
+    }
+    filled = std::min<uint64_t>(filled + seconds, uint64_t{SECONDS});
+
+    peak.messages = std::max(peak.messages, rate.messages);
+    peak.bytes = std::max(peak.bytes, rate.bytes);
+    peak.orders = std::max(peak.orders, rate.orders);
+
+    const uint64_t peakMessages = static_cast<uint64_t>(peak.messages);
+    auto& stored = g_systemMetrics.perf.peakMessagesPerSecond;
+    uint64_t current = stored.load(std::memory_order_relaxed);
+    while (peakMessages > current && !stored.compare_exchange_weak(current, peakMessages, std::memory_order_relaxed)) {}
+
+    lastNanos = nowNanos;
+    lastTotals = totals;
+}
+
+RateMeter::Rates RateMeter::rates(double Second::*field) const noexcept {
+    Rates r;
+    if (filled == 0) return r;
+    double sum10 = 0, sum60 = 0;
+    for (size_t i = 0; i < filled; ++i) {
+        const double v = history[(next + SECONDS - 1 - i) % SECONDS].*field;
+        if (i < 10) sum10 += v;
+        sum60 += v;
+    }
+    r.last = history[(next + SECONDS - 1) % SECONDS].*field;
+    r.avg10 = sum10 / static_cast<double>(std::min<uint64_t>(filled, 10));
+    r.avg60 = sum60 / static_cast<double>(filled);
+    r.peak = peak.*field;
+    return r;
+}
+
+RateMeter::Report RateMeter::report() const noexcept {
+    Report report;
+    report.messages = rates(&Second::messages);
+    report.bytes = rates(&Second::bytes);
+    report.orders = rates(&Second::orders);
+    report.seconds = filled;
+    return report;
+}
+
+void RateMeter::Report::print() const {
+    auto line = [](const char* name, const Rates& rates) {
+        std::printf("  %-9s %12.1f %12.1f %12.1f %12.1f\n", name, rates.last, rates.avg10, rates.avg60, rates.peak);
+    };
+    std::printf("Rates per second over the last %llus\n", (unsigned long long)seconds);
+    std::printf("  %-9s %12s %12s %12s %12s\n", "", "last 1s", "10s avg", "60s avg", "peak");
+    line("messages", messages);
+    line("bytes", bytes);
+    line("orders", orders);
+}
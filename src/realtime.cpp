@@ -0,0 +1,69 @@
+#include "realtime.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sched.h>
+#include <sys/mman.h>
+
+bool Realtime::pinThread(pthread_t thread, int cpu) noexcept {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int rc = pthread_setaffinity_np(thread, sizeof(set), &set);
+    if (rc != 0) {
+        std::cerr << "Cannot pin thread to CPU " << cpu << ": " << strerror(rc) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Realtime::setFifoPriority(pthread_t thread, int priority) noexcept {
+    struct sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+    int rc = pthread_setschedparam(thread, SCHED_FIFO, &param);
+    if (rc != 0) {
+        std::cerr << "Cannot set SCHED_FIFO priority " << priority << ": " << strerror(rc) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Realtime::lockMemory() noexcept {
+    if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        std::cerr << "Cannot lock memory: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Realtime::reportThread(const char* name, pthread_t thread) {
+    std::cout << "  " << name << ": CPUs ";
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(thread, sizeof(set), &set) == 0) {
+        // Ranges, e.g. "0-3,6".
+        bool first = true;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (!CPU_ISSET(cpu, &set)) continue;
+            int last = cpu;
+            while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &set)) ++last;
+            std::cout << (first ? "" : ",") << cpu;
+            if (last > cpu) std::cout << "-" << last;
+            first = false;
+            cpu = last;
+        }
+    } else {
+        std::cout << "unknown";
+    }
+
+    int policy = 0;
+    struct sched_param param;
+    if (pthread_getschedparam(thread, &policy, &param) == 0) {
+        if (policy == SCHED_FIFO) std::cout << ", SCHED_FIFO priority " << param.sched_priority;
+        else if (policy == SCHED_RR) std::cout << ", SCHED_RR priority " << param.sched_priority;
+        else std::cout << ", SCHED_OTHER";
+    }
+    std::cout << std::endl;
+}
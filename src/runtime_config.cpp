@@ -0,0 +1,137 @@
+#include "runtime_config.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+bool envFlag(const char* name, bool def) {
+    const char* v = std::getenv(name);
+    if (!v || !*v) return def;
+    return !(std::strcmp(v, "0") == 0 || std::strcmp(v, "false") == 0 || std::strcmp(v, "off") == 0);
+}
+
+uint64_t envU64(const char* name, uint64_t def) {
+    const char* v = std::getenv(name);
+    if (!v || !*v) return def;
+    char* end = nullptr;
+    unsigned long long parsed = std::strtoull(v, &end, 10);
+    if (*end != '\0') {
+        std::cerr << "Ignoring invalid " << name << "=" << v << std::endl;
+        return def;
+    }
+    return parsed;
+}
+
+int envInt(const char* name, int def, int min, int max) {
+    const char* v = std::getenv(name);
+    if (!v || !*v) return def;
+    char* end = nullptr;
+    long parsed = std::strtol(v, &end, 10);
+    if (*end != '\0' || parsed < min || parsed > max) {
+        std::cerr << "Ignoring invalid " << name << "=" << v << std::endl;
+        return def;
+    }
+    return static_cast<int>(parsed);
+}
+
+void envSocketTuning(const char* name, SocketTuning& tuning) {
+    const char* v = std::getenv(name);
+    if (!v || !*v) return;
+    if (!SocketTuning::parse(v, tuning)) std::cerr << "Ignoring invalid " << name << "=" << v << std::endl;
+}
+
+// "host:port,host:port"
+std::vector<FeedEndpoint> envEndpoints(const char* name) {
+    std::vector<FeedEndpoint> endpoints;
+    const char* v = std::getenv(name);
+    if (!v || !*v) return endpoints;
+    std::string list(v);
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) end = list.size();
+        std::string item = list.substr(start, end - start);
+        size_t colon = item.rfind(':');
+        char* portEnd = nullptr;
+        unsigned long port = colon == std::string::npos ? 0 : std::strtoul(item.c_str() + colon + 1, &portEnd, 10);
+        if (colon == 0 || port == 0 || port > 65535 || *portEnd != '\0') {
+            std::cerr << "Ignoring invalid " << name << " entry \"" << item << "\"" << std::endl;
+        } else {
+            endpoints.push_back(FeedEndpoint{item.substr(0, colon), static_cast<uint16_t>(port)});
+        }
+        start = end + 1;
+    }
+    return endpoints;
+}
+}
+
+RuntimeConfig& runtimeConfig() {
+    static RuntimeConfig cfg;
+    return cfg;
+}
+
+void RuntimeConfig::loadFromEnv() {
+    coalesceOrders = envFlag("VWAP_COALESCE_ORDERS", coalesceOrders);
+    coalesceBudgetNanos = envU64("VWAP_COALESCE_BUDGET_NS", coalesceBudgetNanos);
+    if (const char* v = std::getenv("VWAP_LOG_FILE")) logFile = v;
+    batchDispatch = envFlag("VWAP_BATCH_DISPATCH", batchDispatch);
+    conflateQuotes = envFlag("VWAP_CONFLATE_QUOTES", conflateQuotes);
+    rxTimestamps = envFlag("VWAP_RX_TIMESTAMPS", rxTimestamps);
+    envSocketTuning("VWAP_MD_SOCKET", marketDataSocket);
+    envSocketTuning("VWAP_ORDER_SOCKET", orderSocket);
+    eventLoopCpu = envInt("VWAP_CPU_EVENT_LOOP", eventLoopCpu, -1, 1023);
+    loggerCpu = envInt("VWAP_CPU_LOGGER", loggerCpu, -1, 1023);
+    fifoPriority = envInt("VWAP_FIFO_PRIORITY", fifoPriority, 0, 99);
+    lockMemory = envFlag("VWAP_MLOCK", lockMemory);
+    prefault = envFlag("VWAP_PREFAULT", prefault);
+    warmup = envFlag("VWAP_WARMUP", warmup);
+    if (const char* v = std::getenv("VWAP_STATS_SHM")) statsSegment = v;
+    statsIntervalMicros = std::max<uint64_t>(envU64("VWAP_STATS_INTERVAL_US", statsIntervalMicros), 1);
+    metricsPort = static_cast<uint16_t>(envInt("VWAP_METRICS_PORT", metricsPort, 0, 65535));
+    if (const char* v = std::getenv("VWAP_TRACE_FILE")) traceFile = v;
+    if (const char* v = std::getenv("VWAP_TRACE_MODE")) {
+        if (std::strcmp(v, "signal") == 0) traceOnSignal = true;
+        else if (std::strcmp(v, "stream") == 0) traceOnSignal = false;
+        else std::cerr << "Ignoring invalid VWAP_TRACE_MODE=" << v << std::endl;
+    }
+    if (std::getenv("VWAP_MD_LINES")) extraMarketDataLines = envEndpoints("VWAP_MD_LINES");
+    if (const char* v = std::getenv("VWAP_MD_TRANSPORT")) {
+        if (std::strcmp(v, "udp") == 0) marketDataUdp = true;
+        else if (std::strcmp(v, "tcp") == 0) marketDataUdp = false;
+        else std::cerr << "Ignoring invalid VWAP_MD_TRANSPORT=" << v << std::endl;
+    }
+}
+
+void RuntimeConfig::print() const {
+    std::cout << "Runtime Options:" << std::endl;
+    std::cout << "  Order Coalescing: " << (coalesceOrders ? "ON" : "OFF");
+    if (coalesceOrders) std::cout << " (budget " << coalesceBudgetNanos << " ns)";
+    std::cout << std::endl;
+    std::cout << "  Log Output: " << (logFile.empty() ? "stdout" : logFile) << std::endl;
+    std::cout << "  Batch Dispatch: " << (batchDispatch ? "ON" : "OFF") << std::endl;
+    std::cout << "  Quote Conflation: " << (conflateQuotes ? "ON" : "OFF") << std::endl;
+    std::cout << "  Market Data Transport: " << (marketDataUdp ? "UDP" : "TCP") << std::endl;
+    std::cout << "  Receive Timestamps: " << (rxTimestamps ? "ON" : "OFF") << std::endl;
+    std::cout << "  Socket Profiles: market data " << marketDataSocket.name << ", orders " << orderSocket.name << std::endl;
+    std::cout << "  Event Loop CPU: " << (eventLoopCpu < 0 ? std::string("any") : std::to_string(eventLoopCpu));
+    if (fifoPriority > 0) std::cout << " (SCHED_FIFO " << fifoPriority << ")";
+    std::cout << std::endl;
+    std::cout << "  Logger CPU: " << (loggerCpu < 0 ? std::string("any") : std::to_string(loggerCpu)) << std::endl;
+    std::cout << "  Memory: " << (lockMemory ? "locked" : "pageable") << (prefault ? ", prefaulted" : "") << std::endl;
+    std::cout << "  Warmup: " << (warmup ? "ON" : "OFF") << std::endl;
+    std::cout << "  Stats Segment: " << (statsSegment.empty() ? std::string("OFF") : statsSegment);
+    if (!statsSegment.empty()) std::cout << " (every " << statsIntervalMicros << " us)";
+    std::cout << std::endl;
+    std::cout << "  Metrics Endpoint: "
+              << (metricsPort ? "http://127.0.0.1:" + std::to_string(metricsPort) + "/metrics" : std::string("OFF"))
+              << std::endl;
+    std::cout << "  Trace File: " << (traceFile.empty() ? std::string("OFF") : traceFile);
+    if (!traceFile.empty()) std::cout << (traceOnSignal ? " (on SIGUSR2)" : " (streaming)");
+    std::cout << std::endl;
+    if (!extraMarketDataLines.empty()) {
+        std::cout << "  Redundant Feed Lines:";
+        for (const FeedEndpoint& e : extraMarketDataLines) std::cout << " " << e.host << ":" << e.port;
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,168 @@
+#include "shm_ring.h"
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+bool ShmRing::parseAddress(const std::string& address, std::string& name) {
+    const size_t schemeLength = std::strlen(SCHEME);
+    if (address.compare(0, schemeLength, SCHEME) != 0) return false;
+    std::string candidate = address.substr(schemeLength);
+    if (candidate.empty() || candidate.find('/') != std::string::npos) return false;
+    name = candidate;
+    return true;
+}
+
+std::string ShmRing::path(const std::string& name) {
+    return "/dev/shm/" + name;
+}
+
+ShmRingWriter::ShmRingWriter(size_t requestedSlots)
+    : header(nullptr), slots(nullptr), slotCount(2), sequence(0) {
+    while (slotCount < requestedSlots) slotCount <<= 1;
+}
+
+ShmRingWriter::~ShmRingWriter() {
+    close();
+}
+
+bool ShmRingWriter::create(const std::string& name) {
+    close();
+    const std::string file = ShmRing::path(name);
+    int fd = ::open(file.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to create shared memory ring " << file << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    const size_t bytes = ShmRing::mappedSize(slotCount);
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) < 0) {
+        std::cerr << "Failed to size shared memory ring " << file << ": " << strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory ring " << file << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    header = static_cast<ShmRing::Header*>(base);
+    slots = reinterpret_cast<ShmRing::Slot*>(static_cast<uint8_t*>(base) + sizeof(ShmRing::Header));
+
+    // Readers still attached from a previous writer see the ring close, then
+    // every slot rewound; writing the slots also faults in every page now.
+    header->writerOpen.store(0, std::memory_order_release);
+    header->writeSequence.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < slotCount; ++i) {
+        slots[i].sequence.store(0, std::memory_order_relaxed);
+        slots[i].length = 0;
+    }
+    header->magic = ShmRing::MAGIC;
+    header->version = ShmRing::VERSION;
+    header->slotCount = static_cast<uint32_t>(slotCount);
+    header->slotSize = static_cast<uint32_t>(sizeof(ShmRing::Slot));
+    sequence = 0;
+    header->writerOpen.store(1, std::memory_order_release);
+    return true;
+}
+
+void ShmRingWriter::close() noexcept {
+    if (!header) return;
+    header->writerOpen.store(0, std::memory_order_release);
+    ::munmap(header, ShmRing::mappedSize(slotCount));
+    header = nullptr;
+    slots = nullptr;
+}
+
+ShmRingReader::ShmRingReader() noexcept
+    : header(nullptr), slots(nullptr), slotCount(0), mappedBytes(0), next(1) {
+}
+
+ShmRingReader::~ShmRingReader() {
+    close();
+}
+
+bool ShmRingReader::open(const std::string& name) {
+    close();
+    const std::string file = ShmRing::path(name);
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    ShmRing::Header probe;
+    bool valid = ::fstat(fd, &st) == 0 &&
+                 ::pread(fd, &probe, sizeof(probe), 0) == static_cast<ssize_t>(sizeof(probe)) &&
+                 probe.magic == ShmRing::MAGIC && probe.version == ShmRing::VERSION &&
+                 probe.slotSize == sizeof(ShmRing::Slot) && probe.slotCount >= 2 &&
+                 (probe.slotCount & (probe.slotCount - 1)) == 0 &&
+                 static_cast<size_t>(st.st_size) == ShmRing::mappedSize(probe.slotCount);
+    if (!valid) {
+        ::close(fd);
+        return false;
+    }
+    void* base = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+
+    header = static_cast<const ShmRing::Header*>(base);
+    slots = reinterpret_cast<const ShmRing::Slot*>(static_cast<const uint8_t*>(base) + sizeof(ShmRing::Header));
+    slotCount = probe.slotCount;
+    mappedBytes = static_cast<size_t>(st.st_size);
+    if (header->writerOpen.load(std::memory_order_acquire) == 0) {
+        close();
+        return false;
+    }
+    next = header->writeSequence.load(std::memory_order_acquire) + 1;
+    return true;
+}
+
+void ShmRingReader::close() noexcept {
+    if (!header) return;
+    ::munmap(const_cast<ShmRing::Header*>(header), mappedBytes);
+    header = nullptr;
+    slots = nullptr;
+}
+
+ssize_t ShmRingReader::read(uint8_t* out, size_t maxBytes, uint64_t& lost) noexcept {
+    const uint64_t mask = slotCount - 1;
+    size_t copied = 0;
+    while (true) {
+        const ShmRing::Slot& slot = slots[(next - 1) & mask];
+        const uint64_t expected = 2 * next;
+        uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (seq == expected) {
+            const size_t length = slot.length;
+            if (length <= sizeof(slot.data)) {
+                if (copied + length > maxBytes) break;
+                std::memcpy(out + copied, slot.data, length);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == expected) {
+                    copied += length;
+                    ++next;
+                    continue;
+                }
+            }
+            seq = expected + 1;
+        }
+        if (seq < expected) break;
+
+        // Lapped: resume half a ring behind the writer so it cannot lap us
+        // again straight away.
+        const uint64_t written = header->writeSequence.load(std::memory_order_acquire);
+        uint64_t resume = written > slotCount / 2 ? written - slotCount / 2 + 1 : 1;
+        if (resume <= next) resume = next + 1;
+        lost += resume - next;
+        g_systemMetrics.feed.ringOverruns.fetch_add(resume - next, std::memory_order_relaxed);
+        next = resume;
+    }
+
+    if (copied == 0) {
+        const uint64_t written = header->writeSequence.load(std::memory_order_acquire);
+        if (header->writerOpen.load(std::memory_order_acquire) == 0) return -1;
+        // A restarted writer begins again at message 1.
+        if (written + 1 < next) next = 1;
+    }
+    return static_cast<ssize_t>(copied);
+}
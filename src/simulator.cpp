@@ -4,6 +4,7 @@
 #include "wire_format.h"
 #include <iostream>
 #include <cstring>
+#include <cerrno>
 #include <cstdlib>
 #include <cmath>
 #include <chrono>
@@ -20,15 +21,25 @@
 #include <fcntl.h>
 #include <signal.h>
 
+namespace {
+// Catching up after a stall sends at most this many messages in one tick.
+constexpr long MAX_MESSAGES_PER_TICK = 100;
+}
+
 MarketDataSimulator::MarketDataSimulator(const SimulatorConfig& cfg)
     : config(cfg)
     , running(false)
     , shouldStop(false)
     , serverSocket(-1)
-    , rngSeed(std::chrono::steady_clock::now().time_since_epoch().count())
+    , rngSeed(cfg.seed ? cfg.seed : std::chrono::steady_clock::now().time_since_epoch().count())
     , currentBid(config.basePrice - 0.01)
     , currentAsk(config.basePrice + 0.01)
-    , sequenceNumber(0) {
+    , sequenceNumber(0)
+    , datagramFrames(0)
+    , datagramSequence(1)
+    , datagramsSent(0)
+    , datagramSendFailures(0)
+    , lastSendError(0) {
 
     if (config.scenario == MarketScenario::CSV_REPLAY && !config.csvPath.empty()) {
         auto csvReader = std::make_unique<CSVReader>(config.csvPath);
@@ -76,7 +87,71 @@ void MarketDataSimulator::stop() {
     running.store(false);
 }
 
+bool MarketDataSimulator::setupUdpSocket() {
+    size_t colon = config.udpTarget.rfind(':');
+    struct sockaddr_in target;
+    memset(&target, 0, sizeof(target));
+    target.sin_family = AF_INET;
+    if (colon == std::string::npos ||
+        inet_pton(AF_INET, config.udpTarget.substr(0, colon).c_str(), &target.sin_addr) <= 0) {
+        std::cerr << "Invalid UDP target " << config.udpTarget << std::endl;
+        return false;
+    }
+    target.sin_port = htons(static_cast<uint16_t>(std::stoi(config.udpTarget.substr(colon + 1))));
+
+    serverSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (serverSocket < 0) {
+        std::cerr << "Failed to create UDP socket" << std::endl;
+        return false;
+    }
+    if (connect(serverSocket, (struct sockaddr*)&target, sizeof(target)) < 0) {
+        std::cerr << "Failed to set UDP target " << config.udpTarget << std::endl;
+        close(serverSocket);
+        serverSocket = -1;
+        return false;
+    }
+    datagram.reserve(WireFormat::MAX_DATAGRAM_SIZE);
+    if (config.verbose) {
+        std::cout << "Simulator sending UDP to " << config.udpTarget << std::endl;
+    }
+    return true;
+}
+
+void MarketDataSimulator::sendDatagramFrame(const uint8_t* data, size_t size) {
+    if (datagram.empty()) datagram.resize(WireFormat::DATAGRAM_SEQUENCE_SIZE);
+    datagram.insert(datagram.end(), data, data + size);
+    ++datagramFrames;
+    if (datagramFrames < config.udpFramesPerDatagram &&
+        datagram.size() + WireFormat::MAX_MESSAGE_SIZE <= WireFormat::MAX_DATAGRAM_SIZE) {
+        return;
+    }
+    flushDatagram();
+}
+
+void MarketDataSimulator::flushDatagram() {
+    if (datagramFrames == 0 || serverSocket < 0) return;
+    uint64_t sequence = EndianConverter::htol64(datagramSequence++);
+    memcpy(datagram.data(), &sequence, sizeof(sequence));
+    if (send(serverSocket, datagram.data(), datagram.size(), 0) < 0) {
+        ++datagramSendFailures;
+        lastSendError = errno;
+    }
+    ++datagramsSent;
+    datagram.clear();
+    datagramFrames = 0;
+}
+
 bool MarketDataSimulator::setupSocket() {
+    if (!config.shmName.empty()) {
+        ringWriter = std::make_unique<ShmRingWriter>();
+        if (!ringWriter->create(config.shmName)) return false;
+        if (config.verbose) {
+            std::cout << "Simulator publishing to " << ShmRing::path(config.shmName) << std::endl;
+        }
+        return true;
+    }
+    if (!config.udpTarget.empty()) return setupUdpSocket();
+
     serverSocket = socket(AF_INET, SOCK_STREAM, 0);
     if (serverSocket < 0) {
         std::cerr << "Failed to create socket" << std::endl;
@@ -119,6 +194,10 @@ bool MarketDataSimulator::setupSocket() {
 }
 
 void MarketDataSimulator::runServer() {
+    if (ringWriter || !config.udpTarget.empty()) {
+        generateMarketData();
+        return;
+    }
     std::thread acceptThread(&MarketDataSimulator::acceptClients, this);
     std::thread dataThread(&MarketDataSimulator::generateMarketData, this);
 
@@ -163,7 +242,7 @@ void MarketDataSimulator::generateMarketData() {
     auto lastMessageTime = startTime;
 
     int messagesPerSec = std::max(1, std::min(10000, config.messagesPerSecond));
-    int messageInterval = 1000000 / messagesPerSec;
+    const std::chrono::nanoseconds messageInterval(1000000000LL / messagesPerSec);
 
     while (!shouldStop.load()) {
         auto now = std::chrono::steady_clock::now();
@@ -176,47 +255,59 @@ void MarketDataSimulator::generateMarketData() {
             }
         }
 
-        auto timeSinceLastMessage = std::chrono::duration_cast<std::chrono::microseconds>(
-            now - lastMessageTime).count();
-
-        if (timeSinceLastMessage >= messageInterval) {
-
-            switch (config.scenario) {
-                case MarketScenario::STEADY:
-                    generateSteadyPrices();
-                    break;
-                case MarketScenario::TRENDING_UP:
-                    generateTrendingPrices(true);
-                    break;
-                case MarketScenario::TRENDING_DOWN:
-                    generateTrendingPrices(false);
-                    break;
-                case MarketScenario::VOLATILE:
-                    generateVolatilePrices();
-                    break;
-                case MarketScenario::CSV_REPLAY:
-                    replayFromCSV();
-                    break;
+        // Every message due since the last tick goes out in this one, so rates
+        // above the 1 ms tick are met and a datagram can carry several frames
+        // without holding any past the tick. The schedule advances by whole
+        // intervals so the remainder carries into the next tick; it resyncs to
+        // now only when a stall hits the per-tick cap.
+        long due = (now - lastMessageTime) / messageInterval;
+        if (due > 0) {
+            if (due > MAX_MESSAGES_PER_TICK) {
+                due = MAX_MESSAGES_PER_TICK;
+                lastMessageTime = now;
+            } else {
+                lastMessageTime += due * messageInterval;
             }
+            while (due-- > 0) generateMessage();
+            flushDatagram();
+        }
 
-            if (sequenceNumber % 3 == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(1000));
+    }
+}
 
-                TradeMessage trade = createTrade();
-                std::vector<uint8_t> data = serializeTrade(trade);
-                broadcastMessage(data.data(), data.size());
-            } else {
+void MarketDataSimulator::generateMessage() {
+    switch (config.scenario) {
+        case MarketScenario::STEADY:
+            generateSteadyPrices();
+            break;
+        case MarketScenario::TRENDING_UP:
+            generateTrendingPrices(true);
+            break;
+        case MarketScenario::TRENDING_DOWN:
+            generateTrendingPrices(false);
+            break;
+        case MarketScenario::VOLATILE:
+            generateVolatilePrices();
+            break;
+        case MarketScenario::CSV_REPLAY:
+            replayFromCSV();
+            break;
+    }
 
-                QuoteMessage quote = createQuote();
-                std::vector<uint8_t> data = serializeQuote(quote);
-                broadcastMessage(data.data(), data.size());
-            }
+    if (sequenceNumber % 3 == 0) {
 
-            sequenceNumber++;
-            lastMessageTime = now;
-        }
+        TradeMessage trade = createTrade();
+        std::vector<uint8_t> data = serializeTrade(trade);
+        broadcastMessage(data.data(), data.size());
+    } else {
 
-        std::this_thread::sleep_for(std::chrono::microseconds(1000));
+        QuoteMessage quote = createQuote();
+        std::vector<uint8_t> data = serializeQuote(quote);
+        broadcastMessage(data.data(), data.size());
     }
+
+    sequenceNumber++;
 }
 
 void MarketDataSimulator::generateSteadyPrices() {
@@ -323,7 +414,7 @@ QuoteMessage MarketDataSimulator::createQuote() {
     memset(quote.symbol, 0, sizeof(quote.symbol));
     memcpy(quote.symbol, config.symbol.c_str(),
            std::min(sizeof(quote.symbol), config.symbol.length()));
-    quote.timestamp = getCurrentTimestamp();
+    quote.timestamp = messageTimestamp();
 
     thread_local std::mt19937 gen(rngSeed.fetch_add(1));
     thread_local std::uniform_int_distribution<> qty_dis(100, 999);
@@ -341,7 +432,7 @@ TradeMessage MarketDataSimulator::createTrade() {
     memset(trade.symbol, 0, sizeof(trade.symbol));
     memcpy(trade.symbol, config.symbol.c_str(),
            std::min(sizeof(trade.symbol), config.symbol.length()));
-    trade.timestamp = getCurrentTimestamp();
+    trade.timestamp = messageTimestamp();
 
     thread_local std::mt19937 gen(rngSeed.fetch_add(1));
     thread_local std::uniform_int_distribution<> qty_dis(100, 599);
@@ -382,6 +473,14 @@ std::vector<uint8_t> MarketDataSimulator::serializeTrade(const TradeMessage& tra
 }
 
 void MarketDataSimulator::broadcastMessage(const uint8_t* data, size_t size) {
+    if (ringWriter) {
+        ringWriter->publish(data, size);
+        return;
+    }
+    if (!config.udpTarget.empty()) {
+        sendDatagramFrame(data, size);
+        return;
+    }
 
     std::vector<int> socketsCopy;
     {
@@ -421,6 +520,12 @@ uint64_t MarketDataSimulator::getCurrentTimestamp() {
     return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
 }
 
+uint64_t MarketDataSimulator::messageTimestamp() {
+    if (config.seed == 0) return getCurrentTimestamp();
+    const uint64_t intervalNanos = 1000000000ULL / std::max(1, std::min(10000, config.messagesPerSecond));
+    return 1000000000000ULL + sequenceNumber * intervalNanos;
+}
+
 void MarketDataSimulator::cleanup() {
     std::lock_guard<std::mutex> lock(clientSocketsMutex);
     for (int sock : clientSockets) {
@@ -428,10 +533,18 @@ void MarketDataSimulator::cleanup() {
     }
     clientSockets.clear();
 
+    flushDatagram();
+    if (datagramSendFailures) {
+        std::cerr << "UDP: " << datagramSendFailures << " of " << datagramsSent
+                  << " datagrams failed to send (last error: " << strerror(lastSendError) << ")" << std::endl;
+        datagramSendFailures = 0;
+    }
+
     if (serverSocket >= 0) {
         close(serverSocket);
         serverSocket = -1;
     }
+    if (ringWriter) ringWriter->close();
 }
 
 SimulatorConfig parseCommandLine(int argc, char* argv[]) {
@@ -482,6 +595,22 @@ SimulatorConfig parseCommandLine(int argc, char* argv[]) {
             if (++i < argc) {
                 config.replaySpeed = std::stod(argv[i]);
             }
+        } else if (arg == "--udp") {
+            if (++i < argc) {
+                config.udpTarget = argv[i];
+            }
+        } else if (arg == "--udp-frames") {
+            if (++i < argc) {
+                config.udpFramesPerDatagram = std::max(1, std::stoi(argv[i]));
+            }
+        } else if (arg == "--shm") {
+            if (++i < argc) {
+                config.shmName = argv[i];
+            }
+        } else if (arg == "--seed") {
+            if (++i < argc) {
+                config.seed = std::stoull(argv[i]);
+            }
         } else if (arg == "-v" || arg == "--verbose") {
             config.verbose = true;
         } else if (arg == "-h" || arg == "--help") {
@@ -505,6 +634,10 @@ void printUsage(const char* programName) {
               << "  --duration SECONDS      Run duration, 0 for infinite (default: 60)\n"
               << "  --csv FILE              CSV file for replay\n"
               << "  --replay-speed SPEED    CSV replay speed multiplier (default: 1.0)\n"
+              << "  --seed N                Reproducible stream; same seed and options give identical feeds\n"
+              << "  --udp HOST:PORT         Send UDP datagrams to HOST:PORT instead of serving TCP\n"
+              << "  --udp-frames N          Up to N frames per UDP datagram, sent each tick (default: 1)\n"
+              << "  --shm NAME              Publish to the shared memory ring /dev/shm/NAME instead of serving TCP\n"
               << "  -v, --verbose           Verbose output\n"
               << "  -h, --help              Show this help\n";
 }
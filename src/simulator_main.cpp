@@ -62,7 +62,13 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    std::cout << "Simulator is running. Waiting for connections..." << std::endl;
+    if (!config.shmName.empty()) {
+        std::cout << "Simulator is running. Publishing to " << ShmRing::path(config.shmName) << std::endl;
+    } else if (config.udpTarget.empty()) {
+        std::cout << "Simulator is running. Waiting for connections..." << std::endl;
+    } else {
+        std::cout << "Simulator is running. Sending UDP to " << config.udpTarget << std::endl;
+    }
 
     while (!shouldExit.load() && simulator.isRunning()) {
         usleep(100000);
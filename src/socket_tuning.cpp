@@ -0,0 +1,130 @@
+#include "socket_tuning.h"
+#include "wire_format.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/tcp.h>
+
+namespace {
+bool setOption(int fd, int level, int option, int value) noexcept {
+    return setsockopt(fd, level, option, &value, sizeof(value)) == 0;
+}
+
+int readOption(int fd, int level, int option) noexcept {
+    int value = 0;
+    socklen_t length = sizeof(value);
+    return getsockopt(fd, level, option, &value, &length) == 0 ? value : SocketTuning::UNSET;
+}
+
+bool parseInt(const std::string& text, int& value) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    long parsed = std::strtol(text.c_str(), &end, 0);
+    if (*end != '\0' || parsed < -1 || parsed > (1L << 30)) return false;
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+void printField(const char* field, int requested, int applied) {
+    if (requested == SocketTuning::UNSET) return;
+    std::cout << " " << field << "=";
+    if (applied == SocketTuning::UNSET) std::cout << "refused";
+    else std::cout << applied;
+    if (applied != requested) std::cout << "(asked " << requested << ")";
+}
+}
+
+SocketTuning SocketTuning::standard() {
+    return SocketTuning{"standard", 65536, 4096, false, UNSET, UNSET, UNSET, UNSET};
+}
+
+SocketTuning SocketTuning::latency() {
+    return SocketTuning{"latency", 65536, 65536, true, 1, 50, IPTOS_LOWDELAY, UNSET};
+}
+
+SocketTuning SocketTuning::throughput() {
+    // Nothing smaller than a trade frame can be parsed, so waking for less
+    // only costs a wasted read.
+    const int smallestFrame = static_cast<int>(WireFormat::HEADER_SIZE + WireFormat::TRADE_SIZE);
+    return SocketTuning{"throughput", 4 << 20, 1 << 20, false, smallestFrame, UNSET, IPTOS_THROUGHPUT, UNSET};
+}
+
+bool SocketTuning::parse(const std::string& spec, SocketTuning& out) {
+    size_t comma = spec.find(',');
+    const std::string base = spec.substr(0, comma);
+    SocketTuning tuning;
+    if (base == "standard") tuning = standard();
+    else if (base == "latency") tuning = latency();
+    else if (base == "throughput") tuning = throughput();
+    else return false;
+
+    while (comma != std::string::npos) {
+        size_t start = comma + 1;
+        comma = spec.find(',', start);
+        const std::string item = spec.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        size_t equals = item.find('=');
+        if (equals == std::string::npos) return false;
+        const std::string key = item.substr(0, equals);
+        int value;
+        if (!parseInt(item.substr(equals + 1), value)) return false;
+        if (key == "rcvbuf") tuning.receiveBuffer = value;
+        else if (key == "sndbuf") tuning.sendBuffer = value;
+        else if (key == "quickack") tuning.quickAck = value > 0;
+        else if (key == "lowat") tuning.receiveLowWater = value;
+        else if (key == "busypoll") tuning.busyPollMicros = value;
+        else if (key == "tos") tuning.typeOfService = value;
+        else if (key == "cpu") tuning.incomingCpu = value;
+        else return false;
+    }
+    tuning.name = spec;
+    out = tuning;
+    return true;
+}
+
+bool SocketTuning::apply(int fd, Applied& applied) const noexcept {
+    applied = Applied();
+    bool ok = true;
+    if (receiveBuffer != UNSET) {
+        ok = setOption(fd, SOL_SOCKET, SO_RCVBUF, receiveBuffer) && ok;
+        applied.receiveBuffer = readOption(fd, SOL_SOCKET, SO_RCVBUF);
+    }
+    if (sendBuffer != UNSET) {
+        ok = setOption(fd, SOL_SOCKET, SO_SNDBUF, sendBuffer) && ok;
+        applied.sendBuffer = readOption(fd, SOL_SOCKET, SO_SNDBUF);
+    }
+    if (quickAck && setOption(fd, IPPROTO_TCP, TCP_QUICKACK, 1)) {
+        applied.quickAck = readOption(fd, IPPROTO_TCP, TCP_QUICKACK);
+    }
+    if (receiveLowWater != UNSET && setOption(fd, SOL_SOCKET, SO_RCVLOWAT, receiveLowWater)) {
+        applied.receiveLowWater = readOption(fd, SOL_SOCKET, SO_RCVLOWAT);
+    }
+#if defined(SO_BUSY_POLL)
+    if (busyPollMicros != UNSET && setOption(fd, SOL_SOCKET, SO_BUSY_POLL, busyPollMicros)) {
+        applied.busyPollMicros = readOption(fd, SOL_SOCKET, SO_BUSY_POLL);
+    }
+#endif
+    if (typeOfService != UNSET && setOption(fd, IPPROTO_IP, IP_TOS, typeOfService)) {
+        applied.typeOfService = readOption(fd, IPPROTO_IP, IP_TOS);
+    }
+#if defined(SO_INCOMING_CPU)
+    if (incomingCpu != UNSET && setOption(fd, SOL_SOCKET, SO_INCOMING_CPU, incomingCpu)) {
+        applied.incomingCpu = readOption(fd, SOL_SOCKET, SO_INCOMING_CPU);
+    }
+#endif
+    return ok;
+}
+
+void SocketTuning::print(const char* label, const Applied& applied) const {
+    std::cout << label << " socket profile " << name << ":";
+    printField("rcvbuf", receiveBuffer, applied.receiveBuffer);
+    printField("sndbuf", sendBuffer, applied.sendBuffer);
+    printField("quickack", quickAck ? 1 : UNSET, applied.quickAck);
+    printField("lowat", receiveLowWater, applied.receiveLowWater);
+    printField("busypoll", busyPollMicros, applied.busyPollMicros);
+    printField("tos", typeOfService, applied.typeOfService);
+    printField("cpu", incomingCpu, applied.incomingCpu);
+    std::cout << std::endl;
+}
@@ -0,0 +1,125 @@
+#include "stats_segment.h"
+#include "shm_ring.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+// A reader retries this many times before giving up on a copy; only a
+// writer that died mid-publish keeps it failing.
+constexpr int READ_ATTEMPTS = 1000;
+}
+
+StatsSegmentWriter::StatsSegmentWriter(uint64_t interval) noexcept
+    : header(nullptr), intervalNanos(interval), lastPublish(0), startedNanos(realtimeNanos()) {
+}
+
+StatsSegmentWriter::~StatsSegmentWriter() {
+    close();
+}
+
+bool StatsSegmentWriter::create(const std::string& name) {
+    close();
+    const std::string file = ShmRing::path(name);
+    int fd = ::open(file.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to create stats segment " << file << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(sizeof(StatsSegment::Header))) < 0) {
+        std::cerr << "Failed to size stats segment " << file << ": " << strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* base = ::mmap(nullptr, sizeof(StatsSegment::Header), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "Failed to map stats segment " << file << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Readers left attached to a previous writer's segment see it close and
+    // the record sequence restart.
+    static_cast<StatsSegment::Header*>(base)->writerOpen.store(0, std::memory_order_release);
+    header = new (base) StatsSegment::Header;
+    header->magic = StatsSegment::MAGIC;
+    header->version = StatsSegment::VERSION;
+    header->recordSize = static_cast<uint32_t>(sizeof(StatsSegment::Record));
+    header->pid = static_cast<int32_t>(::getpid());
+    lastPublish = 0;
+    header->writerOpen.store(1, std::memory_order_release);
+    return true;
+}
+
+void StatsSegmentWriter::close() noexcept {
+    if (!header) return;
+    header->writerOpen.store(0, std::memory_order_release);
+    ::munmap(header, sizeof(StatsSegment::Header));
+    header = nullptr;
+}
+
+void StatsSegmentWriter::publish(const MetricsSnapshot& metrics, const RateMeter::Report& rates) noexcept {
+    if (!header) return;
+    StatsSegment::Record record;
+    record.metrics = metrics;
+    record.rates = rates;
+    record.publishedNanos = realtimeNanos();
+    record.startedNanos = startedNanos;
+    header->record.store(record);
+}
+
+StatsSegmentReader::StatsSegmentReader() noexcept : header(nullptr), mappedBytes(0) {
+}
+
+StatsSegmentReader::~StatsSegmentReader() {
+    close();
+}
+
+bool StatsSegmentReader::open(const std::string& name) {
+    close();
+    const std::string file = ShmRing::path(name);
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    uint64_t magic = 0;
+    uint32_t layout[2] = {0, 0};
+    bool valid = ::fstat(fd, &st) == 0 &&
+                 static_cast<size_t>(st.st_size) == sizeof(StatsSegment::Header) &&
+                 ::pread(fd, &magic, sizeof(magic), 0) == static_cast<ssize_t>(sizeof(magic)) &&
+                 ::pread(fd, layout, sizeof(layout), sizeof(magic)) == static_cast<ssize_t>(sizeof(layout)) &&
+                 magic == StatsSegment::MAGIC && layout[0] == StatsSegment::VERSION &&
+                 layout[1] == sizeof(StatsSegment::Record);
+    if (!valid) {
+        ::close(fd);
+        return false;
+    }
+    void* base = ::mmap(nullptr, sizeof(StatsSegment::Header), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+
+    header = static_cast<const StatsSegment::Header*>(base);
+    mappedBytes = sizeof(StatsSegment::Header);
+    return true;
+}
+
+void StatsSegmentReader::close() noexcept {
+    if (!header) return;
+    ::munmap(const_cast<StatsSegment::Header*>(header), mappedBytes);
+    header = nullptr;
+}
+
+bool StatsSegmentReader::read(StatsSegment::Record& out) const noexcept {
+    if (!header || header->record.version() == 0) return false;
+    for (int attempt = 0; attempt < READ_ATTEMPTS; ++attempt) {
+        if (header->record.tryLoad(out)) return true;
+        std::this_thread::yield();
+    }
+    return false;
+}
@@ -10,6 +10,9 @@
 #include <netinet/tcp.h>
 #include <random>
 #include "metrics.h"
+#if defined(__linux__)
+#include <linux/net_tstamp.h>
+#endif
 
 TcpClient::SocketHandle::~SocketHandle() { close(); }
 void TcpClient::SocketHandle::close() noexcept { if (fd>=0) { ::shutdown(fd, SHUT_RDWR); ::close(fd); fd=-1; } }
@@ -23,10 +26,15 @@ TcpClient::TcpClient(const std::string& host, uint16_t port)
       reconnectAttempts(0),
       lastConnectAttempt(0),
       currentBackoffMs(INITIAL_BACKOFF_MS),
+      connectStarted(),
       bytesReceived(0),
       bytesSent(0),
       messagesReceived(0),
-      messagesSent(0) {
+      messagesSent(0),
+      rxTimestamps(false),
+      rxTimestampsActive(false),
+      tuning(SocketTuning::standard()),
+      appliedTuning() {
 
     std::memset(&serverAddr, 0, sizeof(serverAddr));
 }
@@ -47,15 +55,7 @@ bool TcpClient::setSocketOptions() noexcept {
         return false;
     }
 
-    int rcvBufSize = 65536;
-    if (setsockopt(socketFd.fd, SOL_SOCKET, SO_RCVBUF,
-                   &rcvBufSize, sizeof(rcvBufSize)) < 0) {
-        return false;
-    }
-
-    int sndBufSize = 4096;
-    if (setsockopt(socketFd.fd, SOL_SOCKET, SO_SNDBUF,
-                   &sndBufSize, sizeof(sndBufSize)) < 0) {
+    if (!tuning.apply(socketFd.fd, appliedTuning)) {
         return false;
     }
 
@@ -67,9 +67,48 @@ bool TcpClient::setSocketOptions() noexcept {
     int keepAlive = 1;
     setsockopt(socketFd.fd, SOL_SOCKET, SO_KEEPALIVE, &keepAlive, sizeof(keepAlive));
 
+    if (rxTimestamps) applyRxTimestamps();
     return true;
 }
 
+bool TcpClient::setTuning(const SocketTuning& profile) noexcept {
+    tuning = profile;
+    return !socketFd || tuning.apply(socketFd.fd, appliedTuning);
+}
+
+void TcpClient::rearmQuickAck() noexcept {
+    int quickAck = 1;
+    setsockopt(socketFd.fd, IPPROTO_TCP, TCP_QUICKACK, &quickAck, sizeof(quickAck));
+}
+
+bool TcpClient::enableRxTimestamps(bool enabled) noexcept {
+    rxTimestamps = enabled;
+    if (!enabled) {
+        rxTimestampsActive = false;
+        return true;
+    }
+    return !socketFd || applyRxTimestamps();
+}
+
+bool TcpClient::applyRxTimestamps() noexcept {
+    rxTimestampsActive = false;
+#if defined(SO_TIMESTAMPNS)
+    int on = 1;
+    if (setsockopt(socketFd.fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) == 0) {
+        rxTimestampsActive = true;
+        return true;
+    }
+#endif
+#if defined(SO_TIMESTAMPING) && defined(__linux__)
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (setsockopt(socketFd.fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+        rxTimestampsActive = true;
+        return true;
+    }
+#endif
+    return false;
+}
+
 bool TcpClient::setNonBlocking() noexcept {
     int flags = fcntl(socketFd.fd, F_GETFL, 0);
     if (flags < 0) {
@@ -84,6 +123,16 @@ bool TcpClient::connect() noexcept {
     if (state == ConnectionState::CONNECTED) {
         return true;
     }
+    if (!beginConnect()) {
+        return false;
+    }
+    if (state == ConnectionState::CONNECTED) {
+        return true;
+    }
+    return connectWithTimeout(CONNECT_TIMEOUT_SEC);
+}
+
+bool TcpClient::beginConnect() noexcept {
     if (!socketFd && !createSocket()) {
         return false;
     }
@@ -97,19 +146,17 @@ bool TcpClient::connect() noexcept {
     }
 
     state = ConnectionState::CONNECTING;
+    connectStarted = std::chrono::steady_clock::now();
     int result;
     do { result = ::connect(socketFd.fd, (struct sockaddr*)&serverAddr, sizeof(serverAddr));
     } while (result < 0 && errno == EINTR);
 
     if (result == 0) {
-    state = ConnectionState::CONNECTED;
-    reconnectAttempts = 0;
-    currentBackoffMs = INITIAL_BACKOFF_MS;
-    lastError = ErrorType::NONE;
+        markConnected();
         return true;
     }
 
-    if (errno == EINPROGRESS) { return connectWithTimeout(CONNECT_TIMEOUT_SEC); }
+    if (errno == EINPROGRESS) { return true; }
     handleConnectError();
     return false;
 }
@@ -130,20 +177,7 @@ bool TcpClient::connectWithTimeout(int timeoutSec) noexcept {
         } while (result < 0 && errno == EINTR);
 
     if (result > 0) {
-        int error = 0;
-        socklen_t errorLen = sizeof(error);
-    if (getsockopt(socketFd.fd, SOL_SOCKET, SO_ERROR,
-                      &error, &errorLen) < 0 || error != 0) {
-            handleConnectError();
-            return false;
-        }
-
-    state = ConnectionState::CONNECTED;
-    reconnectAttempts = 0;
-    currentBackoffMs = INITIAL_BACKOFF_MS;
-    lastError = ErrorType::NONE;
-        std::cout << "Connected to " << host << ":" << port << std::endl;
-        return true;
+        return completeConnect();
     }
 
     lastError = ErrorType::CONNECTION_TIMEOUT;
@@ -151,6 +185,45 @@ bool TcpClient::connectWithTimeout(int timeoutSec) noexcept {
     return false;
 }
 
+bool TcpClient::completeConnect() noexcept {
+    if (state != ConnectionState::CONNECTING) {
+        return state == ConnectionState::CONNECTED;
+    }
+    int error = 0;
+    socklen_t errorLen = sizeof(error);
+    if (getsockopt(socketFd.fd, SOL_SOCKET, SO_ERROR, &error, &errorLen) < 0 || error != 0) {
+        if (error != 0) errno = error;
+        handleConnectError();
+        socketFd.reset();
+        if (reconnectAttempts > 0) calculateBackoff();
+        return false;
+    }
+    markConnected();
+    std::cout << "Connected to " << host << ":" << port << std::endl;
+    return true;
+}
+
+bool TcpClient::connectTimedOut() noexcept {
+    if (state != ConnectionState::CONNECTING) {
+        return false;
+    }
+    if (std::chrono::steady_clock::now() - connectStarted < std::chrono::seconds(int{CONNECT_TIMEOUT_SEC})) {
+        return false;
+    }
+    lastError = ErrorType::CONNECTION_TIMEOUT;
+    state = ConnectionState::ERROR_STATE;
+    socketFd.reset();
+    if (reconnectAttempts > 0) calculateBackoff();
+    return true;
+}
+
+void TcpClient::markConnected() noexcept {
+    state = ConnectionState::CONNECTED;
+    reconnectAttempts = 0;
+    currentBackoffMs = INITIAL_BACKOFF_MS;
+    lastError = ErrorType::NONE;
+}
+
 bool TcpClient::resolveAddress() noexcept {
     serverAddr.sin_family = AF_INET;
     serverAddr.sin_port = htons(port);
@@ -167,6 +240,9 @@ bool TcpClient::reconnect() noexcept {
     if (state == ConnectionState::CONNECTED) {
         return true;
     }
+    if (state == ConnectionState::CONNECTING) {
+        return false;
+    }
 
     if (reconnectAttempts >= MAX_RECONNECT_ATTEMPTS) {
         std::cerr << "Max reconnection attempts reached" << std::endl;
@@ -191,8 +267,8 @@ bool TcpClient::reconnect() noexcept {
     g_systemMetrics.cold.partialSends.fetch_add(0, std::memory_order_relaxed);
     g_systemMetrics.cold.connectionErrors.fetch_add(0, std::memory_order_relaxed);
 
-    if (connect()) {
-        return true;
+    if (beginConnect()) {
+        return state == ConnectionState::CONNECTED;
     }
 
     currentBackoffMs = calculateBackoff();
@@ -238,8 +314,35 @@ ssize_t TcpClient::send(const uint8_t* data, size_t len) noexcept {
     if (sent > 0) {
         bytesSent += sent;
         messagesSent++;
-        g_systemMetrics.hot.bytesSent.fetch_add(static_cast<uint64_t>(sent), std::memory_order_relaxed);
-        g_systemMetrics.hot.messagesSent.fetch_add(1, std::memory_order_relaxed);
+        HotCounters& hot = localHotCounters();
+        hot.bytesSent.add(static_cast<uint64_t>(sent));
+        hot.messagesSent.add(1);
+    } else if (sent < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            lastError = ErrorType::SEND_FAILED;
+            state = ConnectionState::ERROR_STATE;
+        }
+    }
+
+    return sent;
+}
+
+ssize_t TcpClient::sendv(const struct iovec* iov, size_t iovcnt) noexcept {
+    if (state != ConnectionState::CONNECTED) {
+        return -1;
+    }
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = const_cast<struct iovec*>(iov);
+    msg.msg_iovlen = iovcnt;
+    ssize_t sent = ::sendmsg(socketFd.fd, &msg, MSG_NOSIGNAL);
+
+    if (sent > 0) {
+        bytesSent += sent;
+        messagesSent++;
+        HotCounters& hot = localHotCounters();
+        hot.bytesSent.add(static_cast<uint64_t>(sent));
+        hot.messagesSent.add(1);
     } else if (sent < 0) {
         if (errno != EAGAIN && errno != EWOULDBLOCK) {
             lastError = ErrorType::SEND_FAILED;
@@ -259,7 +362,64 @@ ssize_t TcpClient::receive(uint8_t* buffer, size_t len) noexcept {
 
     if (received > 0) {
         bytesReceived += received;
-        g_systemMetrics.hot.bytesReceived.fetch_add(static_cast<uint64_t>(received), std::memory_order_relaxed);
+        // The kernel drops back to delayed ACKs after a while; keep it quick.
+        if (tuning.quickAck) rearmQuickAck();
+    } else if (received == 0) {
+        lastError = ErrorType::CONNECTION_LOST;
+        state = ConnectionState::ERROR_STATE;
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        lastError = ErrorType::RECEIVE_FAILED;
+        state = ConnectionState::ERROR_STATE;
+    }
+
+    return received;
+}
+
+ssize_t TcpClient::receiveStamped(uint8_t* buffer, size_t len, uint64_t& kernelNanos) noexcept {
+    kernelNanos = 0;
+    if (!rxTimestampsActive) {
+        return receive(buffer, len);
+    }
+    if (state != ConnectionState::CONNECTED) {
+        return -1;
+    }
+
+    struct iovec iov;
+    iov.iov_base = buffer;
+    iov.iov_len = len;
+    alignas(struct cmsghdr) char control[CMSG_SPACE(3 * sizeof(struct timespec))];
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t received = ::recvmsg(socketFd.fd, &msg, 0);
+
+    if (received > 0) {
+        bytesReceived += received;
+        // The kernel drops back to delayed ACKs after a while; keep it quick.
+        if (tuning.quickAck) rearmQuickAck();
+        for (struct cmsghdr* c = CMSG_FIRSTHDR(&msg); c != nullptr; c = CMSG_NXTHDR(&msg, c)) {
+            if (c->cmsg_level != SOL_SOCKET) continue;
+            struct timespec ts;
+#if defined(SCM_TIMESTAMPNS)
+            if (c->cmsg_type == SCM_TIMESTAMPNS) {
+                std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                kernelNanos = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+                break;
+            }
+#endif
+#if defined(SCM_TIMESTAMPING)
+            if (c->cmsg_type == SCM_TIMESTAMPING) {
+                // ts[0] is the software timestamp; ts[2] the hardware one.
+                std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                kernelNanos = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+                break;
+            }
+#endif
+        }
     } else if (received == 0) {
         lastError = ErrorType::CONNECTION_LOST;
         state = ConnectionState::ERROR_STATE;
@@ -0,0 +1,187 @@
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <new>
+
+Tracer g_tracer;
+
+thread_local TraceRing* Tracer::tlsRing = nullptr;
+thread_local uint64_t Tracer::tlsOwner = 0;
+std::atomic<uint64_t> Tracer::nextInstance{0};
+
+namespace {
+// How often the flusher wakes, and how often a streaming trace refreshes its
+// header so a trace cut short by a crash still decodes.
+constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(1);
+constexpr uint64_t HEADER_INTERVAL_NANOS = 1'000'000'000ULL;
+}
+
+const char* traceStageName(TraceStage stage) noexcept {
+    switch (stage) {
+        case TraceStage::RECV:        return "recv";
+        case TraceStage::FRAME:       return "frame";
+        case TraceStage::PARSE:       return "parse";
+        case TraceStage::VWAP_UPDATE: return "vwap_update";
+        case TraceStage::DECISION:    return "decision";
+        case TraceStage::ORDER_SEND:  return "order_send";
+        default:                      return "unknown";
+    }
+}
+
+uint64_t TraceRing::drain(std::vector<TraceRecord>& out, uint8_t thread) noexcept {
+    const uint64_t end = head.load(std::memory_order_acquire);
+    uint64_t begin = end > CAPACITY && end - CAPACITY > tail ? end - CAPACITY : tail;
+    const size_t first = out.size();
+    for (uint64_t i = begin; i < end; ++i) {
+        const Slot& slot = slots[i & MASK];
+        TraceRecord rec;
+        rec.ticks = slot.ticks.load(std::memory_order_relaxed);
+        rec.messageTs = slot.messageTs.load(std::memory_order_relaxed);
+        const uint64_t meta = slot.meta.load(std::memory_order_relaxed);
+        rec.stage = static_cast<uint8_t>(meta);
+        rec.arg = static_cast<uint32_t>(meta >> 32);
+        rec.thread = thread;
+        rec._reserved = 0;
+        out.push_back(rec);
+    }
+
+    // Slots the writer started rewriting while we copied may be torn.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t rewritten = claimed.load(std::memory_order_relaxed);
+    if (rewritten > CAPACITY && rewritten - CAPACITY > begin) {
+        const uint64_t stale = std::min(rewritten - CAPACITY, end) - begin;
+        out.erase(out.begin() + static_cast<std::ptrdiff_t>(first),
+                  out.begin() + static_cast<std::ptrdiff_t>(first + stale));
+        begin += stale;
+    }
+
+    const uint64_t dropped = begin - tail;
+    tail = end;
+    return dropped;
+}
+
+Tracer::~Tracer() {
+    stop();
+    for (TraceRing* r : rings) delete r;
+}
+
+TraceRing* Tracer::registerThread() noexcept {
+    const std::thread::id self = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    // A thread coming back from another tracer keeps the ring it had here.
+    TraceRing* r = nullptr;
+    for (size_t i = 0; i < rings.size(); ++i) {
+        if (ringThreads[i] == self) {
+            r = rings[i];
+            break;
+        }
+    }
+    if (!r) {
+        if (rings.size() >= MAX_THREADS) return nullptr;
+        r = new (std::nothrow) TraceRing();
+        if (!r) return nullptr;
+        rings.push_back(r);
+        ringThreads.push_back(self);
+    }
+    tlsRing = r;
+    tlsOwner = instance;
+    return r;
+}
+
+bool Tracer::start(const char* path, Mode traceMode) {
+    if (active.load() || !path) return false;
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    out = f;
+    mode = traceMode;
+
+    // Records left from an earlier run are not part of this trace.
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (TraceRing* r : rings) {
+            scratch.clear();
+            r->drain(scratch, 0);
+        }
+    }
+    scratch.clear();
+    scratch.reserve(TraceRing::CAPACITY);
+
+    header = TraceFile::Header{};
+    header.magic = TraceFile::MAGIC;
+    header.version = TraceFile::VERSION;
+    header.recordSize = static_cast<uint32_t>(sizeof(TraceRecord));
+    header.startTicks = AsyncLogger::nowTicks();
+    header.startNanos = AsyncLogger::nowNanos();
+    written.store(0, std::memory_order_relaxed);
+    lost.store(0, std::memory_order_relaxed);
+    writeHeader();
+
+    stopRequested.store(false);
+    dumpRequested.store(false);
+    active.store(true, std::memory_order_release);
+    flusher = std::thread(&Tracer::run, this);
+    return true;
+}
+
+void Tracer::stop() noexcept {
+    if (!active.exchange(false)) return;
+    stopRequested.store(true, std::memory_order_release);
+    if (flusher.joinable()) flusher.join();
+    flushOnce(mode == Mode::STREAM);
+    writeHeader();
+    std::fclose(out);
+    out = nullptr;
+}
+
+void Tracer::writeHeader() noexcept {
+    header.endTicks = AsyncLogger::nowTicks();
+    header.endNanos = AsyncLogger::nowNanos();
+    header.records = written.load(std::memory_order_relaxed);
+    header.lost = lost.load(std::memory_order_relaxed);
+    std::fflush(out);
+    std::fseek(out, 0, SEEK_SET);
+    std::fwrite(&header, sizeof(header), 1, out);
+    std::fseek(out, 0, SEEK_END);
+    std::fflush(out);
+}
+
+size_t Tracer::flushOnce(bool countLost) noexcept {
+    std::vector<TraceRing*> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        snapshot = rings;
+    }
+    size_t flushed = 0;
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        scratch.clear();
+        const uint64_t dropped = snapshot[i]->drain(scratch, static_cast<uint8_t>(i));
+        if (dropped && countLost) lost.fetch_add(dropped, std::memory_order_relaxed);
+        if (scratch.empty()) continue;
+        std::fwrite(scratch.data(), sizeof(TraceRecord), scratch.size(), out);
+        written.fetch_add(scratch.size(), std::memory_order_relaxed);
+        flushed += scratch.size();
+    }
+    return flushed;
+}
+
+void Tracer::run() noexcept {
+    uint64_t lastHeader = AsyncLogger::nowNanos();
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        if (mode == Mode::SIGNAL) {
+            if (dumpRequested.exchange(false, std::memory_order_relaxed)) {
+                // Only the most recent records are wanted; older ones were
+                // overwritten by design, not lost.
+                flushOnce(false);
+                writeHeader();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        if (flushOnce(true) == 0) std::this_thread::sleep_for(FLUSH_INTERVAL);
+        const uint64_t now = AsyncLogger::nowNanos();
+        if (now - lastHeader >= HEADER_INTERVAL_NANOS) {
+            writeHeader();
+            lastHeader = now;
+        }
+    }
+}
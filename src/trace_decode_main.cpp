@@ -0,0 +1,112 @@
+#include "trace_decoder.h"
+#include "message.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Decodes a trace written by a TRACE=1 build of the trader: a per-stage
+// latency table, the slowest messages with their stage breakdown, and
+// optionally Chrome trace-event JSON for chrome://tracing or Perfetto.
+
+namespace {
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " <trace file> [--chrome out.json] [--slowest N]" << std::endl;
+    std::cerr << "  --chrome file  Write Chrome trace-event JSON" << std::endl;
+    std::cerr << "  --slowest N    List the N slowest messages (default 10)" << std::endl;
+}
+
+void printSlowest(const TraceDecoder& decoder, size_t count) {
+    std::vector<const TraceDecoder::Message*> slowest;
+    for (const TraceDecoder::Message& m : decoder.messages()) slowest.push_back(&m);
+    count = std::min(count, slowest.size());
+    if (count == 0) return;
+    std::partial_sort(slowest.begin(), slowest.begin() + static_cast<std::ptrdiff_t>(count), slowest.end(),
+                      [](const TraceDecoder::Message* a, const TraceDecoder::Message* b) {
+                          return a->totalNanos() > b->totalNanos();
+                      });
+
+    std::printf("\nSlowest %zu messages (ns, - where the stage was not traced):\n", count);
+    std::printf("%20s %6s %3s", "timestamp", "type", "thr");
+    for (const TraceDecoder::Span& span : TraceDecoder::SPAN_LIST) std::printf(" %12s", span.column);
+    std::printf(" %12s\n", "total");
+    for (size_t i = 0; i < count; ++i) {
+        const TraceDecoder::Message& m = *slowest[i];
+        const char* type = m.type == MessageHeader::QUOTE_TYPE ? (m.ordered ? "order" : "quote")
+                         : m.type == MessageHeader::TRADE_TYPE ? "trade" : "other";
+        std::printf("%20llu %6s %3u", (unsigned long long)m.messageTs, type, unsigned(m.thread));
+        for (const TraceDecoder::Span& span : TraceDecoder::SPAN_LIST) {
+            const int64_t nanos = TraceDecoder::spanNanos(m, span);
+            if (nanos < 0) std::printf(" %12s", "-");
+            else std::printf(" %12lld", (long long)nanos);
+        }
+        std::printf(" %12llu\n", (unsigned long long)m.totalNanos());
+    }
+}
+}
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    std::string chromePath;
+    long slowest = 10;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--chrome") == 0 && hasValue) {
+            chromePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--slowest") == 0 && hasValue) {
+            slowest = std::strtol(argv[++i], nullptr, 10);
+        } else if (argv[i][0] != '-' && path.empty()) {
+            path = argv[i];
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (path.empty() || slowest < 0) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    TraceDecoder decoder;
+    std::string error;
+    if (!decoder.load(path, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    const TraceFile::Header& h = decoder.header();
+    size_t quotes = 0, trades = 0, orders = 0;
+    for (const TraceDecoder::Message& m : decoder.messages()) {
+        if (m.type == MessageHeader::QUOTE_TYPE) ++quotes;
+        if (m.type == MessageHeader::TRADE_TYPE) ++trades;
+        if (m.ordered) ++orders;
+    }
+    std::printf("Trace %s: %zu records from %zu threads over %.3f s, %llu lost to overwrite\n",
+                path.c_str(), decoder.records(), decoder.threads(),
+                static_cast<double>(h.endNanos - h.startNanos) / 1e9, (unsigned long long)h.lost);
+    std::printf("Messages: %zu (%zu quotes, %zu trades), %zu orders, %zu unmatched stage records\n",
+                decoder.messages().size(), quotes, trades, orders, decoder.unmatched());
+
+    std::printf("\n%-24s %10s %10s %10s %10s %10s %10s\n", "Stage latency (ns)", "count", "p50", "p90", "p99",
+                "p99.9", "max");
+    for (const TraceDecoder::Summary& row : decoder.summarize()) {
+        std::printf("%-24s %10zu %10llu %10llu %10llu %10llu %10llu\n", row.name.c_str(), row.count,
+                    (unsigned long long)row.p50, (unsigned long long)row.p90, (unsigned long long)row.p99,
+                    (unsigned long long)row.p999, (unsigned long long)row.max);
+    }
+    printSlowest(decoder, static_cast<size_t>(slowest));
+
+    if (!chromePath.empty()) {
+        std::ofstream out(chromePath);
+        if (!out) {
+            std::cerr << "Cannot write " << chromePath << std::endl;
+            return 1;
+        }
+        decoder.writeChrome(out);
+        std::printf("\nWrote Chrome trace to %s (open in chrome://tracing or ui.perfetto.dev)\n", chromePath.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include "trace_decoder.h"
+#include "message.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+
+const TraceDecoder::Span TraceDecoder::SPAN_LIST[TraceDecoder::SPANS] = {
+    {TraceStage::RECV,     TraceStage::FRAME,       "recv -> frame",          "recv>frame"},
+    {TraceStage::FRAME,    TraceStage::PARSE,       "frame -> parse",         "frame>parse"},
+    {TraceStage::PARSE,    TraceStage::VWAP_UPDATE, "parse -> vwap_update",   "parse>vwap"},
+    {TraceStage::PARSE,    TraceStage::DECISION,    "parse -> decision",      "parse>decide"},
+    {TraceStage::DECISION, TraceStage::ORDER_SEND,  "decision -> order_send", "decide>send"},
+};
+
+namespace {
+const char* messageTypeName(uint8_t type) noexcept {
+    if (type == MessageHeader::QUOTE_TYPE) return "quote";
+    if (type == MessageHeader::TRADE_TYPE) return "trade";
+    return "other";
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double q) noexcept {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(q * static_cast<double>(sorted.size()));
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Microseconds since the start of the trace, as Chrome expects.
+void writeMicros(std::ostream& out, uint64_t nanos, uint64_t origin) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(nanos - origin) / 1000.0);
+    out << buffer;
+}
+}
+
+uint64_t TraceDecoder::Message::totalNanos() const noexcept {
+    uint64_t first = 0, last = 0;
+    for (uint64_t t : stageNanos) {
+        if (t == 0) continue;
+        if (first == 0 || t < first) first = t;
+        last = std::max(last, t);
+    }
+    return last - first;
+}
+
+TraceDecoder::TraceDecoder() noexcept
+    : fileHeader{}, recordCount(0), threadCount(0), unmatchedCount(0) {
+}
+
+bool TraceDecoder::load(const std::string& path, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    TraceFile::Header header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != TraceFile::MAGIC) {
+        error = path + " is not a trace file";
+        return false;
+    }
+    if (header.version != TraceFile::VERSION || header.recordSize != sizeof(TraceRecord)) {
+        error = path + " has unsupported trace version " + std::to_string(header.version);
+        return false;
+    }
+
+    // A trace cut short may end mid-record; the partial one is dropped.
+    std::vector<TraceRecord> records;
+    TraceRecord rec;
+    while (in.read(reinterpret_cast<char*>(&rec), sizeof(rec))) records.push_back(rec);
+    decode(header, records);
+    return true;
+}
+
+uint64_t TraceDecoder::toNanos(uint64_t ticks) const noexcept {
+    const TraceFile::Header& h = fileHeader;
+    if (h.endTicks <= h.startTicks || h.endNanos <= h.startNanos) return h.startNanos + (ticks - h.startTicks);
+    const double nsPerTick = static_cast<double>(h.endNanos - h.startNanos) / static_cast<double>(h.endTicks - h.startTicks);
+    const double offset = (static_cast<double>(ticks) - static_cast<double>(h.startTicks)) * nsPerTick;
+    return h.startNanos + static_cast<uint64_t>(std::max(offset, 0.0));
+}
+
+void TraceDecoder::decode(const TraceFile::Header& header, const std::vector<TraceRecord>& records) {
+    fileHeader = header;
+    decoded.clear();
+    recordCount = records.size();
+    threadCount = 0;
+    unmatchedCount = 0;
+
+    struct ThreadState {
+        uint64_t recv = 0;
+        uint64_t frame = 0;
+    };
+    ThreadState threadStates[256];
+    bool seen[256] = {};
+    std::unordered_map<uint64_t, size_t> open;
+
+    for (const TraceRecord& rec : records) {
+        if (!seen[rec.thread]) {
+            seen[rec.thread] = true;
+            ++threadCount;
+        }
+        ThreadState& state = threadStates[rec.thread];
+        const uint64_t nanos = std::max<uint64_t>(toNanos(rec.ticks), 1);
+        const TraceStage stage = static_cast<TraceStage>(rec.stage);
+
+        switch (stage) {
+            case TraceStage::RECV:
+                state.recv = nanos;
+                state.frame = 0;
+                break;
+            case TraceStage::FRAME:
+                state.frame = nanos;
+                break;
+            case TraceStage::PARSE: {
+                Message m{};
+                m.messageTs = rec.messageTs;
+                m.thread = rec.thread;
+                m.type = static_cast<uint8_t>(rec.arg);
+                m.stageNanos[static_cast<size_t>(TraceStage::RECV)] = state.recv;
+                m.stageNanos[static_cast<size_t>(TraceStage::FRAME)] = state.frame;
+                m.stageNanos[static_cast<size_t>(TraceStage::PARSE)] = nanos;
+                state.frame = 0;
+                open[rec.messageTs] = decoded.size();
+                decoded.push_back(m);
+                break;
+            }
+            case TraceStage::VWAP_UPDATE:
+            case TraceStage::DECISION:
+            case TraceStage::ORDER_SEND: {
+                auto it = open.find(rec.messageTs);
+                if (it == open.end()) {
+                    ++unmatchedCount;
+                    break;
+                }
+                Message& m = decoded[it->second];
+                uint64_t& slot = m.stageNanos[rec.stage];
+                if (slot == 0) slot = nanos;
+                if (stage == TraceStage::DECISION && rec.arg) m.ordered = true;
+                break;
+            }
+            default:
+                ++unmatchedCount;
+                break;
+        }
+    }
+}
+
+int64_t TraceDecoder::spanNanos(const Message& message, const Span& span) noexcept {
+    if (!message.has(span.from) || !message.has(span.to)) return -1;
+    const uint64_t from = message.at(span.from), to = message.at(span.to);
+    return to >= from ? static_cast<int64_t>(to - from) : 0;
+}
+
+std::vector<TraceDecoder::Summary> TraceDecoder::summarize() const {
+    std::vector<Summary> rows;
+    std::vector<uint64_t> values;
+    auto summarizeValues = [&](const std::string& name) {
+        std::sort(values.begin(), values.end());
+        rows.push_back({name, values.size(), percentile(values, 0.50), percentile(values, 0.90),
+                        percentile(values, 0.99), percentile(values, 0.999),
+                        values.empty() ? 0 : values.back()});
+        values.clear();
+    };
+
+    for (const Span& span : SPAN_LIST) {
+        for (const Message& m : decoded) {
+            const int64_t nanos = spanNanos(m, span);
+            if (nanos >= 0) values.push_back(static_cast<uint64_t>(nanos));
+        }
+        summarizeValues(span.name);
+    }
+    for (const Message& m : decoded) values.push_back(m.totalNanos());
+    summarizeValues("total");
+    return rows;
+}
+
+void TraceDecoder::writeChrome(std::ostream& out) const {
+    const uint64_t origin = fileHeader.startNanos;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separate = [&]() {
+        if (!first) out << ",\n";
+        first = false;
+    };
+
+    bool named[256] = {};
+    for (const Message& m : decoded) {
+        if (named[m.thread]) continue;
+        named[m.thread] = true;
+        separate();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << unsigned(m.thread)
+            << ",\"args\":{\"name\":\"trace thread " << unsigned(m.thread) << "\"}}";
+    }
+
+    auto event = [&](const char* phase, const char* name, const char* category, size_t id,
+                     const Message& m, uint64_t nanos) {
+        separate();
+        out << "{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"" << phase
+            << "\",\"id\":" << id << ",\"pid\":1,\"tid\":" << unsigned(m.thread) << ",\"ts\":";
+        writeMicros(out, nanos, origin);
+        if (phase[0] == 'b') out << ",\"args\":{\"timestamp\":" << m.messageTs << "}";
+        out << "}";
+    };
+
+    for (size_t id = 0; id < decoded.size(); ++id) {
+        const Message& m = decoded[id];
+        const char* category = messageTypeName(m.type);
+        uint64_t begin = 0, end = 0;
+        for (uint64_t t : m.stageNanos) {
+            if (t == 0) continue;
+            if (begin == 0 || t < begin) begin = t;
+            end = std::max(end, t);
+        }
+        event("b", m.ordered ? "order" : category, category, id, m, begin);
+        for (const Span& span : SPAN_LIST) {
+            if (spanNanos(m, span) < 0) continue;
+            event("b", span.name, category, id, m, m.at(span.from));
+            event("e", span.name, category, id, m, std::max(m.at(span.to), m.at(span.from)));
+        }
+        event("e", m.ordered ? "order" : category, category, id, m, end);
+    }
+    out << "\n]}\n";
+}
@@ -35,35 +35,56 @@ VwapCalculator::VwapCalculator(uint32_t windowSeconds) noexcept
       rejectedTrades(0) {}
 
 void VwapCalculator::addTrade(const TradeMessage& trade) noexcept {
+    if (appendTrade(trade.timestamp, trade.quantity, trade.price)) publish();
+}
 
-    if (trade.price <= 0 || trade.quantity == 0) {
+size_t VwapCalculator::addTrades(const uint64_t* timestamps, const uint32_t* quantities,
+                                 const int32_t* prices, size_t count) noexcept {
+    size_t accepted = 0;
+    for (size_t i = 0; i < count; ++i) {
+        accepted += appendTrade(timestamps[i], quantities[i], prices[i]) ? 1 : 0;
+    }
+    if (accepted) publish();
+    return accepted;
+}
+
+void VwapCalculator::publish() noexcept {
+    VwapSnapshot s;
+    s.vwap = getCurrentVwap();
+    s.sumPriceVolume = hotData.sumPriceVolume;
+    s.sumVolume = hotData.sumVolume;
+    s.lastTradeTime = lastTradeTime;
+    s.tradeCount = static_cast<uint32_t>(tradeWindow.size());
+    s.windowComplete = hasCompleteWindow();
+    published.store(s);
+}
+
+bool VwapCalculator::appendTrade(uint64_t ts, uint32_t qty, int32_t price) noexcept {
+
+    if (price <= 0 || qty == 0) {
         ++rejectedTrades;
-        return;
+        return false;
     }
 
-    if (lastTradeTime != 0 && trade.timestamp < lastTradeTime) {
+    if (lastTradeTime != 0 && ts < lastTradeTime) {
         ++rejectedTrades;
         g_systemMetrics.cold.messagesDropped.fetch_add(1, std::memory_order_relaxed);
-        return;
+        return false;
     }
 
-    const uint64_t ts = trade.timestamp;
-    const uint32_t qty = trade.quantity;
-    const int32_t  price = trade.price;
-
 #ifdef __SIZEOF_INT128__
     unsigned __int128 pv128 =
         static_cast<unsigned __int128>(static_cast<uint64_t>(price)) *
         static_cast<unsigned __int128>(qty);
     if (pv128 > std::numeric_limits<uint64_t>::max()) {
         ++rejectedTrades;
-        return;
+        return false;
     }
     uint64_t priceVolume = static_cast<uint64_t>(pv128);
 #else
     if (wouldMultiplyOverflow(static_cast<uint64_t>(price), static_cast<uint64_t>(qty))) {
         ++rejectedTrades;
-        return;
+        return false;
     }
     uint64_t priceVolume = static_cast<uint64_t>(price) * static_cast<uint64_t>(qty);
 #endif
@@ -73,7 +94,7 @@ void VwapCalculator::addTrade(const TradeMessage& trade) noexcept {
     if (wouldAddOverflow(hotData.sumPriceVolume, priceVolume) ||
         wouldAddOverflow(hotData.sumVolume, qty)) {
         ++rejectedTrades;
-        return;
+        return false;
     }
     uint64_t newPV  = hotData.sumPriceVolume + priceVolume;
     uint64_t newVol = hotData.sumVolume + qty;
@@ -81,7 +102,7 @@ void VwapCalculator::addTrade(const TradeMessage& trade) noexcept {
     if (wouldAddOverflow(hotData.sumPriceVolume, priceVolume) ||
         wouldAddOverflow(hotData.sumVolume, qty)) {
         ++rejectedTrades;
-        return;
+        return false;
     }
     uint64_t newPV  = hotData.sumPriceVolume + priceVolume;
     uint64_t newVol = hotData.sumVolume + qty;
@@ -105,8 +126,6 @@ void VwapCalculator::addTrade(const TradeMessage& trade) noexcept {
     hotData.vwapCacheValid = false;
 
     ++totalTradesProcessed;
-
-    g_systemMetrics.hot.tradesProcessed.fetch_add(1, std::memory_order_relaxed);
     lastTradeTime = ts;
 
     removeExpiredTrades(ts);
@@ -115,6 +134,7 @@ void VwapCalculator::addTrade(const TradeMessage& trade) noexcept {
         (ts - windowStartTime) >= windowDurationNanos) {
         firstWindowComplete = true;
     }
+    return true;
 }
 
 void VwapCalculator::removeExpiredTrades(uint64_t currentTime) noexcept {
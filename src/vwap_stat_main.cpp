@@ -0,0 +1,120 @@
+#include "stats_segment.h"
+#include "shm_ring.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <signal.h>
+
+// Reads the trader's shared memory stats segment. Without -i it prints the
+// latest record once; with -i it polls and prints one line per interval with
+// rates computed from consecutive records.
+
+namespace {
+volatile sig_atomic_t g_stop = 0;
+
+void onSignal(int) { g_stop = 1; }
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [-n name] [-i interval_ms] [-c count]" << std::endl;
+    std::cerr << "  -n name         Stats segment name (default " << StatsSegment::DEFAULT_NAME << ")" << std::endl;
+    std::cerr << "  -i interval_ms  Poll and print a line every interval" << std::endl;
+    std::cerr << "  -c count        Stop after count lines" << std::endl;
+}
+
+double rate(uint64_t now, uint64_t before, double seconds) {
+    return seconds > 0 ? static_cast<double>(now - before) / seconds : 0.0;
+}
+
+void printRecord(const StatsSegmentReader& reader, const StatsSegment::Record& record) {
+    const uint64_t now = realtimeNanos();
+    std::printf("Trader pid %d (%s), up %.1f s, record %llu published %.1f ms ago\n",
+                static_cast<int>(reader.writerPid()), reader.writerOpen() ? "running" : "stopped",
+                static_cast<double>(record.publishedNanos - record.startedNanos) / 1e9,
+                (unsigned long long)reader.version(),
+                now > record.publishedNanos ? static_cast<double>(now - record.publishedNanos) / 1e6 : 0.0);
+    record.metrics.print();
+    record.rates.print();
+}
+}
+
+int main(int argc, char* argv[]) {
+    std::string name = StatsSegment::DEFAULT_NAME;
+    long intervalMs = 0;
+    long count = 0;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "-n") == 0 && hasValue) {
+            name = argv[++i];
+        } else if (std::strcmp(argv[i], "-i") == 0 && hasValue) {
+            intervalMs = std::strtol(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "-c") == 0 && hasValue) {
+            count = std::strtol(argv[++i], nullptr, 10);
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (intervalMs < 0 || count < 0) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    StatsSegmentReader reader;
+    if (!reader.open(name)) {
+        std::cerr << "No stats segment at " << ShmRing::path(name)
+                  << " (start the trader with VWAP_STATS_SHM=" << name << ")" << std::endl;
+        return 1;
+    }
+
+    StatsSegment::Record previous;
+    if (!reader.read(previous)) {
+        std::cerr << "Nothing published yet" << std::endl;
+        return 1;
+    }
+    if (intervalMs == 0) {
+        printRecord(reader, previous);
+        return 0;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    std::printf("%10s %12s %12s %10s %14s %14s %10s %8s\n",
+                "age ms", "msgs/s", "bytes/s", "orders/s", "messages", "bytes in", "orders", "drops");
+    for (long line = 0; !g_stop && (count == 0 || line < count);) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        StatsSegment::Record current;
+        if (!reader.read(current)) continue;
+        if (current.startedNanos != previous.startedNanos) {
+            std::cerr << "Trader restarted" << std::endl;
+            previous = current;
+            continue;
+        }
+        if (current.publishedNanos == previous.publishedNanos) {
+            if (!reader.writerOpen()) {
+                std::cerr << "Trader stopped" << std::endl;
+                break;
+            }
+            continue;
+        }
+        const double seconds = static_cast<double>(current.publishedNanos - previous.publishedNanos) / 1e9;
+        const MetricsSnapshot& m = current.metrics;
+        const MetricsSnapshot& p = previous.metrics;
+        const uint64_t now = realtimeNanos();
+        std::printf("%10.2f %12.1f %12.1f %10.1f %14llu %14llu %10llu %8llu\n",
+                    now > current.publishedNanos ? static_cast<double>(now - current.publishedNanos) / 1e6 : 0.0,
+                    rate(m.messagesReceived, p.messagesReceived, seconds),
+                    rate(m.bytesReceived + m.bytesSent, p.bytesReceived + p.bytesSent, seconds),
+                    rate(m.ordersPlaced, p.ordersPlaced, seconds),
+                    (unsigned long long)m.messagesReceived, (unsigned long long)m.bytesReceived,
+                    (unsigned long long)m.ordersPlaced, (unsigned long long)m.messagesDropped);
+        std::fflush(stdout);
+        previous = current;
+        ++line;
+    }
+    return 0;
+}
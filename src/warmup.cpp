@@ -0,0 +1,209 @@
+#include "warmup.h"
+#include "order_manager.h"
+#include "message_buffer.h"
+#include "message_serializer.h"
+#include "message_view.h"
+#include "symbol_filter.h"
+#include "async_logger.h"
+#include "metrics.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+// Longer than the decision engine's order cooldown, so every favourable
+// quote produces an order.
+constexpr uint64_t MIN_TICK_NANOS = 200'000'000ULL;
+constexpr uint64_t START_NANOS = 1'000'000'000'000ULL;
+constexpr int32_t BASE_PRICE = 10000;
+
+volatile uint8_t g_orderSink;
+
+inline uint64_t steadyNow() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+class Pipeline {
+private:
+    OrderManager manager;
+    MessageBuffer buffer;
+    SymbolFilter subscriptions;
+    char symbol[8];
+    char side;
+    uint64_t tickNanos;
+    uint64_t clock;
+    uint64_t ticks;
+
+    void frameTrade(uint8_t*& out, int32_t price, uint32_t quantity) {
+        TradeMessage trade;
+        std::memcpy(trade.symbol, symbol, sizeof(trade.symbol));
+        trade.timestamp = clock;
+        trade.quantity = quantity;
+        trade.price = price;
+        out += MessageSerializer::serializeTradeMessage(out, WireFormat::MAX_MESSAGE_SIZE, trade);
+    }
+
+    void frameQuote(uint8_t*& out, bool favourable) {
+        QuoteMessage quote;
+        std::memcpy(quote.symbol, symbol, sizeof(quote.symbol));
+        quote.timestamp = clock;
+        quote.bidQuantity = 300;
+        quote.askQuantity = 300;
+        int32_t bid = BASE_PRICE - 20, ask = BASE_PRICE + 20;
+        if (favourable && side == 'B') { bid = BASE_PRICE - 20; ask = BASE_PRICE - 10; }
+        if (favourable && side == 'S') { bid = BASE_PRICE + 10; ask = BASE_PRICE + 20; }
+        quote.bidPrice = static_cast<uint32_t>(bid);
+        quote.askPrice = ask;
+        out += MessageSerializer::serializeQuoteMessage(out, WireFormat::MAX_MESSAGE_SIZE, quote);
+    }
+
+public:
+    uint64_t quotes = 0;
+    uint64_t trades = 0;
+    uint64_t orders = 0;
+
+    Pipeline(const std::string& sym, char orderSide, uint32_t maxOrderSize, uint32_t windowSeconds)
+        : manager(sym, orderSide, maxOrderSize, windowSeconds, false),
+          side(orderSide), clock(START_NANOS), ticks(0) {
+        std::memset(symbol, 0, sizeof(symbol));
+        std::memcpy(symbol, sym.data(), std::min(sym.size(), sizeof(symbol)));
+        subscriptions.add(sym.data(), sym.size());
+        tickNanos = std::max<uint64_t>(static_cast<uint64_t>(windowSeconds) * 1'000'000'000ULL / Warmup::TICKS_PER_ROUND,
+                             MIN_TICK_NANOS);
+        buffer.prefault();
+    }
+
+    // Frames two trades, a quote that does not trade and one that does,
+    // then drains them as the market data client would. Returns the
+    // parse-to-serialized-order latency of the tick's order, or 0 when the
+    // window is not complete yet.
+    uint64_t tick() {
+        uint8_t frames[4 * WireFormat::MAX_MESSAGE_SIZE];
+        uint8_t* out = frames;
+        const int32_t drift = static_cast<int32_t>(ticks % 7) - 3;
+        frameTrade(out, BASE_PRICE + drift, 100 + static_cast<uint32_t>(ticks % 5) * 50);
+        frameTrade(out, BASE_PRICE - drift, 200);
+        frameQuote(out, false);
+        frameQuote(out, true);
+        buffer.append(frames, static_cast<size_t>(out - frames));
+        clock += tickNanos;
+        ++ticks;
+
+        uint64_t orderLatency = 0;
+        while (true) {
+            const uint64_t start = steadyNow();
+            MessageHeader header;
+            const uint8_t* body;
+            size_t contiguous;
+            if (buffer.peekMessage(header, body, contiguous) != MessageBuffer::ExtractResult::SUCCESS) break;
+            if (!subscriptions.accepts(SymbolFilter::load(body))) {
+                buffer.consume(header);
+                continue;
+            }
+            if (header.type == MessageHeader::TRADE_TYPE) {
+                TradeView trade(body);
+                if (trade.valid()) {
+                    ++trades;
+                    manager.processTrade(trade.toMessage());
+                }
+            } else if (header.type == MessageHeader::QUOTE_TYPE) {
+                QuoteView quote(body);
+                if (quote.valid()) {
+                    ++quotes;
+                    Optional<OrderMessage> order = manager.processQuote(quote);
+                    if (order.has_value()) {
+                        const OrderMessage& o = order.value();
+                        const uint8_t* wire = manager.getOrderTemplate().patch(o.timestamp, o.quantity, o.price);
+                        g_orderSink = wire[OrderTemplate::size() - 1];
+                        ++orders;
+                    }
+                    if (order.has_value() && orderLatency == 0) orderLatency = steadyNow() - start;
+                }
+            }
+            buffer.consume(header);
+        }
+        // Every frame was consumed; rewinding keeps bodies contiguous.
+        buffer.clear();
+        return orderLatency;
+    }
+};
+
+uint64_t median(std::vector<uint64_t>& values) {
+    if (values.empty()) return 0;
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+}
+
+Warmup::Report Warmup::run(const std::string& symbol, char side, uint32_t maxOrderSize, uint32_t windowSeconds) {
+    Report report;
+    FILE* devNull = std::fopen("/dev/null", "w");
+    const bool borrowedLogger = devNull && g_asyncLogger.start(devNull);
+    const uint64_t start = steadyNow();
+    std::vector<uint64_t> latencies;
+    latencies.reserve(TICKS_PER_ROUND);
+
+    {
+        Pipeline pipeline(symbol, side, maxOrderSize, windowSeconds);
+        uint64_t previous = 0;
+        size_t stableRounds = 0;
+        for (size_t round = 0; round < MAX_ROUNDS; ++round) {
+            latencies.clear();
+            for (size_t t = 0; t < TICKS_PER_ROUND; ++t) {
+                uint64_t orderLatency = pipeline.tick();
+                if (orderLatency == 0) continue;
+                if (report.coldFirstOrderNanos == 0) report.coldFirstOrderNanos = orderLatency;
+                latencies.push_back(orderLatency);
+            }
+            const uint64_t current = median(latencies);
+            if (report.firstRoundMedianNanos == 0) report.firstRoundMedianNanos = current;
+            report.lastRoundMedianNanos = current;
+            report.rounds = round + 1;
+
+            const uint64_t change = current > previous ? current - previous : previous - current;
+            stableRounds = previous && change <= static_cast<uint64_t>(STABLE_TOLERANCE * previous) ? stableRounds + 1 : 0;
+            previous = current;
+            if (report.rounds >= MIN_ROUNDS && stableRounds >= 2) {
+                report.stable = true;
+                break;
+            }
+        }
+        report.quotes += pipeline.quotes;
+        report.trades += pipeline.trades;
+        report.orders += pipeline.orders;
+    }
+
+    // The first order of a fresh manager, as the live one will be once its
+    // window completes, now on warm code paths.
+    {
+        Pipeline fresh(symbol, side, maxOrderSize, windowSeconds);
+        for (size_t t = 0; t < MAX_ROUNDS * TICKS_PER_ROUND && report.warmFirstOrderNanos == 0; ++t) {
+            report.warmFirstOrderNanos = fresh.tick();
+        }
+        report.quotes += fresh.quotes;
+        report.trades += fresh.trades;
+        report.orders += fresh.orders;
+    }
+
+    report.elapsedNanos = steadyNow() - start;
+    if (borrowedLogger) g_asyncLogger.stop();
+    if (devNull) std::fclose(devNull);
+    g_systemMetrics.reset();
+    return report;
+}
+
+void Warmup::Report::print() const {
+    std::cout << "\n=== Warmup ===" << std::endl;
+    std::cout << "Rounds: " << rounds << (stable ? " (stable)" : " (limit reached)")
+              << " | Quotes: " << quotes << " | Trades: " << trades << " | Orders: " << orders
+              << " | Cost: " << std::fixed << std::setprecision(1) << (elapsedNanos / 1e6) << " ms" << std::endl;
+    std::cout << "Order path median: first round " << firstRoundMedianNanos
+              << " ns, last round " << lastRoundMedianNanos << " ns" << std::endl;
+    std::cout << "First order latency: cold " << coldFirstOrderNanos
+              << " ns, warm " << warmFirstOrderNanos << " ns" << std::endl;
+}
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include "async_logger.h"
+
+struct AsyncLoggerTest {
+    static int testsRun;
+    static int testsPassed;
+
+    static void assertTrue(bool cond, const char* name) {
+        ++testsRun;
+        if (cond) { ++testsPassed; }
+        else { std::cerr << "[FAIL] " << name << std::endl; }
+    }
+
+    template<typename... Args>
+    static std::string render(LogFmt fmt, Args... args) {
+        LogRecord rec{};
+        rec.fmt = static_cast<uint16_t>(fmt);
+        rec.argc = sizeof...(Args);
+        const uint64_t packed[sizeof...(Args) + 1] = { LogArg::encode(args)..., 0 };
+        std::memcpy(rec.args, packed, sizeof...(Args) * sizeof(uint64_t));
+        char buf[256];
+        AsyncLogger::format(rec, buf, sizeof(buf));
+        return buf;
+    }
+
+    static void testFormatting() {
+        std::string line = render(LogFmt::MAIN_ORDER_SENT, 'B', uint32_t(80), LogSymbol("IBM\0\0\0\0\0"), 13900.0, uint64_t(3));
+        assertTrue(line == "[ORDER SENT] BUY 80 IBM @ $139.00 (Order #3)", "order line formatted from raw args");
+        line = render(LogFmt::DECISION_ORDER, 'S', uint32_t(5), 14050.0, 14000.0, "Sell: Bid > VWAP");
+        assertTrue(line == "[ORDER] SELL 5 @ $140.50 (VWAP: $140.00) Reason: Sell: Bid > VWAP", "decision line formatted");
+    }
+
+    static size_t countLines(FILE* f) {
+        std::rewind(f);
+        size_t lines = 0; int ch;
+        while ((ch = std::fgetc(f)) != EOF) if (ch == '\n') ++lines;
+        return lines;
+    }
+
+    static void testBackgroundDrain() {
+        FILE* sink = std::tmpfile();
+        if (!sink) { assertTrue(false, "tmpfile available"); return; }
+        AsyncLogger logger;
+        assertTrue(logger.start(sink), "logger starts");
+
+        const uint64_t PER_THREAD = 2000;
+        auto produce = [&logger, PER_THREAD] {
+            for (uint64_t i = 0; i < PER_THREAD; ++i) {
+                logger.log(LogLevel::INFO, LogFmt::MANAGER_VWAP_UPDATE, 14000.0, i);
+                if ((i & 511) == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        };
+        std::thread other(produce);
+        produce();
+        other.join();
+        logger.stop();
+
+        uint64_t dropped = logger.droppedRecords();
+        assertTrue(countLines(sink) + dropped == 2 * PER_THREAD, "every record written or counted as dropped");
+        assertTrue(logger.writtenRecords() > 0, "background thread wrote records");
+        std::fclose(sink);
+    }
+
+    static void testSwitchingLoggers() {
+        FILE* firstSink = std::tmpfile();
+        FILE* secondSink = std::tmpfile();
+        if (!firstSink || !secondSink) { assertTrue(false, "tmpfile available"); return; }
+        {
+            AsyncLogger first, second;
+            first.start(firstSink);
+            second.start(secondSink);
+            for (uint64_t i = 0; i < 10; ++i) {
+                first.log(LogLevel::INFO, LogFmt::MANAGER_VWAP_UPDATE, 14000.0, i);
+                second.log(LogLevel::INFO, LogFmt::MANAGER_VWAP_UPDATE, 14000.0, i);
+            }
+            first.stop();
+            second.stop();
+        }
+        assertTrue(countLines(firstSink) == 10 && countLines(secondSink) == 10,
+                   "one thread alternating between loggers reaches both");
+
+        // Likely built where the loggers above stood; must not reuse their rings.
+        AsyncLogger later;
+        later.start(firstSink);
+        later.log(LogLevel::INFO, LogFmt::MANAGER_VWAP_UPDATE, 14000.0, uint64_t(1));
+        later.stop();
+        assertTrue(later.writtenRecords() == 1, "a new logger gets fresh rings");
+        std::fclose(firstSink);
+        std::fclose(secondSink);
+    }
+
+    static void testHotPathCost() {
+        FILE* sink = std::tmpfile();
+        if (!sink) return;
+        AsyncLogger logger;
+        logger.start(sink);
+        const int N = 2000;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < N; ++i) {
+            logger.log(LogLevel::INFO, LogFmt::CLIENT_ORDER_SENT, 'B', uint32_t(i), 14000.0);
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        logger.stop();
+        std::fclose(sink);
+        std::cout << "Async logger hot path: " << (elapsed / N) << " ns/record" << std::endl;
+        assertTrue(elapsed > 0, "hot path measured");
+    }
+
+    static void runAllTests() {
+        testsRun = testsPassed = 0;
+        testFormatting();
+        testBackgroundDrain();
+        testSwitchingLoggers();
+        testHotPathCost();
+        std::cout << "Async Logger Tests: " << testsPassed << "/" << testsRun << " passed" << std::endl;
+    }
+};
+
+int AsyncLoggerTest::testsRun = 0; int AsyncLoggerTest::testsPassed = 0;
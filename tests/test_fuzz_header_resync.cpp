@@ -1,44 +1,154 @@
 #include "message_buffer.h"
 #include "message_parser.h"
+#include "message_serializer.h"
 #include "wire_format.h"
+#include "metrics.h"
 #include <random>
-#include <cassert>
+#include <chrono>
+#include <vector>
+#include <cstring>
 #include <iostream>
+#include <iomanip>
 
-int main() {
-    MessageBuffer buf;
-    std::mt19937_64 rng(12345);
-    std::uniform_int_distribution<uint32_t> dist(0, 255);
-
-    const int ITER = 1000;
-    int validInjected = 0;
-    for (int i = 0; i < ITER; ++i) {
-        uint8_t chunk[32];
-        for (size_t j = 0; j < sizeof(chunk); ++j) {
-            chunk[j] = static_cast<uint8_t>(dist(rng));
+// Feeds a stream of valid frames interleaved with random garbage through
+// MessageBuffer and reports how many real frames resync recovers, how many
+// real bytes it throws away, and how fast it scans garbage.
+
+namespace {
+
+bool isHeaderPair(uint8_t length, uint8_t type) {
+    return (type == MessageHeader::QUOTE_TYPE && length == WireFormat::QUOTE_SIZE) ||
+           (type == MessageHeader::TRADE_TYPE && length == WireFormat::TRADE_SIZE);
+}
+
+struct Stream {
+    std::vector<uint8_t> bytes;
+    uint64_t framesInjected = 0;
+    uint64_t frameBytes = 0;
+};
+
+Stream buildStream(std::mt19937_64& rng, size_t frames) {
+    std::uniform_int_distribution<uint32_t> byteDist(0, 255);
+    std::uniform_int_distribution<uint32_t> garbageLen(1, 200);
+    std::uniform_int_distribution<uint32_t> coin(0, 99);
+    Stream s;
+    for (size_t i = 0; i < frames; ++i) {
+        if (coin(rng) < 20) {
+            size_t n = garbageLen(rng);
+            for (size_t j = 0; j < n; ++j) s.bytes.push_back(static_cast<uint8_t>(byteDist(rng)));
+        }
+        uint8_t frame[WireFormat::MAX_MESSAGE_SIZE];
+        size_t n;
+        if (coin(rng) < 50) {
+            QuoteMessage q{}; std::memcpy(q.symbol, "IBM", 3);
+            q.timestamp = i + 1; q.bidQuantity = 100; q.bidPrice = 14000; q.askQuantity = 100; q.askPrice = 14010;
+            n = MessageSerializer::serializeQuoteMessage(frame, sizeof(frame), q);
+        } else {
+            TradeMessage t{}; std::memcpy(t.symbol, "IBM", 3);
+            t.timestamp = i + 1; t.quantity = 50; t.price = 14005;
+            n = MessageSerializer::serializeTradeMessage(frame, sizeof(frame), t);
         }
-        if (i % 50 == 0) {
-            uint8_t len = (i % 100 == 0) ? WireFormat::TRADE_SIZE : WireFormat::QUOTE_SIZE;
-            uint8_t typ = (len == WireFormat::QUOTE_SIZE) ? MessageHeader::QUOTE_TYPE : MessageHeader::TRADE_TYPE;
-            chunk[0] = len; // length
-            chunk[1] = typ; // type
-            size_t bodyBytes = len;
-            for (size_t k = 2; k < bodyBytes + 2 && k < sizeof(chunk); ++k) {
-                chunk[k] = 0; // zero body if it fits
+        s.bytes.insert(s.bytes.end(), frame, frame + n);
+        ++s.framesInjected;
+        s.frameBytes += n;
+    }
+    return s;
+}
+
+bool runRecovery() {
+    std::mt19937_64 rng(12345);
+    Stream stream = buildStream(rng, 200000);
+
+    MessageBuffer buf;
+    uint64_t recovered = 0, recoveredBytes = 0, phantom = 0, resyncs = 0;
+    uint64_t lastTimestamp = 0;
+    size_t pos = 0;
+    while (pos < stream.bytes.size()) {
+        size_t n = std::min<size_t>(1460, stream.bytes.size() - pos);
+        if (!buf.append(stream.bytes.data() + pos, n)) return false;
+        pos += n;
+        while (true) {
+            MessageHeader hdr; uint8_t body[WireFormat::QUOTE_SIZE];
+            auto r = buf.extractMessage(hdr, body);
+            if (r == MessageBuffer::ExtractResult::SUCCESS) {
+                uint64_t ts;
+                std::memcpy(&ts, body + WireFormat::QUOTE_TIMESTAMP_OFFSET, sizeof(ts));
+                if (std::memcmp(body, "IBM\0\0\0\0\0", 8) == 0 && ts > lastTimestamp && ts <= stream.framesInjected) {
+                    ++recovered;
+                    recoveredBytes += WireFormat::HEADER_SIZE + hdr.length;
+                    lastTimestamp = ts;
+                } else {
+                    ++phantom;
+                }
+            } else if (r == MessageBuffer::ExtractResult::INVALID_HEADER) {
+                ++resyncs;
+                if (buf.resync() == 0) break;
+            } else {
+                break;
             }
-            validInjected++;
         }
-        buf.append(chunk, sizeof(chunk));
-        MessageHeader hdr; uint8_t body[64];
-        auto r = buf.extractMessage(hdr, body);
-        if (r == MessageBuffer::ExtractResult::SUCCESS) {
-            assert(hdr.type == MessageHeader::QUOTE_TYPE || hdr.type == MessageHeader::TRADE_TYPE);
-        } else if (r == MessageBuffer::ExtractResult::INVALID_MESSAGE) {
+    }
+
+    uint64_t lostFrames = stream.framesInjected - recovered;
+    std::cout << "Frames injected:    " << stream.framesInjected << std::endl;
+    std::cout << "Frames recovered:   " << recovered << std::endl;
+    std::cout << "Phantom frames:     " << phantom << std::endl;
+    std::cout << "Resync calls:       " << resyncs << std::endl;
+    std::cout << "Garbage bytes:      " << (stream.bytes.size() - stream.frameBytes) << std::endl;
+    std::cout << "Data-loss bytes:    " << (stream.frameBytes - recoveredBytes)
+              << " (" << lostFrames << " frames)" << std::endl;
+    // Random garbage occasionally forms a header pair confirmed by chance;
+    // anything beyond a handful of frames means resync is discarding good data.
+    return lostFrames * 1000 <= stream.framesInjected && phantom * 1000 <= stream.framesInjected;
+}
+
+bool runThroughput() {
+    std::mt19937_64 rng(777);
+    std::uniform_int_distribution<uint32_t> byteDist(0, 255);
+    const size_t FILL = 60000;
+    std::vector<uint8_t> garbage(FILL);
+    for (size_t i = 0; i < FILL; ++i) {
+        uint8_t b = static_cast<uint8_t>(byteDist(rng));
+        if (i > 0 && isHeaderPair(garbage[i - 1], b)) b ^= 0x80;
+        garbage[i] = b;
+    }
+    if (isHeaderPair(garbage[0], garbage[1])) garbage[0] ^= 0x80;
+
+    MessageBuffer buf;
+    const int ROUNDS = 2000;
+    uint64_t scanned = 0;
+    double seconds = 0;
+    if (isHeaderPair(garbage[FILL / 2 - 1], garbage[0])) garbage[FILL / 2 - 1] ^= 0x80;
+    for (int r = 0; r < ROUNDS; ++r) {
+        buf.clear();
+        size_t expected = FILL - 1;
+        if (r & 1) {
+            // Leave one byte behind at the midpoint so the scan wraps the ring.
+            buf.append(garbage.data(), FILL / 2);
+            buf.resync();
+            expected = FILL;
         }
-        if (buf.availableBytes() > 2048) {
-            buf.clear();
+        if (!buf.append(garbage.data(), FILL)) return false;
+        auto start = std::chrono::steady_clock::now();
+        size_t dropped = buf.resync();
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (dropped != expected) {
+            std::cerr << "[FAIL] pure garbage should be discarded in one call, dropped " << dropped << std::endl;
+            return false;
         }
+        scanned += dropped;
     }
-    std::cout << "Fuzz stub executed; injected valid headers: " << validInjected << "\n";
-    return 0;
+    double gbps = seconds > 0 ? static_cast<double>(scanned) / seconds / 1e9 : 0.0;
+    std::cout << "Resync throughput:  " << std::fixed << std::setprecision(2) << gbps << " GB/s" << std::endl;
+    return true;
+}
+
+}
+
+int main() {
+    std::cout << "=== Header Resync Fuzz ===" << std::endl;
+    bool ok = runRecovery();
+    ok = runThroughput() && ok;
+    std::cout << (ok ? "Resync fuzz PASSED" : "Resync fuzz FAILED") << std::endl;
+    return ok ? 0 : 1;
 }
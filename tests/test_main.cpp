@@ -5,6 +5,14 @@
 #include "test_order_manager.cpp"
 #include "test_parser.cpp"
 #include "test_vwap_window.cpp"
+#include "test_spsc_ring.cpp"
+#include "test_order_template.cpp"
+#include "test_order_client.cpp"
+#include "test_market_data_client.cpp"
+#include "test_async_logger.cpp"
+#include "test_metrics_export.cpp"
+#include "test_trace.cpp"
+#include "test_perf_counters.cpp"
 
 int main() {
     std::cout << "=== VWAP Trading System Test Suite ===" << std::endl;
@@ -30,6 +38,38 @@ int main() {
     totalPassed += VwapWindowEdgeTest::testsPassed;
     totalTests += OrderManagerTest::testsRun;
     totalPassed += OrderManagerTest::testsPassed;
+
+    SpscRingTest::runAllTests();
+    totalTests += SpscRingTest::testsRun;
+    totalPassed += SpscRingTest::testsPassed;
+
+    OrderTemplateTest::runAllTests();
+    totalTests += OrderTemplateTest::testsRun;
+    totalPassed += OrderTemplateTest::testsPassed;
+
+    OrderClientTest::runAllTests();
+    totalTests += OrderClientTest::testsRun;
+    totalPassed += OrderClientTest::testsPassed;
+
+    MarketDataClientTest::runAllTests();
+    totalTests += MarketDataClientTest::testsRun;
+    totalPassed += MarketDataClientTest::testsPassed;
+
+    AsyncLoggerTest::runAllTests();
+    totalTests += AsyncLoggerTest::testsRun;
+    totalPassed += AsyncLoggerTest::testsPassed;
+
+    MetricsExportTest::runAllTests();
+    totalTests += MetricsExportTest::testsRun;
+    totalPassed += MetricsExportTest::testsPassed;
+
+    TraceTest::runAllTests();
+    totalTests += TraceTest::testsRun;
+    totalPassed += TraceTest::testsPassed;
+
+    PerfCountersTest::runAllTests();
+    totalTests += PerfCountersTest::testsRun;
+    totalPassed += PerfCountersTest::testsPassed;
     
     std::cout << "\n=== OVERALL TEST SUMMARY ===" << std::endl;
     std::cout << "Total: " << totalPassed << "/" << totalTests 
@@ -0,0 +1,598 @@
+#include <iostream>
+#include <cstring>
+#include <thread>
+#include <functional>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include "market_data_client.h"
+#include "network_manager.h"
+#include "line_arbiter.h"
+#include "shm_ring.h"
+#include "message_serializer.h"
+#include "order_manager.h"
+#include "rate_meter.h"
+
+struct MarketDataClientTest {
+    static int testsRun;
+    static int testsPassed;
+
+    static void assertTrue(bool cond, const char* name) {
+        ++testsRun;
+        if (cond) { ++testsPassed; }
+        else { std::cerr << "[FAIL] " << name << std::endl; }
+    }
+
+    struct RecordingHandler {
+        int quotes{0};
+        int trades{0};
+        uint32_t lastBidPrice{0};
+        uint32_t lastTradeQuantity{0};
+        void onQuote(const QuoteMessage& q) { ++quotes; lastBidPrice = q.bidPrice; }
+        void onTrade(const TradeMessage& t) { ++trades; lastTradeQuantity = t.quantity; }
+    };
+
+    struct SequenceHandler {
+        std::vector<uint64_t> timestamps;
+        void onQuote(const QuoteMessage& q) { timestamps.push_back(q.timestamp); }
+        void onTrade(const TradeMessage& t) { timestamps.push_back(t.timestamp); }
+    };
+
+    struct BatchHandler {
+        int batches{0};
+        std::vector<uint8_t> types;
+        std::vector<uint64_t> timestamps;
+        void onQuote(const QuoteMessage&) {}
+        void onTrade(const TradeMessage&) {}
+        void onBatch(const FrameBatch& batch) {
+            ++batches;
+            batch.forEachRun(
+                [&](size_t first, size_t n) {
+                    for (size_t i = first; i < first + n; ++i) {
+                        types.push_back(uint8_t{MessageHeader::TRADE_TYPE});
+                        timestamps.push_back(batch.tradeAt(i).timestamp);
+                    }
+                },
+                [&](size_t i) {
+                    types.push_back(uint8_t{MessageHeader::QUOTE_TYPE});
+                    timestamps.push_back(batch.quoteAt(i).timestamp);
+                });
+        }
+    };
+
+    struct Listener {
+        int fd{-1};
+        uint16_t port{0};
+        Listener() {
+            fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in addr{}; addr.sin_family = AF_INET; addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); addr.sin_port = 0;
+            if (fd < 0 || ::bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || ::listen(fd, 4) < 0) { port = 0; return; }
+            socklen_t len = sizeof(addr);
+            ::getsockname(fd, (sockaddr*)&addr, &len);
+            port = ntohs(addr.sin_port);
+        }
+        ~Listener() { if (fd >= 0) ::close(fd); }
+    };
+
+    static size_t writeQuoteAndTrade(int peer, const char* symbol = "IBM") {
+        QuoteMessage q{}; std::memcpy(q.symbol, symbol, std::strlen(symbol));
+        q.timestamp = 1; q.bidQuantity = 100; q.bidPrice = 13990; q.askQuantity = 200; q.askPrice = 14010;
+        TradeMessage t{}; std::memcpy(t.symbol, symbol, std::strlen(symbol));
+        t.timestamp = 2; t.quantity = 75; t.price = 14000;
+
+        uint8_t frames[2 * WireFormat::MAX_MESSAGE_SIZE];
+        size_t n = MessageSerializer::serializeQuoteMessage(frames, sizeof(frames), q);
+        n += MessageSerializer::serializeTradeMessage(frames + n, sizeof(frames) - n, t);
+        return static_cast<size_t>(::send(peer, frames, n, 0)) == n ? n : 0;
+    }
+
+    template<typename Client>
+    static bool drainUntil(Client& client, const std::function<bool()>& done) {
+        for (int i = 0; i < 100 && !done(); ++i) {
+            client.processIncomingData();
+            if (!done()) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return done();
+    }
+
+    static void testStaticHandlerDispatch() {
+        Listener listener;
+        if (listener.port == 0) { assertTrue(false, "listener setup"); return; }
+        RecordingHandler handler;
+        BasicMarketDataClient<RecordingHandler> client("127.0.0.1", listener.port, &handler);
+        bool connected = client.connect();
+        int peer = ::accept(listener.fd, nullptr, nullptr);
+        assertTrue(connected && peer >= 0, "market data client connects");
+        if (!connected || peer < 0) return;
+
+        assertTrue(writeQuoteAndTrade(peer) > 0, "frames written");
+        bool delivered = drainUntil(client, [&] { return handler.quotes == 1 && handler.trades == 1; });
+        assertTrue(delivered, "quote and trade delivered to handler");
+        assertTrue(handler.lastBidPrice == 13990 && handler.lastTradeQuantity == 75, "handler sees decoded fields");
+        ::close(peer);
+    }
+
+    struct PipelineHandler {
+        OrderManager* manager;
+        void onQuote(const QuoteMessage& q) { manager->processQuote(q); }
+        void onTrade(const TradeMessage& t) { manager->processTrade(t); }
+    };
+
+    // The client owns the feed counters; VWAP and the decision engine no
+    // longer add to them.
+    static void testCountedOnce() {
+        Listener listener;
+        if (listener.port == 0) { assertTrue(false, "listener setup"); return; }
+        OrderManager manager("IBM", 'B', 100, 1, false);
+        PipelineHandler handler{&manager};
+        BasicMarketDataClient<PipelineHandler> client("127.0.0.1", listener.port, &handler);
+        bool connected = client.connect();
+        int peer = ::accept(listener.fd, nullptr, nullptr);
+        if (!connected || peer < 0) { assertTrue(false, "pipeline client connects"); return; }
+
+        const MetricsSnapshot before = MetricsSnapshot::capture(g_systemMetrics);
+        size_t written = writeQuoteAndTrade(peer) + writeQuoteAndTrade(peer);
+        drainUntil(client, [&] { return manager.getTradeCount() == 2 && manager.getQuoteCount() == 2; });
+        const MetricsSnapshot after = MetricsSnapshot::capture(g_systemMetrics);
+        assertTrue(after.quotesProcessed - before.quotesProcessed == 2 &&
+                   after.tradesProcessed - before.tradesProcessed == 2 &&
+                   after.messagesReceived - before.messagesReceived == 4, "feed messages counted once");
+        assertTrue(after.bytesReceived - before.bytesReceived == written, "received bytes counted once");
+        ::close(peer);
+    }
+
+    static void testRateMeter() {
+        const uint64_t S = RateMeter::NANOS_PER_SECOND;
+        RateMeter meter;
+        HotCounters::Totals totals{};
+        meter.sample(100 * S, totals);
+        assertTrue(meter.report().seconds == 0, "first sample is the baseline");
+
+        for (uint64_t second = 1; second <= 20; ++second) {
+            totals.messagesReceived += second <= 10 ? 100 : 1000;
+            totals.bytesReceived += 3000;
+            totals.bytesSent += 1000;
+            totals.ordersPlaced += second == 5 ? 7 : 0;
+            meter.sample((100 + second) * S, totals);
+        }
+        RateMeter::Report r = meter.report();
+        assertTrue(r.seconds == 20 && r.messages.last == 1000 && r.messages.avg10 == 1000 &&
+                   r.messages.avg60 == 550 && r.messages.peak == 1000, "message rates over the windows");
+        assertTrue(r.bytes.last == 4000 && r.orders.peak == 7 && r.orders.last == 0, "byte and order rates");
+
+        // A stalled poller spreads the gap evenly over the missed seconds.
+        totals.messagesReceived += 5 * 200;
+        meter.sample(125 * S, totals);
+        r = meter.report();
+        assertTrue(r.seconds == 25 && r.messages.last == 200 && r.messages.peak == 1000, "gap filled with its mean rate");
+        assertTrue(g_systemMetrics.perf.peakMessagesPerSecond.load() >= 1000, "peak published to system metrics");
+    }
+
+    static void testCallbackAdapter() {
+        Listener listener;
+        if (listener.port == 0) { assertTrue(false, "listener setup"); return; }
+        MarketDataClient client("127.0.0.1", listener.port);
+        int quotes = 0, trades = 0;
+        client.setMessageCallback([&](const MessageHeader& header, const void* data) {
+            if (header.type == MessageHeader::QUOTE_TYPE && static_cast<const QuoteMessage*>(data)->askPrice == 14010) ++quotes;
+            if (header.type == MessageHeader::TRADE_TYPE && static_cast<const TradeMessage*>(data)->price == 14000) ++trades;
+        });
+        bool connected = client.connect();
+        int peer = ::accept(listener.fd, nullptr, nullptr);
+        if (!connected || peer < 0) { assertTrue(false, "adapter client connects"); return; }
+
+        writeQuoteAndTrade(peer);
+        bool delivered = drainUntil(client, [&] { return quotes == 1 && trades == 1; });
+        assertTrue(delivered, "legacy callback receives typed messages");
+        ::close(peer);
+    }
+
+    static void testSubscriptionFilter() {
+        Listener listener;
+        if (listener.port == 0) { assertTrue(false, "listener setup"); return; }
+        RecordingHandler handler;
+        BasicMarketDataClient<RecordingHandler> client("127.0.0.1", listener.port, &handler);
+        assertTrue(client.subscribe("IBM") && !client.subscribe("TOOLONGSYM"), "subscribe validates symbol length");
+        bool connected = client.connect();
+        int peer = ::accept(listener.fd, nullptr, nullptr);
+        if (!connected || peer < 0) { assertTrue(false, "filter client connects"); return; }
+
+        uint64_t filteredBefore = g_systemMetrics.feed.messagesFiltered.load();
+        writeQuoteAndTrade(peer, "IBMX");
+        writeQuoteAndTrade(peer, "IBM");
+        bool delivered = drainUntil(client, [&] { return handler.quotes == 1 && handler.trades == 1; });
+        assertTrue(delivered, "subscribed symbol delivered");
+        assertTrue(g_systemMetrics.feed.messagesFiltered.load() - filteredBefore == 2, "other symbols filtered before parsing");
+        ::close(peer);
+    }
+
+    struct StampHandler {
+        uint64_t tradeRxNanos{0};
+        int trades{0};
+        void onQuote(const QuoteMessage&) {}
+        void onTrade(const TradeMessage&) { ++trades; tradeRxNanos = g_rxKernelNanos; }
+    };
+
+    static void testRxTimestamps() {
+        LatencyHistogram hist;
+        for (uint64_t v : {3ULL, 100ULL, 120ULL, 5000ULL}) hist.record(v);
+        assertTrue(hist.count() == 4 && hist.percentile(0.5) == 128 && hist.percentile(1.0) == 8192,
+                   "histogram percentiles report bucket bounds");
+
+        Listener listener;
+        if (listener.port == 0) { assertTrue(false, "listener setup"); return; }
+        StampHandler handler;
+        BasicMarketDataClient<StampHandler> client("127.0.0.1", listener.port, &handler);
+        client.enableRxTimestamps(true);
+        bool connected = client.connect();
+        int peer = ::accept(listener.fd, nullptr, nullptr);
+        if (!connected || peer < 0) { assertTrue(false, "timestamped client connects"); return; }
+
+        uint64_t stampedBefore = g_systemMetrics.wire.kernelToUser.count();
+        uint64_t unstampedBefore = g_systemMetrics.wire.unstampedReads.load();
+        uint64_t sentAt = realtimeNanos();
+        writeQuoteAndTrade(peer);
+        bool delivered = drainUntil(client, [&] { return handler.trades == 1; });
+        uint64_t reads = g_systemMetrics.wire.kernelToUser.count() - stampedBefore +
+                         g_systemMetrics.wire.unstampedReads.load() - unstampedBefore;
+        assertTrue(delivered && reads >= 1, "every read is stamped or counted unstamped");
+        if (client.rxTimestampsAvailable()) {
+            assertTrue(handler.tradeRxNanos >= sentAt && handler.tradeRxNanos <= realtimeNanos(),
+                       "kernel timestamp visible during dispatch");
+        } else {
+            assertTrue(handler.tradeRxNanos == 0, "no timestamp without kernel support");
+        }
+        assertTrue(g_rxKernelNanos == 0, "timestamp cleared after the drain");
+        ::close(peer);
+    }
+
+    static void testBatchDispatch() {
+        Listener listener;
+        if (listener.port == 0) { assertTrue(false, "listener setup"); return; }
+        RecordingHandler plain;
+        BasicMarketDataClient<RecordingHandler> plainClient("127.0.0.1", listener.port, &plain);
+        assertTrue(!plainClient.setBatchMode(true) && !plainClient.isBatchMode(), "batch mode needs onBatch");
+
+        BatchHandler handler;
+        BasicMarketDataClient<BatchHandler> client("127.0.0.1", listener.port, &handler);
+        assertTrue(client.setBatchMode(true), "batch mode enabled");
+        client.subscribe("IBM");
+        bool connected = client.connect();
+        int peer = ::accept(listener.fd, nullptr, nullptr);
+        if (!connected || peer < 0) { assertTrue(false, "batch client connects"); return; }
+
+        // quote(1) trade(2) filtered quote/trade, quote(1) trade(2): order must survive.
+        writeQuoteAndTrade(peer);
+        writeQuoteAndTrade(peer, "MSFT");
+        writeQuoteAndTrade(peer);
+        bool delivered = drainUntil(client, [&] { return handler.types.size() == 4; });
+        assertTrue(delivered, "batched frames delivered");
+        const uint8_t Q = MessageHeader::QUOTE_TYPE, T = MessageHeader::TRADE_TYPE;
+        assertTrue(handler.types == std::vector<uint8_t>({Q, T, Q, T}) &&
+                   handler.timestamps == std::vector<uint64_t>({1, 2, 1, 2}), "batch keeps wire order");
+        assertTrue(handler.batches >= 1 && handler.batches <= 3, "frames grouped into batches");
+        ::close(peer);
+    }
+
+    static size_t appendQuote(uint8_t* out, const char* symbol, uint64_t ts, uint32_t bid) {
+        QuoteMessage q{}; std::memcpy(q.symbol, symbol, std::strlen(symbol));
+        q.timestamp = ts; q.bidQuantity = 100; q.bidPrice = bid; q.askQuantity = 100; q.askPrice = bid + 20;
+        return MessageSerializer::serializeQuoteMessage(out, WireFormat::MAX_MESSAGE_SIZE, q);
+    }
+
+    static size_t appendTrade(uint8_t* out, const char* symbol, uint64_t ts) {
+        TradeMessage t{}; std::memcpy(t.symbol, symbol, std::strlen(symbol));
+        t.timestamp = ts; t.quantity = 10; t.price = 14000;
+        return MessageSerializer::serializeTradeMessage(out, WireFormat::MAX_MESSAGE_SIZE, t);
+    }
+
+    static void testQuoteConflation() {
+        Listener listener;
+        if (listener.port == 0) { assertTrue(false, "listener setup"); return; }
+        SequenceHandler handler;
+        BasicMarketDataClient<SequenceHandler> client("127.0.0.1", listener.port, &handler);
+        client.setConflation(true);
+        bool connected = client.connect();
+        int peer = ::accept(listener.fd, nullptr, nullptr);
+        if (!connected || peer < 0) { assertTrue(false, "conflation client connects"); return; }
+
+        uint8_t frames[8 * WireFormat::MAX_MESSAGE_SIZE];
+        size_t n = appendQuote(frames, "IBM", 1, 13990);
+        n += appendQuote(frames + n, "MSFT", 2, 30000);
+        n += appendTrade(frames + n, "IBM", 3);
+        n += appendQuote(frames + n, "IBM", 4, 13995);
+        n += appendTrade(frames + n, "IBM", 5);
+        n += appendQuote(frames + n, "IBM", 6, 13996);
+        uint64_t conflatedBefore = g_systemMetrics.feed.quotesConflated.load();
+        assertTrue(static_cast<size_t>(::send(peer, frames, n, 0)) == n, "conflation frames written");
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        // One drain: trades in order, then the newest quote per symbol.
+        bool delivered = drainUntil(client, [&] { return handler.timestamps.size() >= 4; });
+        assertTrue(delivered && handler.timestamps == std::vector<uint64_t>({3, 5, 6, 2}),
+                   "trades first, then latest quote per symbol");
+        assertTrue(g_systemMetrics.feed.quotesConflated.load() - conflatedBefore == 2, "conflated quotes counted");
+        ::close(peer);
+    }
+
+    static void testUdpTransport() {
+        SequenceHandler handler;
+        BasicMarketDataClient<SequenceHandler> client("127.0.0.1", 0, &handler);
+        client.setTransport(MarketDataClientBase::Transport::UDP);
+        if (!client.connect()) { assertTrue(false, "udp client binds"); return; }
+        sockaddr_in addr{}; socklen_t len = sizeof(addr);
+        ::getsockname(client.getSocketFd(), (sockaddr*)&addr, &len);
+        int sender = ::socket(AF_INET, SOCK_DGRAM, 0);
+        ::connect(sender, (sockaddr*)&addr, sizeof(addr));
+
+        auto sendDatagram = [&](uint64_t sequence, const uint8_t* frames, size_t n) {
+            uint8_t dgram[WireFormat::MAX_DATAGRAM_SIZE];
+            std::memcpy(dgram, &sequence, sizeof(sequence));
+            std::memcpy(dgram + WireFormat::DATAGRAM_SEQUENCE_SIZE, frames, n);
+            ::send(sender, dgram, WireFormat::DATAGRAM_SEQUENCE_SIZE + n, 0);
+        };
+        uint64_t lostBefore = g_systemMetrics.udp.datagramsLost.load();
+        uint64_t droppedBefore = g_systemMetrics.udp.datagramsDropped.load();
+
+        uint8_t frames[4 * WireFormat::MAX_MESSAGE_SIZE];
+        size_t n = appendQuote(frames, "IBM", 1, 13990);
+        n += appendTrade(frames + n, "IBM", 2);
+        sendDatagram(1, frames, n);                  // two frames in one datagram
+        n = appendTrade(frames, "IBM", 3);
+        sendDatagram(2, frames, n);
+        n = appendTrade(frames, "IBM", 6);
+        sendDatagram(5, frames, n);                  // 3 and 4 lost
+        n = appendTrade(frames, "IBM", 4);
+        sendDatagram(3, frames, n);                  // late, dropped
+        n = appendTrade(frames, "IBM", 7);
+        sendDatagram(6, frames, n - 1);              // truncated frame
+        n = appendTrade(frames, "IBM", 8);
+        sendDatagram(7, frames, n);
+
+        bool delivered = drainUntil(client, [&] { return handler.timestamps.size() >= 5; });
+        assertTrue(delivered && handler.timestamps == std::vector<uint64_t>({1, 2, 3, 6, 8}), "datagram frames delivered");
+        assertTrue(g_systemMetrics.udp.datagramsLost.load() - lostBefore == 2, "sequence gap counted");
+        assertTrue(g_systemMetrics.udp.datagramsDropped.load() - droppedBefore == 2, "late and malformed datagrams dropped");
+        ::close(sender);
+    }
+
+    static void testShmTransport() {
+        const std::string name = "vwap_test_" + std::to_string(::getpid());
+        SequenceHandler handler;
+        BasicMarketDataClient<SequenceHandler> client("shm://" + name, 0, &handler);
+        client.setTransport(MarketDataClientBase::Transport::TCP);
+        assertTrue(client.getTransport() == MarketDataClientBase::Transport::SHM, "shm address selects the ring");
+        assertTrue(!client.connect(), "ring without a writer refused");
+
+        ShmRingWriter writer(8);
+        if (!writer.create(name)) { assertTrue(false, "ring created"); return; }
+        assertTrue(client.connect() && client.getSocketFd() < 0, "ring reader attaches");
+
+        uint8_t frame[WireFormat::MAX_MESSAGE_SIZE];
+        writer.publish(frame, appendQuote(frame, "IBM", 1, 13990));
+        writer.publish(frame, appendTrade(frame, "IBM", 2));
+        client.processIncomingData();
+        assertTrue(handler.timestamps == std::vector<uint64_t>({1, 2}), "ring frames delivered");
+
+        uint64_t overrunsBefore = g_systemMetrics.feed.ringOverruns.load();
+        for (uint64_t ts = 10; ts < 30; ++ts) writer.publish(frame, appendTrade(frame, "IBM", ts));
+        client.processIncomingData();
+        assertTrue(handler.timestamps.size() == 6 && handler.timestamps[2] == 26 && handler.timestamps.back() == 29,
+                   "lapped reader resumes behind the writer");
+        assertTrue(g_systemMetrics.feed.ringOverruns.load() - overrunsBefore == 16, "overwritten messages counted");
+
+        writer.close();
+        assertTrue(!client.processIncomingData() && !client.isConnected(), "closed ring ends the stream");
+        std::remove(ShmRing::path(name).c_str());
+    }
+
+    // Each thread counts into its own shard; capture sums live and exited
+    // threads alike.
+    static void testShardedHotCounters() {
+        const int THREADS = 4;
+        const uint64_t PER_THREAD = 100000;
+        const MetricsSnapshot before = MetricsSnapshot::capture(g_systemMetrics);
+        const size_t shardsBefore = g_systemMetrics.hot.threads();
+        std::atomic<int> started{0};
+        std::atomic<bool> release{false};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < THREADS; ++t) {
+            workers.emplace_back([&] {
+                HotCounters& hot = localHotCounters();
+                started.fetch_add(1);
+                while (!release.load()) std::this_thread::yield();
+                for (uint64_t i = 0; i < PER_THREAD; ++i) {
+                    hot.quotesProcessed.add(1);
+                    g_metricsView.addBytesReceived(3);
+                }
+            });
+        }
+        while (started.load() < THREADS) std::this_thread::yield();
+        assertTrue(g_systemMetrics.hot.threads() == shardsBefore + THREADS, "each thread attaches a shard");
+        release.store(true);
+        uint64_t previous = before.quotesProcessed;
+        bool monotonic = true;
+        for (int i = 0; i < 50; ++i) {
+            uint64_t now = MetricsSnapshot::capture(g_systemMetrics).quotesProcessed;
+            monotonic = monotonic && now >= previous;
+            previous = now;
+        }
+        for (auto& w : workers) w.join();
+
+        const MetricsSnapshot after = MetricsSnapshot::capture(g_systemMetrics);
+        assertTrue(monotonic, "totals never go backwards while threads count");
+        assertTrue(after.quotesProcessed - before.quotesProcessed == THREADS * PER_THREAD &&
+                   after.bytesReceived - before.bytesReceived == 3 * THREADS * PER_THREAD,
+                   "exited threads' counts retained");
+        assertTrue(g_systemMetrics.hot.threads() == shardsBefore, "exited threads detach");
+    }
+
+    static void testLineArbiter() {
+        LineArbiter arbiter(2);
+        uint8_t a[WireFormat::TRADE_SIZE] = {'I', 'B', 'M'};
+        uint8_t b[WireFormat::TRADE_SIZE] = {'I', 'B', 'M'};
+        b[WireFormat::TRADE_PRICE_OFFSET] = 1;
+        const uint8_t T = MessageHeader::TRADE_TYPE, Q = MessageHeader::QUOTE_TYPE;
+
+        assertTrue(arbiter.admit(0, T, a, sizeof(a), 1000), "first copy forwarded");
+        assertTrue(!arbiter.admit(1, T, a, sizeof(a), 1600), "second copy suppressed");
+        assertTrue(arbiter.admit(1, T, b, sizeof(b), 1700), "different payload forwarded");
+        assertTrue(arbiter.admit(0, Q, a, sizeof(a), 1800), "type is part of the key");
+        assertTrue(arbiter.stats(0).wins == 2 && arbiter.stats(1).wins == 1 &&
+                   arbiter.stats(1).duplicates == 1 && arbiter.stats(1).lagMaxNanos == 600, "win and lag statistics");
+
+        for (uint32_t i = 0; i < LineArbiter::WINDOW; ++i) {
+            uint8_t c[WireFormat::TRADE_SIZE] = {};
+            std::memcpy(c + WireFormat::TRADE_TIMESTAMP_OFFSET, &i, sizeof(i));
+            arbiter.admit(0, T, c, sizeof(c), 2000);
+        }
+        assertTrue(arbiter.admit(1, T, a, sizeof(a), 3000), "copies older than the window are forwarded again");
+    }
+
+    static void testRedundantLines() {
+        Listener lineA, lineB, orders;
+        if (lineA.port == 0 || lineB.port == 0 || orders.port == 0) { assertTrue(false, "listener setup"); return; }
+        RuntimeConfig saved = runtimeConfig();
+        runtimeConfig().extraMarketDataLines = {FeedEndpoint{"127.0.0.1", lineB.port}};
+
+        SequenceHandler handler;
+        BasicNetworkManager<SequenceHandler> manager(&handler);
+        Config config;
+        config.marketDataHost = "127.0.0.1"; config.marketDataPort = lineA.port;
+        config.orderHost = "127.0.0.1"; config.orderPort = orders.port;
+        bool initialized = manager.initialize(config);
+        runtimeConfig() = saved;
+        int peerA = ::accept(lineA.fd, nullptr, nullptr);
+        int peerB = ::accept(lineB.fd, nullptr, nullptr);
+        int peerO = ::accept(orders.fd, nullptr, nullptr);
+        assertTrue(initialized && manager.getArbiter() && peerA >= 0 && peerB >= 0, "redundant lines connect");
+        if (!initialized || !manager.getArbiter() || peerA < 0 || peerB < 0) return;
+
+        auto pump = [&](size_t expected) {
+            for (int i = 0; i < 50 && handler.timestamps.size() < expected; ++i) manager.processEvents();
+            return handler.timestamps.size() == expected;
+        };
+        uint8_t frames[4 * WireFormat::MAX_MESSAGE_SIZE];
+        size_t n = appendQuote(frames, "IBM", 1, 13990);
+        n += appendTrade(frames + n, "IBM", 2);
+        ::send(peerA, frames, n, 0);
+        assertTrue(pump(2), "line A copies delivered");
+        ::send(peerB, frames, n, 0);
+        size_t m = appendTrade(frames + n, "IBM", 3);
+        ::send(peerB, frames + n, m, 0);
+        assertTrue(pump(3) && handler.timestamps == std::vector<uint64_t>({1, 2, 3}), "line B duplicates suppressed");
+
+        // Line A drops; line B keeps the stream going.
+        ::close(peerA);
+        m = appendTrade(frames, "IBM", 4);
+        ::send(peerB, frames, m, 0);
+        assertTrue(pump(4) && handler.timestamps.back() == 4, "failover to surviving line");
+        const LineArbiter* arbiter = manager.getArbiter();
+        assertTrue(arbiter->stats(0).wins == 2 && arbiter->stats(1).wins == 2 && arbiter->stats(1).duplicates == 2,
+                   "per-line wins tracked");
+        manager.stop();
+        ::close(peerB);
+        if (peerO >= 0) ::close(peerO);
+    }
+
+    // The market data line drops and its reconnect stalls because the
+    // server's accept queue is full; queued orders must still be flushed.
+    static void testAsyncReconnect() {
+        Listener orders;
+        int market = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{}; addr.sin_family = AF_INET; addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (orders.port == 0 || market < 0 || ::bind(market, (sockaddr*)&addr, sizeof(addr)) < 0 ||
+            ::listen(market, 0) < 0 || ::getsockname(market, (sockaddr*)&addr, &len) < 0) {
+            assertTrue(false, "listener setup");
+            return;
+        }
+        RuntimeConfig saved = runtimeConfig();
+        runtimeConfig().coalesceOrders = true;
+        runtimeConfig().coalesceBudgetNanos = 60000000000ULL;
+
+        RecordingHandler handler;
+        BasicNetworkManager<RecordingHandler> manager(&handler);
+        Config config;
+        config.marketDataHost = "127.0.0.1"; config.marketDataPort = ntohs(addr.sin_port);
+        config.orderHost = "127.0.0.1"; config.orderPort = orders.port;
+        bool initialized = manager.initialize(config);
+        runtimeConfig() = saved;
+        int peerM = ::accept(market, nullptr, nullptr);
+        int peerO = ::accept(orders.fd, nullptr, nullptr);
+        assertTrue(initialized && peerM >= 0 && peerO >= 0, "manager connects");
+        if (!initialized || peerM < 0 || peerO < 0) { ::close(market); return; }
+
+        // Fill the accept queue until a connect stays pending.
+        std::vector<int> fillers;
+        bool full = false;
+        for (int i = 0; i < 8 && !full; ++i) {
+            int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            ::fcntl(fd, F_SETFL, O_NONBLOCK);
+            ::connect(fd, (sockaddr*)&addr, sizeof(addr));
+            fillers.push_back(fd);
+            pollfd p{fd, POLLOUT, 0};
+            full = ::poll(&p, 1, 50) == 0;
+        }
+        ::close(peerM);
+
+        using clock = std::chrono::steady_clock;
+        auto slowest = clock::duration::zero();
+        auto deadline = clock::now() + std::chrono::seconds(3);
+        while (manager.marketLineState(0) != TcpClient::ConnectionState::CONNECTING && clock::now() < deadline) {
+            auto start = clock::now();
+            manager.processEvents();
+            slowest = std::max(slowest, clock::now() - start);
+        }
+        assertTrue(full && manager.marketLineState(0) == TcpClient::ConnectionState::CONNECTING, "market reconnect pending");
+
+        OrderMessage order{};
+        std::memcpy(order.symbol, "IBM", 3);
+        order.side = 'B'; order.timestamp = 1; order.quantity = 100; order.price = 14000;
+        bool queued = manager.sendOrder(order);
+        uint8_t wire[64];
+        ssize_t got = 0;
+        for (int i = 0; i < 20 && got <= 0; ++i) {
+            auto start = clock::now();
+            manager.processEvents();
+            slowest = std::max(slowest, clock::now() - start);
+            got = ::recv(peerO, wire, sizeof(wire), MSG_DONTWAIT);
+        }
+        assertTrue(queued && got == static_cast<ssize_t>(WireFormat::ORDER_SIZE),
+                   "orders flushed while market data reconnects");
+        assertTrue(manager.marketLineState(0) == TcpClient::ConnectionState::CONNECTING &&
+                   slowest < std::chrono::milliseconds(500), "event loop never blocks on connect");
+
+        manager.stop();
+        for (int fd : fillers) ::close(fd);
+        ::close(peerO);
+        ::close(market);
+    }
+
+    static void runAllTests() {
+        testStaticHandlerDispatch();
+        testBatchDispatch();
+        testRxTimestamps();
+        testQuoteConflation();
+        testUdpTransport();
+        testShmTransport();
+        testShardedHotCounters();
+        testCountedOnce();
+        testRateMeter();
+        testLineArbiter();
+        testRedundantLines();
+        testAsyncReconnect();
+        testSubscriptionFilter();
+        testCallbackAdapter();
+        std::cout << "Market Data Client Tests: " << testsPassed << "/" << testsRun << " passed" << std::endl;
+    }
+};
+
+int MarketDataClientTest::testsRun = 0;
+int MarketDataClientTest::testsPassed = 0;
@@ -0,0 +1,166 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <atomic>
+#include <thread>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "metrics.h"
+#include "rate_meter.h"
+#include "stats_segment.h"
+#include "metrics_http.h"
+#include "shm_ring.h"
+
+struct MetricsExportTest {
+    static int testsRun;
+    static int testsPassed;
+
+    static void assertTrue(bool cond, const char* name) {
+        ++testsRun;
+        if (cond) { ++testsPassed; }
+        else { std::cerr << "[FAIL] " << name << std::endl; }
+    }
+
+    static bool contains(const std::string& text, const std::string& needle) {
+        return text.find(needle) != std::string::npos;
+    }
+
+    static void testStatsSegment() {
+        const std::string name = "vwap_stats_test_" + std::to_string(::getpid());
+        StatsSegmentReader reader;
+        assertTrue(!reader.open(name), "missing segment refused");
+
+        StatsSegment::Record record;
+        {
+            StatsSegmentWriter writer(0);
+            if (!writer.create(name)) { assertTrue(false, "segment created"); return; }
+            assertTrue(reader.open(name) && reader.writerOpen() && reader.writerPid() == ::getpid(), "reader attaches");
+            assertTrue(!reader.read(record), "nothing read before the first publish");
+
+            MetricsSnapshot metrics{};
+            metrics.messagesReceived = 1234;
+            metrics.ordersPlaced = 7;
+            RateMeter::Report rates;
+            rates.messages.peak = 99.5;
+            writer.publish(metrics, rates);
+            assertTrue(reader.read(record) && reader.version() == 1 && record.metrics.messagesReceived == 1234 &&
+                       record.metrics.ordersPlaced == 7 && record.rates.messages.peak == 99.5 &&
+                       record.publishedNanos >= record.startedNanos, "published record read back");
+
+            // A reader polling flat out never sees a half-written record. Every
+            // record from here on, including the one there before the poller
+            // starts, has bytesReceived == 3 * messagesReceived.
+            metrics.messagesReceived = 0;
+            writer.publish(metrics, rates);
+            std::atomic<bool> started{false}, done{false};
+            std::atomic<uint64_t> torn{0}, reads{0};
+            std::thread poller([&] {
+                StatsSegment::Record r;
+                started.store(true);
+                while (!done.load()) {
+                    if (!reader.read(r)) continue;
+                    if (r.metrics.bytesReceived != 3 * r.metrics.messagesReceived) torn.fetch_add(1);
+                    reads.fetch_add(1);
+                }
+            });
+            while (!started.load()) std::this_thread::yield();
+            for (uint64_t i = 1; i <= 20000; ++i) {
+                metrics.messagesReceived = i;
+                metrics.bytesReceived = 3 * i;
+                writer.publish(metrics, rates);
+                if (i % 64 == 0) std::this_thread::yield();
+            }
+            done.store(true);
+            poller.join();
+            assertTrue(torn.load() == 0 && reads.load() > 0, "concurrent reads are consistent");
+        }
+        assertTrue(!reader.writerOpen() && reader.read(record) && record.metrics.messagesReceived == 20000,
+                   "last record readable after the writer closes");
+        reader.close();
+        std::remove(ShmRing::path(name).c_str());
+    }
+
+    static void testPrometheusRender() {
+        SystemMetrics metrics;
+        metrics.wire.kernelToUser.record(3);
+        metrics.wire.kernelToUser.record(900);
+        RateMeter::Report rates;
+        rates.orders.avg10 = 2.5;
+        const std::string text = MetricsHttpServer::render(metrics, &rates);
+        assertTrue(contains(text, "# TYPE vwap_messages_received_total counter\nvwap_messages_received_total "),
+                   "counters typed and sampled");
+        assertTrue(contains(text, "vwap_kernel_to_user_nanoseconds_bucket{le=\"3\"} 1\n") &&
+                   contains(text, "vwap_kernel_to_user_nanoseconds_bucket{le=\"1023\"} 2\n") &&
+                   contains(text, "vwap_kernel_to_user_nanoseconds_bucket{le=\"+Inf\"} 2\n") &&
+                   contains(text, "vwap_kernel_to_user_nanoseconds_sum 903\n") &&
+                   contains(text, "vwap_kernel_to_user_nanoseconds_count 2\n"), "histogram buckets are cumulative");
+        assertTrue(contains(text, "vwap_rate_per_second{series=\"orders\",window=\"10s\"} 2.500\n"), "rates exported");
+        assertTrue(!contains(MetricsHttpServer::render(metrics, nullptr), "vwap_rate_per_second"),
+                   "rates omitted without a meter");
+    }
+
+    // Drives the server's event source hooks until the client socket has
+    // the whole response.
+    static std::string scrape(MetricsHttpServer& server, const std::string& request) {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(server.port());
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) { ::close(fd); return ""; }
+        ::send(fd, request.data(), request.size(), 0);
+
+        std::string response;
+        for (int i = 0; i < 200; ++i) {
+            fd_set readSet, writeSet;
+            FD_ZERO(&readSet);
+            FD_ZERO(&writeSet);
+            int maxFd = -1;
+            server.watch(readSet, writeSet, maxFd);
+            timeval timeout{0, 10000};
+            ::select(maxFd + 1, &readSet, &writeSet, nullptr, &timeout);
+            server.service(readSet, writeSet);
+
+            char buffer[4096];
+            ssize_t n;
+            while ((n = ::recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) response.append(buffer, n);
+            if (n == 0) break;
+        }
+        ::close(fd);
+        return response;
+    }
+
+    static void testHttpEndpoint() {
+        RateMeter meter;
+        MetricsHttpServer server(&meter);
+        if (!server.listen(0)) { assertTrue(false, "metrics listener"); return; }
+        assertTrue(server.port() != 0, "ephemeral port bound");
+
+        const std::string ok = scrape(server, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+        const size_t bodyStart = ok.find("\r\n\r\n");
+        const std::string body = bodyStart == std::string::npos ? "" : ok.substr(bodyStart + 4);
+        assertTrue(ok.compare(0, 15, "HTTP/1.1 200 OK") == 0 &&
+                   contains(ok, "Content-Type: text/plain; version=0.0.4") &&
+                   contains(ok, "Content-Length: " + std::to_string(body.size()) + "\r\n") &&
+                   contains(body, "vwap_orders_placed_total") && contains(body, "vwap_rate_per_second"),
+                   "scrape served in full");
+        assertTrue(scrape(server, "GET /other HTTP/1.1\r\n\r\n").compare(0, 12, "HTTP/1.1 404") == 0, "unknown path 404");
+        assertTrue(scrape(server, "POST /metrics HTTP/1.1\r\n\r\n").compare(0, 12, "HTTP/1.1 405") == 0,
+                   "other methods refused");
+        server.close();
+        assertTrue(!server.isListening(), "listener closed");
+    }
+
+    static void runAllTests() {
+        testStatsSegment();
+        testPrometheusRender();
+        testHttpEndpoint();
+        std::cout << "Metrics Export Tests: " << testsPassed << "/" << testsRun << " passed" << std::endl;
+    }
+};
+
+int MetricsExportTest::testsRun = 0;
+int MetricsExportTest::testsPassed = 0;
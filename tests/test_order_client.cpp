@@ -0,0 +1,198 @@
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netinet/ip.h>
+#include <unistd.h>
+#include "order_client.h"
+#include "message_serializer.h"
+#include "metrics.h"
+
+struct OrderClientTest {
+    static int testsRun;
+    static int testsPassed;
+
+    static void assertTrue(bool cond, const char* name) {
+        ++testsRun;
+        if (cond) { ++testsPassed; }
+        else { std::cerr << "[FAIL] " << name << std::endl; }
+    }
+
+    struct Listener {
+        int fd{-1};
+        uint16_t port{0};
+        Listener() {
+            fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in addr{}; addr.sin_family = AF_INET; addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); addr.sin_port = 0;
+            if (fd < 0 || ::bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || ::listen(fd, 4) < 0) { port = 0; return; }
+            socklen_t len = sizeof(addr);
+            ::getsockname(fd, (sockaddr*)&addr, &len);
+            port = ntohs(addr.sin_port);
+        }
+        ~Listener() { if (fd >= 0) ::close(fd); }
+    };
+
+    static size_t readExactly(int fd, uint8_t* buf, size_t len) {
+        size_t got = 0;
+        while (got < len) {
+            ssize_t r = ::recv(fd, buf + got, len - got, 0);
+            if (r <= 0) break;
+            got += static_cast<size_t>(r);
+        }
+        return got;
+    }
+
+    static OrderMessage makeOrder(uint64_t ts, uint32_t qty, int32_t px) {
+        OrderMessage o; std::memcpy(o.symbol, "IBM", 3); o.side = 'B';
+        o.timestamp = ts; o.quantity = qty; o.price = px;
+        return o;
+    }
+
+    static void testCoalescedFlush() {
+        Listener listener;
+        if (listener.port == 0) { assertTrue(false, "listener setup"); return; }
+        OrderClient client("127.0.0.1", listener.port);
+        bool connected = client.connect();
+        int peer = ::accept(listener.fd, nullptr, nullptr);
+        assertTrue(connected && peer >= 0, "order client connects");
+        if (!connected || peer < 0) return;
+
+        client.setCoalescing(true, 1'000'000'000ULL);
+        uint64_t syscallsBefore = g_systemMetrics.batch.flushSyscalls.load();
+        uint64_t ordersBefore = g_systemMetrics.batch.ordersFlushed.load();
+
+        OrderMessage orders[3] = { makeOrder(1, 10, 100), makeOrder(2, 20, 200), makeOrder(3, 30, 300) };
+        bool queued = true;
+        for (const auto& o : orders) queued &= client.sendOrder(o);
+        assertTrue(queued && client.pendingSends() == 3, "coalesced orders staged until flush");
+
+        client.flush();
+        assertTrue(!client.hasPendingSends(), "flush drains staged orders");
+        assertTrue(g_systemMetrics.batch.flushSyscalls.load() - syscallsBefore == 1, "three orders flushed in one syscall");
+        assertTrue(g_systemMetrics.batch.ordersFlushed.load() - ordersBefore == 3, "orders-per-syscall recorded");
+
+        uint8_t received[3 * WireFormat::ORDER_SIZE];
+        size_t got = readExactly(peer, received, sizeof(received));
+        bool match = got == sizeof(received);
+        for (int i = 0; i < 3 && match; ++i) {
+            uint8_t expected[WireFormat::ORDER_SIZE];
+            MessageSerializer::serializeOrder(expected, sizeof(expected), orders[i]);
+            match = std::memcmp(expected, received + i * WireFormat::ORDER_SIZE, WireFormat::ORDER_SIZE) == 0;
+        }
+        assertTrue(match, "gathered write preserves order bytes and sequence");
+        ::close(peer);
+    }
+
+    static void testBudgetForcesFlush() {
+        Listener listener;
+        if (listener.port == 0) { assertTrue(false, "listener setup"); return; }
+        OrderClient client("127.0.0.1", listener.port);
+        bool connected = client.connect();
+        int peer = ::accept(listener.fd, nullptr, nullptr);
+        if (!connected || peer < 0) { assertTrue(false, "order client connects"); return; }
+
+        client.setCoalescing(true, 0);
+        uint64_t budgetBefore = g_systemMetrics.batch.budgetFlushes.load();
+        client.sendOrder(makeOrder(5, 50, 500));
+        assertTrue(!client.hasPendingSends(), "exceeded budget flushes immediately");
+        assertTrue(g_systemMetrics.batch.budgetFlushes.load() > budgetBefore, "budget flush counted");
+        ::close(peer);
+    }
+
+    // A strategy thread queues while this thread runs the event loop's part:
+    // wait on the wakeup pipe and socket, then send.
+    static void testQueueFromStrategyThread() {
+        Listener listener;
+        if (listener.port == 0) { assertTrue(false, "listener setup"); return; }
+        OrderClient client("127.0.0.1", listener.port);
+        bool connected = client.connect();
+        int peer = ::accept(listener.fd, nullptr, nullptr);
+        if (!connected || peer < 0 || client.wakeFd() < 0) { assertTrue(false, "order client connects"); return; }
+
+        const uint32_t ORDERS = 5000;
+        std::vector<uint8_t> received(ORDERS * WireFormat::ORDER_SIZE);
+        size_t got = 0;
+        std::thread reader([&] { got = readExactly(peer, received.data(), received.size()); });
+        std::atomic<bool> queuedAll{false};
+        std::thread strategy([&] {
+            for (uint32_t i = 1; i <= ORDERS; ++i) {
+                while (!client.queueOrder(makeOrder(i, i, 100))) std::this_thread::yield();
+            }
+            queuedAll.store(true);
+        });
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        size_t wakeups = 0;
+        while (!(queuedAll.load() && !client.hasPendingSends()) && std::chrono::steady_clock::now() < deadline) {
+            fd_set readSet, writeSet;
+            FD_ZERO(&readSet);
+            FD_ZERO(&writeSet);
+            FD_SET(client.wakeFd(), &readSet);
+            if (client.hasPendingSends()) FD_SET(client.getSocketFd(), &writeSet);
+            struct timeval timeout{1, 0};
+            int maxFd = std::max(client.wakeFd(), client.getSocketFd());
+            if (::select(maxFd + 1, &readSet, &writeSet, nullptr, &timeout) <= 0) continue;
+            if (FD_ISSET(client.wakeFd(), &readSet)) ++wakeups;
+            client.processSendQueue();
+        }
+        strategy.join();
+        reader.join();
+
+        bool ordered = got == received.size();
+        for (uint32_t i = 0; i < ORDERS && ordered; ++i) {
+            uint8_t expected[WireFormat::ORDER_SIZE];
+            MessageSerializer::serializeOrder(expected, sizeof(expected), makeOrder(i + 1, i + 1, 100));
+            ordered = std::memcmp(expected, received.data() + i * WireFormat::ORDER_SIZE, WireFormat::ORDER_SIZE) == 0;
+        }
+        assertTrue(wakeups > 0, "queued orders wake the event loop");
+        assertTrue(ordered, "every queued order sent once, in order");
+        assertTrue(!client.hasPendingSends(), "inbox and backlog drained");
+        ::close(peer);
+    }
+
+    static void testSocketTuning() {
+        SocketTuning tuning = SocketTuning::standard();
+        assertTrue(SocketTuning::parse("latency,busypoll=0,cpu=0", tuning), "profile with overrides parses");
+        assertTrue(tuning.quickAck && tuning.busyPollMicros == 0 && tuning.incomingCpu == 0, "overrides applied");
+        assertTrue(tuning.name == "latency,busypoll=0,cpu=0", "profile named by its spec");
+        SocketTuning untouched = SocketTuning::throughput();
+        assertTrue(!SocketTuning::parse("fast", untouched), "unknown profile rejected");
+        assertTrue(!SocketTuning::parse("latency,rcvbuf=big", untouched), "bad override rejected");
+        assertTrue(untouched.name == "throughput", "rejected spec leaves profile untouched");
+
+        Listener l;
+        assertTrue(l.port != 0, "tuning listener bound");
+        OrderClient client("127.0.0.1", l.port);
+        client.setTuning(SocketTuning::latency());
+        assertTrue(client.connect(), "tuned client connects");
+        const SocketTuning::Applied& applied = client.getAppliedTuning();
+        // Linux reports twice the requested buffer to account for overhead.
+        assertTrue(applied.sendBuffer >= 65536, "send buffer read back");
+        assertTrue(applied.receiveLowWater == 1, "low water mark read back");
+        assertTrue(applied.typeOfService == IPTOS_LOWDELAY, "TOS read back");
+        assertTrue(applied.incomingCpu == SocketTuning::UNSET, "unset option not touched");
+
+        SocketTuning bulk = SocketTuning::throughput();
+        assertTrue(client.setTuning(bulk), "profile change applies to the open socket");
+        assertTrue(client.getAppliedTuning().receiveLowWater == bulk.receiveLowWater, "new low water mark read back");
+        assertTrue(client.getAppliedTuning().typeOfService == IPTOS_THROUGHPUT, "new TOS read back");
+    }
+
+    static void runAllTests() {
+        testsRun = testsPassed = 0;
+        testCoalescedFlush();
+        testBudgetForcesFlush();
+        testQueueFromStrategyThread();
+        testSocketTuning();
+        std::cout << "Order Client Tests: " << testsPassed << "/" << testsRun << " passed" << std::endl;
+    }
+};
+
+int OrderClientTest::testsRun = 0; int OrderClientTest::testsPassed = 0;
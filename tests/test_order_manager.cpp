@@ -3,6 +3,11 @@
 #include <cstring>
 #include "order_manager.h"
 #include "message.h"
+#include "message_serializer.h"
+#include "message_view.h"
+#include "warmup.h"
+#include "async_logger.h"
+#include "metrics.h"
 
 class OrderManagerTest {
 public:
@@ -204,6 +209,19 @@ public:
         return true;
     }
     
+    static bool testWarmup() {
+        Warmup::Report buy = Warmup::run("IBM", 'B', 100, 5);
+        Warmup::Report sell = Warmup::run("MSFT", 'S', 50, 3600);
+        bool ordered = buy.orders > 0 && sell.orders > 0 &&
+                       buy.coldFirstOrderNanos > 0 && buy.warmFirstOrderNanos > 0 &&
+                       sell.warmFirstOrderNanos > 0;
+        bool bounded = buy.rounds >= Warmup::MIN_ROUNDS && buy.rounds <= Warmup::MAX_ROUNDS &&
+                       sell.rounds <= Warmup::MAX_ROUNDS;
+        const MetricsSnapshot after = MetricsSnapshot::capture(g_systemMetrics);
+        bool reset = after.quotesProcessed == 0 && after.tradesProcessed == 0 && !g_asyncLogger.isActive();
+        return ordered && bounded && reset;
+    }
+
     static bool testUnfavorablePrice() {
         OrderManager manager("IBM", 'B', 100, 1);
         
@@ -303,6 +321,47 @@ public:
         return true;
     }
     
+    // A quote read through the wire view must decide exactly as the same
+    // quote materialized, on both sides.
+    static bool testQuoteViewMatchesMessage() {
+        uint64_t baseTime = 1000000000000ULL;
+        for (char side : {'B', 'S'}) {
+            OrderManager byMessage("IBM", side, 100, 1);
+            OrderManager byView("IBM", side, 100, 1);
+            for (int i = 0; i < 2; ++i) {
+                TradeMessage trade = createTrade("IBM", baseTime + i * 1000000000ULL, 100, 14000);
+                byMessage.processTrade(trade);
+                byView.processTrade(trade);
+            }
+
+            const QuoteMessage quotes[] = {
+                createQuote("IBM", baseTime + 1500000000ULL, 13950, 80, 13990, 150),
+                createQuote("IBM", baseTime + 1500000000ULL, 13950, 80, 13990, 150),
+                createQuote("IBM", baseTime + 1700000000ULL, 14050, 250, 14100, 90),
+                createQuote("IBM", baseTime + 1900000000ULL, 14010, 40, 13980, 60),
+            };
+            for (const QuoteMessage& quote : quotes) {
+                uint8_t body[WireFormat::QUOTE_SIZE];
+                MessageSerializer::serializeQuote(body, sizeof(body), quote);
+                Optional<OrderMessage> a = byMessage.processQuote(quote);
+                Optional<OrderMessage> b = byView.processQuote(QuoteView(body));
+                if (a.has_value() != b.has_value()) {
+                    std::cerr << "  View and message disagree on side " << side << std::endl;
+                    return false;
+                }
+                if (a.has_value() && std::memcmp(&a.value(), &b.value(), sizeof(OrderMessage)) != 0) {
+                    std::cerr << "  View built a different order on side " << side << std::endl;
+                    return false;
+                }
+            }
+            if (byView.getOrderCount() == 0 || byView.getOrderCount() != byMessage.getOrderCount()) {
+                std::cerr << "  Expected matching, nonzero order counts on side " << side << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
     static void runAllTests() {
         std::cout << "\n=== OrderManager Test Suite ===" << std::endl;
         
@@ -319,6 +378,8 @@ public:
         printTestResult("Order History", testOrderHistory());
         printTestResult("Sliding VWAP Window", testSlidingVwapWindow());
         printTestResult("State Continuity", testStateContinuity());
+        printTestResult("Quote View Matches Message", testQuoteViewMatchesMessage());
+        printTestResult("Warmup", testWarmup());
         
         std::cout << "\nResults: " << testsPassed << "/" << testsRun 
                   << " tests passed" << std::endl;
@@ -0,0 +1,56 @@
+#include <iostream>
+#include <cstring>
+#include "message.h"
+#include "message_serializer.h"
+#include "order_template.h"
+#include "wire_format.h"
+
+struct OrderTemplateTest {
+    static int testsRun;
+    static int testsPassed;
+
+    static void assertTrue(bool cond, const char* name) {
+        ++testsRun;
+        if (cond) { ++testsPassed; }
+        else { std::cerr << "[FAIL] " << name << std::endl; }
+    }
+
+    static void testMatchesSerializer() {
+        OrderMessage order;
+        std::memcpy(order.symbol, "MSFT", 4);
+        order.side = 'S';
+        OrderTemplate tmpl("MSFT", 4, 'S');
+
+        bool same = true;
+        const uint32_t quantities[] = {1, 250, 0xFFFFFFFFu};
+        const int32_t prices[] = {1, 14050, 0x7FFFFFFF};
+        for (int i = 0; i < 3; ++i) {
+            order.timestamp = 1000000000ULL * (i + 1) + 7;
+            order.quantity = quantities[i];
+            order.price = prices[i];
+            uint8_t expected[WireFormat::ORDER_SIZE];
+            MessageSerializer::serializeOrder(expected, sizeof(expected), order);
+            const uint8_t* actual = tmpl.patch(order.timestamp, order.quantity, order.price);
+            same &= std::memcmp(expected, actual, WireFormat::ORDER_SIZE) == 0;
+        }
+        assertTrue(same, "template bytes match serializeOrder");
+    }
+
+    static void testIdentity() {
+        OrderTemplate tmpl("IBM", 3, 'B');
+        assertTrue(tmpl.valid(), "template with B side is valid");
+        assertTrue(tmpl.matches("IBM\0\0\0\0\0", 'B'), "template matches its symbol/side");
+        assertTrue(!tmpl.matches("IBM\0\0\0\0\0", 'S'), "template rejects other side");
+        assertTrue(!OrderTemplate("IBM", 3, 'X').valid(), "template with bad side is invalid");
+        assertTrue(!OrderTemplate().valid(), "default template is invalid");
+    }
+
+    static void runAllTests() {
+        testsRun = testsPassed = 0;
+        testMatchesSerializer();
+        testIdentity();
+        std::cout << "Order Template Tests: " << testsPassed << "/" << testsRun << " passed" << std::endl;
+    }
+};
+
+int OrderTemplateTest::testsRun = 0; int OrderTemplateTest::testsPassed = 0;
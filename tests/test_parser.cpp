@@ -5,6 +5,8 @@
 #include "message_parser.h"
 #include "wire_format.h"
 #include "endian_converter.h"
+#include "message_view.h"
+#include "message_schema.h"
 
 struct ParserTest {
     static int testsRun;
@@ -49,11 +51,54 @@ struct ParserTest {
         assertTrue(!MessageParser::validateHeader(h), "reject invalid type");
     }
 
+    static void testViewsMatchParser() {
+        uint8_t qbuf[1 + WireFormat::QUOTE_SIZE];
+        QuoteMessage q{}; std::memcpy(q.symbol, "MSFT\0\0\0\0", 8);
+        q.timestamp = 42; q.bidQuantity = 10; q.bidPrice = 30000; q.askQuantity = 20; q.askPrice = 30010;
+        MessageSerializer::serializeQuote(qbuf + 1, WireFormat::QUOTE_SIZE, q); // odd offset: unaligned loads
+        QuoteView qv(qbuf + 1); QuoteMessage parsed{};
+        MessageParser::parseQuote(qbuf + 1, WireFormat::QUOTE_SIZE, parsed);
+        QuoteMessage mat = qv.toMessage();
+        assertTrue(qv.timestamp() == 42 && qv.bidPrice() == 30000 && qv.askPrice() == 30010 &&
+                   std::memcmp(qv.symbol(), "MSFT", 4) == 0, "quote view reads unaligned fields");
+        assertTrue(std::memcmp(&mat, &parsed, sizeof(mat)) == 0, "quote view materializes parser result");
+        assertTrue(qv.valid() == MessageParser::validateQuote(parsed), "quote view validation agrees");
+        q.bidPrice = 30020; // crossed
+        MessageSerializer::serializeQuote(qbuf + 1, WireFormat::QUOTE_SIZE, q);
+        assertTrue(!qv.valid(), "quote view rejects crossed quote");
+
+        uint8_t tbuf[3 + WireFormat::TRADE_SIZE];
+        TradeMessage t{}; std::memcpy(t.symbol, "IBM\0\0\0\0\0", 8);
+        t.timestamp = 7; t.quantity = 0; t.price = 100;
+        MessageSerializer::serializeTrade(tbuf + 3, WireFormat::TRADE_SIZE, t);
+        TradeView tv(tbuf + 3);
+        assertTrue(!tv.valid() && tv.price() == 100, "trade view rejects zero quantity");
+    }
+
+    static void testSchemaCodec() {
+        assertTrue(OrderSchema::structFormat() == "<8sQcIi", "order schema matches order server format");
+        assertTrue(QuoteSchema::structFormat() == "<8sQIIIi", "quote schema format");
+
+        OrderMessage o; std::memcpy(o.symbol, "AAPL", 4); o.side = 'S';
+        o.timestamp = 0x0102030405060708ULL; o.quantity = 77; o.price = -5;
+        uint8_t wire[WireFormat::ORDER_SIZE];
+        MessageSerializer::serializeOrder(wire, sizeof(wire), o);
+        assertTrue(wire[WireFormat::ORDER_SIDE_OFFSET] == 'S' && wire[WireFormat::ORDER_TIMESTAMP_OFFSET] == 0x08,
+                   "order encoded little-endian at schema offsets");
+        OrderMessage back; MessageParser::parseOrder(wire, sizeof(wire), back);
+        assertTrue(back.timestamp == o.timestamp && back.quantity == 77 && back.price == -5 &&
+                   OrderSchema::get<OrderFields::Price>(wire) == -5, "order schema round trip");
+        OrderMessage bad = o; bad.side = 'X';
+        assertTrue(OrderSchema::valid(wire) && !OrderSchema::valid(bad), "order side constraint");
+    }
+
     static void runAllTests() {
         testsRun=testsPassed=0;
         testQuoteRoundTrip();
         testTradeRoundTrip();
         testInvalidHeaderType();
+        testViewsMatchParser();
+        testSchemaCodec();
         std::cout << "Parser Tests: " << testsPassed << "/" << testsRun << " passed" << std::endl;
     }
 };
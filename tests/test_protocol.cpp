@@ -218,6 +218,47 @@ public:
         return true;
     }
     
+    static bool testMessageBufferResync() {
+        uint8_t stream[128];
+        size_t n = 0;
+        const uint8_t garbage[] = { 0x07, 0xFF, 0x20, 0x09, 0x33 };
+        std::memcpy(stream, garbage, sizeof(garbage)); n += sizeof(garbage);
+        // Phantom quote header whose successor is not a header; the real trade
+        // frame starts inside its span.
+        stream[n++] = 0x20; stream[n++] = 0x01; stream[n++] = 0xAB;
+        TradeMessage t{}; std::memcpy(t.symbol, "IBM", 3); t.quantity = 5; t.price = 100;
+        n += MessageSerializer::serializeTradeMessage(stream + n, sizeof(stream) - n, t);
+        n += MessageSerializer::serializeTradeMessage(stream + n, sizeof(stream) - n, t);
+
+        MessageBuffer buffer;
+        buffer.append(stream, n);
+        MessageHeader header;
+        uint8_t body[64];
+        if (buffer.extractMessage(header, body) != MessageBuffer::ExtractResult::INVALID_HEADER) {
+            std::cerr << "  Garbage should not frame" << std::endl;
+            return false;
+        }
+        size_t dropped = buffer.resync();
+        if (dropped != sizeof(garbage) + 3) {
+            std::cerr << "  Resync dropped " << dropped << " bytes, expected " << sizeof(garbage) + 3 << std::endl;
+            return false;
+        }
+        if (buffer.extractMessage(header, body) != MessageBuffer::ExtractResult::SUCCESS ||
+            header.type != MessageHeader::TRADE_TYPE) {
+            std::cerr << "  Failed to extract trade after resync" << std::endl;
+            return false;
+        }
+
+        // Without any header candidate only the final byte is kept.
+        buffer.clear();
+        buffer.append(garbage, sizeof(garbage));
+        if (buffer.resync() != sizeof(garbage) - 1 || buffer.availableBytes() != 1) {
+            std::cerr << "  Pure garbage should be discarded in one pass" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
     static bool testEndianConversion() {
         uint16_t host16 = 0x1234;
         uint16_t le16 = EndianConverter::htol16(host16);
@@ -299,6 +340,7 @@ public:
         printTestResult("Order Building", testOrderBuilding());
         printTestResult("Header Parsing", testHeaderParsing());
         printTestResult("Message Buffer", testMessageBuffer());
+        printTestResult("Message Buffer Resync", testMessageBufferResync());
         printTestResult("Endian Conversion", testEndianConversion());
         printTestResult("Invalid Messages", testInvalidMessages());
         
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <thread>
+#include <cstdint>
+#include "spsc_ring.h"
+
+struct SpscRingTest {
+    static int testsRun;
+    static int testsPassed;
+
+    static void assertTrue(bool cond, const char* name) {
+        ++testsRun;
+        if (cond) { ++testsPassed; }
+        else { std::cerr << "[FAIL] " << name << std::endl; }
+    }
+
+    static void testFillAndDrain() {
+        SpscRing<uint32_t, 8> ring;
+        bool allPushed = true;
+        for (uint32_t i = 0; i < 8; ++i) allPushed &= ring.tryPush(i);
+        assertTrue(allPushed, "ring accepts capacity elements");
+        assertTrue(!ring.tryPush(99), "ring rejects push when full");
+        assertTrue(ring.size() == 8, "ring size at capacity");
+
+        uint32_t v = 0; bool ordered = true;
+        for (uint32_t i = 0; i < 8; ++i) ordered &= ring.tryPop(v) && v == i;
+        assertTrue(ordered, "ring pops in FIFO order");
+        assertTrue(!ring.tryPop(v) && ring.empty(), "ring empty after drain");
+    }
+
+    static void testBatchedPublication() {
+        SpscRing<uint32_t, 4> ring;
+        ring.stage(1); ring.stage(2);
+        assertTrue(ring.peek() == nullptr, "staged elements invisible before publish");
+        ring.publish();
+        assertTrue(ring.peek() && *ring.peek() == 1, "published elements visible");
+
+        ring.pop(); ring.pop();
+        assertTrue(ring.size() == 2, "popped slots held until release");
+        ring.release();
+        assertTrue(ring.empty(), "release hands slots back");
+    }
+
+    static void testWrapAround() {
+        SpscRing<uint32_t, 4> ring;
+        bool ok = true; uint32_t v = 0;
+        for (uint32_t i = 0; i < 1000; ++i) {
+            ok &= ring.tryPush(i) && ring.tryPush(i + 1);
+            ok &= ring.tryPop(v) && v == i;
+            ok &= ring.tryPop(v) && v == i + 1;
+        }
+        assertTrue(ok, "ring indices wrap correctly");
+    }
+
+    static void testCrossThread() {
+        static SpscRing<uint64_t, 1024> ring;
+        const uint64_t N = 200000;
+        std::thread producer([&] {
+            for (uint64_t i = 1; i <= N; ++i) {
+                while (!ring.tryPush(i)) std::this_thread::yield();
+            }
+        });
+        uint64_t expected = 1; bool ordered = true;
+        while (expected <= N) {
+            uint64_t* p = ring.peek();
+            if (!p) { std::this_thread::yield(); continue; }
+            ordered &= (*p == expected);
+            ++expected;
+            ring.pop();
+            if ((expected & 31) == 0) ring.release();
+        }
+        ring.release();
+        producer.join();
+        assertTrue(ordered && ring.empty(), "cross-thread transfer preserves order");
+    }
+
+    static void testPrefaultKeepsContents() {
+        static SpscRing<uint64_t, 4096> ring;
+        for (uint64_t i = 0; i < 100; ++i) ring.tryPush(i * 7);
+        ring.prefault();
+        bool ok = true; uint64_t v = 0;
+        for (uint64_t i = 0; i < 100; ++i) ok = ok && ring.tryPop(v) && v == i * 7;
+        assertTrue(ok && ring.empty(), "prefault leaves queued elements intact");
+
+        uint8_t odd[5000];
+        for (size_t i = 0; i < sizeof(odd); ++i) odd[i] = static_cast<uint8_t>(i);
+        Realtime::prefault(odd + 1, sizeof(odd) - 1);
+        bool same = true;
+        for (size_t i = 0; i < sizeof(odd); ++i) same = same && odd[i] == static_cast<uint8_t>(i);
+        assertTrue(same, "prefault of an unaligned span is a no-op on contents");
+        assertTrue(!Realtime::pinThread(pthread_self(), -1), "negative CPU is not pinned");
+    }
+
+    static void runAllTests() {
+        testsRun = testsPassed = 0;
+        testFillAndDrain();
+        testBatchedPublication();
+        testWrapAround();
+        testCrossThread();
+        testPrefaultKeepsContents();
+        std::cout << "SPSC Ring Tests: " << testsPassed << "/" << testsRun << " passed" << std::endl;
+    }
+};
+
+int SpscRingTest::testsRun = 0; int SpscRingTest::testsPassed = 0;
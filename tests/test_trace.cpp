@@ -0,0 +1,168 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "trace.h"
+#include "trace_decoder.h"
+#include "message.h"
+
+struct TraceTest {
+    static int testsRun;
+    static int testsPassed;
+
+    static void assertTrue(bool cond, const char* name) {
+        ++testsRun;
+        if (cond) { ++testsPassed; }
+        else { std::cerr << "[FAIL] " << name << std::endl; }
+    }
+
+    static std::string tracePath(const char* tag) {
+        return "/tmp/vwap_trace_" + std::string(tag) + "_" + std::to_string(::getpid()) + ".bin";
+    }
+
+    static void testRingOverwrite() {
+        std::unique_ptr<TraceRing> ring(new TraceRing());
+        assertTrue(reinterpret_cast<uintptr_t>(ring.get()) % alignof(TraceRing) == 0, "ring allocated at its alignment");
+        std::vector<TraceRecord> out;
+        for (uint32_t i = 0; i < 10; ++i) ring->record(TraceStage::PARSE, 1000 + i, i, i);
+        assertTrue(ring->drain(out, 3) == 0 && out.size() == 10 && out[9].messageTs == 1009 &&
+                   out[9].stage == static_cast<uint8_t>(TraceStage::PARSE) && out[9].thread == 3,
+                   "records drained in order");
+
+        out.clear();
+        const uint32_t total = TraceRing::CAPACITY + 5;
+        for (uint32_t i = 0; i < total; ++i) ring->record(TraceStage::FRAME, 0, i, i);
+        const uint64_t dropped = ring->drain(out, 0);
+        assertTrue(dropped == 5 && out.size() == TraceRing::CAPACITY && out.front().arg == 5 &&
+                   out.back().arg == total - 1, "full ring keeps the newest records");
+        out.clear();
+        assertTrue(ring->drain(out, 0) == 0 && out.empty(), "nothing left after a drain");
+    }
+
+    static void testConcurrentDrain() {
+        std::unique_ptr<TraceRing> ring(new TraceRing());
+        const uint64_t total = 400000;
+        std::atomic<bool> done{false};
+        std::thread writer([&] {
+            for (uint64_t i = 1; i <= total; ++i) {
+                ring->record(TraceStage::RECV, i, static_cast<uint32_t>(i), i);
+                if (i % 1024 == 0) std::this_thread::yield();
+            }
+            done.store(true);
+        });
+
+        std::vector<TraceRecord> out;
+        uint64_t drained = 0, dropped = 0, torn = 0, last = 0;
+        bool ordered = true;
+        auto check = [&] {
+            out.clear();
+            dropped += ring->drain(out, 0);
+            for (const TraceRecord& r : out) {
+                if (r.ticks != r.messageTs || r.arg != static_cast<uint32_t>(r.ticks)) ++torn;
+                if (r.ticks <= last) ordered = false;
+                last = r.ticks;
+            }
+            drained += out.size();
+        };
+        while (!done.load()) {
+            check();
+            std::this_thread::yield();
+        }
+        writer.join();
+        check();
+        assertTrue(torn == 0 && ordered, "concurrent drain never returns torn records");
+        assertTrue(drained + dropped == total, "every record drained or counted lost");
+    }
+
+    static void testFileRoundTrip() {
+        const std::string path = tracePath("stream");
+        Tracer tracer;
+        if (!tracer.start(path.c_str(), Tracer::Mode::STREAM)) { assertTrue(false, "tracer starts"); return; }
+        tracer.record(TraceStage::RECV, 0, 64);
+        tracer.record(TraceStage::FRAME, 0, MessageHeader::QUOTE_TYPE);
+        tracer.record(TraceStage::PARSE, 100, MessageHeader::QUOTE_TYPE);
+        tracer.record(TraceStage::DECISION, 100, 1);
+        tracer.record(TraceStage::ORDER_SEND, 100, 1);
+        tracer.record(TraceStage::FRAME, 0, MessageHeader::TRADE_TYPE);
+        tracer.record(TraceStage::PARSE, 200, MessageHeader::TRADE_TYPE);
+        tracer.record(TraceStage::VWAP_UPDATE, 200, 1);
+        tracer.record(TraceStage::DECISION, 999, 0);
+        tracer.stop();
+        assertTrue(tracer.writtenRecords() == 9, "tracer wrote every record");
+
+        TraceDecoder decoder;
+        std::string error;
+        if (!decoder.load(path, error)) { assertTrue(false, "trace file decodes"); return; }
+        const std::vector<TraceDecoder::Message>& messages = decoder.messages();
+        assertTrue(decoder.records() == 9 && decoder.threads() == 1 && decoder.unmatched() == 1 &&
+                   messages.size() == 2, "messages rebuilt from stages");
+        if (messages.size() != 2) return;
+
+        const TraceDecoder::Message& quote = messages[0];
+        const TraceDecoder::Message& trade = messages[1];
+        assertTrue(quote.messageTs == 100 && quote.ordered && quote.has(TraceStage::RECV) &&
+                   quote.has(TraceStage::ORDER_SEND) && !quote.has(TraceStage::VWAP_UPDATE) &&
+                   quote.at(TraceStage::RECV) <= quote.at(TraceStage::PARSE) &&
+                   quote.at(TraceStage::PARSE) <= quote.at(TraceStage::ORDER_SEND), "quote stages in order");
+        assertTrue(trade.messageTs == 200 && !trade.ordered &&
+                   trade.at(TraceStage::RECV) == quote.at(TraceStage::RECV) &&
+                   trade.at(TraceStage::FRAME) >= quote.at(TraceStage::FRAME) &&
+                   trade.has(TraceStage::VWAP_UPDATE) && !trade.has(TraceStage::DECISION),
+                   "frames of one read share its recv");
+
+        const std::vector<TraceDecoder::Summary> rows = decoder.summarize();
+        assertTrue(rows.size() == TraceDecoder::SPANS + 1 && rows[0].count == 2 && rows[3].count == 1 &&
+                   rows.back().name == "total" && rows.back().max >= rows.back().p50, "stage summary");
+
+        std::ostringstream chrome;
+        decoder.writeChrome(chrome);
+        const std::string json = chrome.str();
+        assertTrue(json.find("\"traceEvents\":[") != std::string::npos && json.find("\"ph\":\"M\"") != std::string::npos,
+                   "chrome trace has events");
+        assertTrue(json.find("\"name\":\"parse -> decision\",\"cat\":\"quote\",\"ph\":\"b\"") != std::string::npos &&
+                   json.find("\"name\":\"order\"") != std::string::npos && json.find("\"timestamp\":200") != std::string::npos,
+                   "chrome events carry stages and message timestamps");
+        std::remove(path.c_str());
+    }
+
+    static void testSignalDump() {
+        const std::string path = tracePath("signal");
+        Tracer tracer;
+        if (!tracer.start(path.c_str(), Tracer::Mode::SIGNAL)) { assertTrue(false, "tracer starts"); return; }
+        for (uint64_t i = 0; i < 3 * TraceRing::CAPACITY; ++i) tracer.record(TraceStage::PARSE, i, 1);
+        tracer.requestDump();
+        for (int i = 0; i < 500 && tracer.writtenRecords() == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        assertTrue(tracer.writtenRecords() == TraceRing::CAPACITY, "dump writes the most recent records");
+        tracer.record(TraceStage::PARSE, 1, 1);
+        tracer.stop();
+        const uint64_t written = tracer.writtenRecords();
+        assertTrue(written == TraceRing::CAPACITY + 1 && tracer.lostRecords() == 0,
+                   "stop writes the rest, overwrites not lost");
+
+        TraceDecoder decoder;
+        std::string error;
+        assertTrue(decoder.load(path, error) && decoder.header().records == written &&
+                   decoder.messages().front().messageTs == 2 * TraceRing::CAPACITY, "dump decodes from its oldest record");
+        std::remove(path.c_str());
+        assertTrue(!decoder.load(path, error) && !error.empty(), "missing trace refused");
+    }
+
+    static void runAllTests() {
+        testRingOverwrite();
+        testConcurrentDrain();
+        testFileRoundTrip();
+        testSignalDump();
+        std::cout << "Trace Tests: " << testsPassed << "/" << testsRun << " passed" << std::endl;
+    }
+};
+
+int TraceTest::testsRun = 0;
+int TraceTest::testsPassed = 0;
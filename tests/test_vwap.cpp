@@ -1,7 +1,12 @@
 #include <iostream>
 #include <cmath>
 #include <vector>
+#include <algorithm>
 #include <chrono>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <type_traits>
 #include "vwap_calculator.h"
 #include "message.h"
 
@@ -196,6 +201,31 @@ public:
         return passed;
     }
     
+    static bool testBatchedTradesMatchSingle() {
+        VwapCalculator single(10);
+        VwapCalculator batched(10);
+        const size_t N = 500;
+        std::vector<uint64_t> ts(N);
+        std::vector<uint32_t> qty(N);
+        std::vector<int32_t> px(N);
+        for (size_t i = 0; i < N; i++) {
+            ts[i] = 1000000000ull + i * 50000000ull;
+            qty[i] = static_cast<uint32_t>(i % 7 == 0 ? 0 : 50 + i % 13);
+            px[i] = 14000 + static_cast<int32_t>(i % 40);
+            single.addTrade(createTrade("IBM", ts[i], qty[i], px[i]));
+        }
+        size_t accepted = 0;
+        for (size_t first = 0; first < N; first += 64) {
+            size_t n = std::min<size_t>(64, N - first);
+            accepted += batched.addTrades(&ts[first], &qty[first], &px[first], n);
+        }
+        return accepted == single.getTotalTradesProcessed() &&
+               batched.getRejectedTrades() == single.getRejectedTrades() &&
+               batched.getTradeCount() == single.getTradeCount() &&
+               batched.hasCompleteWindow() == single.hasCompleteWindow() &&
+               batched.getCurrentVwap() == single.getCurrentVwap();
+    }
+
     static bool testPerformance() {
         VwapCalculator calc(30);
         
@@ -222,6 +252,76 @@ public:
         return passed;
     }
     
+    // Readers on other threads must never see a half-published snapshot.
+    static bool testSnapshotStress() {
+        struct Stripe { uint64_t v[8]; };
+        Seqlock<Stripe> stripes;
+        std::unique_ptr<VwapCalculator> calc = std::make_unique<VwapCalculator>(3600);
+        const uint64_t STORES = 200000;
+        const uint32_t TRADES = 5000;
+        std::atomic<bool> done{false};
+        std::atomic<uint64_t> reads{0}, retries{0}, torn{0};
+
+        auto reader = [&] {
+            uint64_t lastStripe = 0, lastTime = 0;
+            uint32_t lastCount = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                Stripe s;
+                if (stripes.tryLoad(s)) {
+                    bool same = true;
+                    for (uint64_t x : s.v) same = same && x == s.v[0];
+                    if (!same || s.v[0] < lastStripe) torn.fetch_add(1);
+                    lastStripe = s.v[0];
+                } else {
+                    retries.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                VwapSnapshot snap = calc->readSnapshot();
+                bool consistent = snap.sumVolume == 100ull * snap.tradeCount &&
+                                  snap.tradeCount >= lastCount && snap.lastTradeTime >= lastTime &&
+                                  (snap.sumVolume == 0
+                                       ? snap.vwap == 0.0
+                                       : snap.vwap == static_cast<double>(snap.sumPriceVolume) / static_cast<double>(snap.sumVolume));
+                if (!consistent) torn.fetch_add(1);
+                lastCount = snap.tradeCount;
+                lastTime = snap.lastTradeTime;
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        };
+        std::thread r1(reader), r2(reader);
+
+        const uint64_t base = 1000000000000ULL;
+        for (uint64_t i = 0; i < STORES; ++i) {
+            Stripe s;
+            for (uint64_t& x : s.v) x = i + 1;
+            stripes.store(s);
+            if (i < TRADES) {
+                calc->addTrade(createTrade("IBM", base + i * 1000000ULL, 100, 10000 + static_cast<int32_t>(i % 50)));
+            }
+        }
+        done.store(true, std::memory_order_release);
+        r1.join();
+        r2.join();
+
+        VwapSnapshot last = calc->readSnapshot();
+        std::cout << "  snapshot reads: " << reads.load() << ", retries: " << retries.load() << std::endl;
+        return torn.load() == 0 && reads.load() > 0 && last.tradeCount == TRADES &&
+               calc->snapshotVersion() == TRADES && stripes.version() == STORES &&
+               last.vwap == calc->getCurrentVwap();
+    }
+
+    static bool testMoveKeepsSnapshot() {
+        static_assert(std::is_nothrow_move_constructible<VwapCalculator>::value, "VwapCalculator must stay movable");
+        std::unique_ptr<VwapCalculator> calc = std::make_unique<VwapCalculator>(3600);
+        const uint64_t base = 1000000000000ULL;
+        calc->addTrade(createTrade("IBM", base, 100, 14000));
+        calc->addTrade(createTrade("IBM", base + 1000000ULL, 300, 14100));
+        std::unique_ptr<VwapCalculator> moved = std::make_unique<VwapCalculator>(std::move(*calc));
+        VwapSnapshot snap = moved->readSnapshot();
+        return snap.tradeCount == 2 && moved->snapshotVersion() == 2 &&
+               snap.vwap == moved->getCurrentVwap() && std::abs(snap.vwap - 14075.0) < 0.001;
+    }
+
     static void runAllTests() {
         std::cout << "\n=== VWAP Calculator Test Suite ===" << std::endl;
         
@@ -237,7 +337,10 @@ public:
         printTestResult("Overflow Protection", testOverflowProtection());
         printTestResult("Precision Handling", testPrecision());
         printTestResult("Continuous Window", testContinuousWindow());
+        printTestResult("Batched Trades Match Single", testBatchedTradesMatchSingle());
         printTestResult("Performance", testPerformance());
+        printTestResult("Snapshot Stress", testSnapshotStress());
+        printTestResult("Move Keeps Snapshot", testMoveKeepsSnapshot());
         
         std::cout << "\nResults: " << testsPassed << "/" << testsRun 
                   << " tests passed" << std::endl;